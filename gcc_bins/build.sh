@@ -1,8 +1,20 @@
 rm *.o
 
+g++ -g -c ../source/bitMatrix.cpp -o bitMatrix.o
 g++ -g -c ../source/graph.cpp -o graph.o
+g++ -g -c ../source/triangularBitMatrix.cpp -o triangularBitMatrix.o
+g++ -g -c ../source/nameInterner.cpp -o nameInterner.o
+g++ -g -pthread -c ../source/hostPlatform.cpp -o hostPlatform.o
+g++ -g -pthread -c ../source/parallelUtils.cpp -o parallelUtils.o
+g++ -g -c ../source/mappedFile.cpp -o mappedFile.o
+g++ -g -c ../source/textChunks.cpp -o textChunks.o
+g++ -g -pthread -D_GRAFCOLOR_HAVE_ZLIB_ -c ../source/decompressStream.cpp -o decompressStream.o
+g++ -g -c ../source/compactGraph.cpp -o compactGraph.o
+g++ -g -c ../source/complementView.cpp -o complementView.o
+g++ -g -c ../source/binaryGraph.cpp -o binaryGraph.o
 g++ -g -c ../source/graphloader.cpp -o graphloader.o
+g++ -g -c ../source/numericGraphLoader.cpp -o numericGraphLoader.o
 g++ -g -c ../source/graphloader_driver.cpp -o graphloader_driver.o
 
-g++ -g -o lg *.o
+g++ -g -pthread -o lg *.o -lz
 
@@ -1,3 +1,14 @@
+// Id and offset types of the non adjacency stream, set by the host with
+// -D VERTEX_ID_T=... -D OFFSET_T=... to match the width it marshalled
+#ifndef VERTEX_ID_T
+#define VERTEX_ID_T uint
+#endif
+#ifndef OFFSET_T
+#define OFFSET_T uint
+#endif
+typedef VERTEX_ID_T vertex_id_t;
+typedef OFFSET_T offset_t;
+
 typedef unsigned char byte_t;
 const size_t BYTE_SIZE = 8;
 
@@ -44,8 +55,8 @@ bool isConflicting( __global byte_t* adjacents,
 }
 
 __kernel void kernelColor( __global byte_t* adjacents,
-                           constant unsigned int* non_adjacents,
-                           constant unsigned int* non_adj_offset_array,
+                           constant vertex_id_t* non_adjacents,
+                           constant offset_t* non_adj_offset_array,
                            int non_adjacents_num_elems,
                            int pNumVertices, 
                            __global byte_t* group )
@@ -53,9 +64,9 @@ __kernel void kernelColor( __global byte_t* adjacents,
     unsigned int curr_vertex = get_global_id( 0 );
 
     unsigned int offset = curr_vertex * pNumVertices;
-    unsigned int offset_non = non_adj_offset_array[curr_vertex];
+    offset_t offset_non = non_adj_offset_array[curr_vertex];
 
-    unsigned int num_items = 0;
+    offset_t num_items = 0;
     
     if( curr_vertex < ( pNumVertices - 1 ) )
     {
@@ -72,7 +83,7 @@ __kernel void kernelColor( __global byte_t* adjacents,
     setBit( group, ( offset + curr_vertex ), 1 );
 
     // the non_adjacents[ 0 ] element is the number of elements in the non_adjacents location of v;
-    for( int i = 0; i < num_items; ++i )
+    for( offset_t i = 0; i < num_items; ++i )
     {
         unsigned int non_neighbor = non_adjacents[ offset_non + i ];
 
@@ -0,0 +1,107 @@
+typedef unsigned char byte_t;
+typedef ulong offset_t;
+
+// Id type of the CSR arrays, set by the host with -D VERTEX_ID_T=...
+#ifndef VERTEX_ID_T
+#define VERTEX_ID_T uint
+#endif
+typedef VERTEX_ID_T vertex_id_t;
+
+const size_t BYTE_SIZE = 8;
+
+// Same VIS kernel as individualSet.cl, but the non adjacency lists and the
+// dense adjacency bit matrix are replaced by the CSR graph:
+//   offsets/neighbors  - CSR rows, ascending ids
+//   order              - all vertices in ascending degree order
+//   ranks              - CSR rows as ascending positions in order
+// The non neighbors of a vertex are walked by merging order with its rank
+// row, and a candidate conflicts if any of its neighbors is in the group.
+
+bool getBit( __global byte_t* pBitMatrix, unsigned int pBitOffset )
+{
+    unsigned int lByteNum = pBitOffset / BYTE_SIZE;
+    unsigned int lBitPos = pBitOffset % BYTE_SIZE;
+    return ( 0 != ( pBitMatrix[lByteNum] & ( 0x1 << ( BYTE_SIZE - ( lBitPos + 1 ) ) ) ) );
+}
+
+void setBit( __global byte_t* pBitMatrix, unsigned int pBitOffset, bool pVal )
+{
+    size_t lByteNum = pBitOffset / BYTE_SIZE;
+    int lBitPos = pBitOffset % BYTE_SIZE;
+
+    if( pVal )
+    {
+        pBitMatrix[lByteNum] = pBitMatrix[lByteNum] | ( 0x1 << ( BYTE_SIZE - ( lBitPos + 1 ) ) );
+    }
+    else
+    {
+        pBitMatrix[lByteNum] = pBitMatrix[lByteNum] & ~( 0x1 << ( BYTE_SIZE - ( lBitPos + 1 ) ) );
+    }
+}
+
+bool isConflicting( __global const offset_t* offsets,
+                    __global const vertex_id_t* neighbors,
+                    unsigned int pNumVertices,
+                    __global byte_t* group,
+                    unsigned int curr_vertex,
+                    unsigned int non_neighbor )
+{
+    unsigned int offset = curr_vertex * pNumVertices;
+    for( offset_t i = offsets[non_neighbor]; i < offsets[non_neighbor + 1]; ++i )
+    {
+        if( getBit( group, ( offset + neighbors[i] ) ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+__kernel void kernelColor( __global const offset_t* offsets,
+                           __global const vertex_id_t* neighbors,
+                           __global const vertex_id_t* order,
+                           __global const vertex_id_t* ranks,
+                           unsigned int pNumVertices,
+                           __global byte_t* group )
+{
+    unsigned int curr_vertex = get_global_id( 0 );
+
+    unsigned int offset = curr_vertex * pNumVertices;
+
+    offset_t rank = offsets[curr_vertex];
+    offset_t rank_end = offsets[curr_vertex + 1];
+
+    // self should always be a part of the IVS
+    setBit( group, ( offset + curr_vertex ), 1 );
+
+    for( unsigned int pos = 0; pos < pNumVertices; ++pos )
+    {
+        // skip the neighbors, their ranks come in ascending order
+        if( rank < rank_end && ranks[rank] == pos )
+        {
+            ++rank;
+            continue;
+        }
+
+        unsigned int non_neighbor = order[pos];
+
+        if( curr_vertex != non_neighbor )
+        {
+            if( isConflicting( offsets,
+                               neighbors,
+                               pNumVertices,
+                               group,
+                               curr_vertex,
+                               non_neighbor ) )
+            {
+                continue;
+            }
+            else
+            {
+                setBit( group, ( offset + non_neighbor ), 1 );
+            }
+        }
+    }
+}
+
+// end of file
@@ -0,0 +1,439 @@
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "compactGraph.h"
+#include "complementView.h"
+#include "binaryGraph.h"
+
+static const char BINARY_GRAPH_MAGIC[8] = { 'G', 'R', 'A', 'F', 'C', 'S', 'R', '\0' };
+static const uint32_t BINARY_GRAPH_BYTE_ORDER = 0x01020304;
+
+const uint32_t BinaryGraphFile::VERSION = 1;
+
+static uint64_t alignSection( uint64_t pPos )
+{
+    return ( pPos + 7 ) & ~( uint64_t )7;
+}
+
+// Appends pNumBytes at the aligned position pPos, zero padding the gap
+static bool writeSection( FILE* pFile, uint64_t& rPos, uint64_t pPos, const void* pData, size_t pNumBytes )
+{
+    static const char sPadding[8] = { 0 };
+
+    size_t lPadding = ( size_t )( pPos - rPos );
+    if( lPadding && fwrite( sPadding, 1, lPadding, pFile ) != lPadding )
+    {
+        return false;
+    }
+    if( pNumBytes && fwrite( pData, 1, pNumBytes, pFile ) != pNumBytes )
+    {
+        return false;
+    }
+
+    rPos = pPos + pNumBytes;
+    return true;
+}
+
+// Fills the header fields every file has, and the positions of the CSR
+// sections, which depend on the vertex count only
+static void initHeader( BinaryGraphHeader& rHeader, uint64_t pIdBytes, uint32_t pFlags,
+                        uint64_t pNumVertices, uint64_t pNumAdjacencies, uint64_t pMaxDegree )
+{
+    memset( &rHeader, 0, sizeof( rHeader ) );
+    memcpy( rHeader.mMagic, BINARY_GRAPH_MAGIC, sizeof( rHeader.mMagic ) );
+    rHeader.mVersion = BinaryGraphFile::VERSION;
+    rHeader.mByteOrder = BINARY_GRAPH_BYTE_ORDER;
+    rHeader.mIdBytes = ( uint32_t )pIdBytes;
+    rHeader.mFlags = pFlags;
+    rHeader.mNumVertices = pNumVertices;
+    rHeader.mNumAdjacencies = pNumAdjacencies;
+    rHeader.mMaxDegree = pMaxDegree;
+    rHeader.mOffsetsPos = alignSection( sizeof( rHeader ) );
+    rHeader.mNeighborsPos = alignSection( rHeader.mOffsetsPos + ( pNumVertices + 1 ) * sizeof( uint64_t ) );
+}
+
+template< typename VertexId >
+bool BinaryGraphFile::write( const char* pFilename, const Graph& rGraph, bool pWithNames, bool pWithOrder )
+{
+    BasicCompactGraph<VertexId> lCsr;
+    if( !lCsr.freeze( rGraph ) )
+    {
+        return false;
+    }
+
+    BasicComplementView<VertexId> lView;
+    if( pWithOrder && !lView.build( lCsr ) )
+    {
+        return false;
+    }
+
+    size_t lNumVertices = lCsr.size();
+    size_t lNumAdjacencies = lCsr.getNumAdjacencies();
+
+    std::vector<uint64_t> lNameOffsets;
+    std::string lNames;
+    if( pWithNames )
+    {
+        std::string lName;
+        lNameOffsets.reserve( lNumVertices + 1 );
+        lNameOffsets.push_back( 0 );
+        for( size_t lId = 0; lId < lNumVertices; ++lId )
+        {
+            rGraph.getName( ( Graph::vertexId_t )lId, lName );
+            lNames += lName;
+            lNameOffsets.push_back( lNames.size() );
+        }
+    }
+
+    BinaryGraphHeader lHeader;
+    initHeader( lHeader, sizeof( VertexId ), ( pWithNames ? HAS_NAMES : 0 ) | ( pWithOrder ? HAS_ORDER : 0 ),
+                lNumVertices, lNumAdjacencies, lCsr.getMaxDegree() );
+
+    // lay the sections out first, the header carries their positions
+    uint64_t lPos = alignSection( lHeader.mNeighborsPos + lNumAdjacencies * sizeof( VertexId ) );
+    if( pWithNames )
+    {
+        lHeader.mNameOffsetsPos = lPos;
+        lPos = alignSection( lPos + lNameOffsets.size() * sizeof( uint64_t ) );
+        lHeader.mNamesPos = lPos;
+        lPos = alignSection( lPos + lNames.size() );
+    }
+    if( pWithOrder )
+    {
+        lHeader.mOrderPos = lPos;
+        lPos = alignSection( lPos + lNumVertices * sizeof( VertexId ) );
+        lHeader.mRanksPos = lPos;
+        lPos = alignSection( lPos + lNumAdjacencies * sizeof( VertexId ) );
+    }
+    lHeader.mFileBytes = lPos;
+
+    FILE* lFile = fopen( pFilename, "wb" );
+    if( !lFile )
+    {
+        return false;
+    }
+
+    uint64_t lWritten = 0;
+    bool lRet = writeSection( lFile, lWritten, 0, &lHeader, sizeof( lHeader ) ) &&
+                writeSection( lFile, lWritten, lHeader.mOffsetsPos, lCsr.getOffsetArray(), ( lNumVertices + 1 ) * sizeof( uint64_t ) ) &&
+                writeSection( lFile, lWritten, lHeader.mNeighborsPos, lCsr.getNeighborArray(), lNumAdjacencies * sizeof( VertexId ) );
+    if( lRet && pWithNames )
+    {
+        lRet = writeSection( lFile, lWritten, lHeader.mNameOffsetsPos, &lNameOffsets[0], lNameOffsets.size() * sizeof( uint64_t ) ) &&
+               writeSection( lFile, lWritten, lHeader.mNamesPos, lNames.data(), lNames.size() );
+    }
+    if( lRet && pWithOrder )
+    {
+        lRet = writeSection( lFile, lWritten, lHeader.mOrderPos, lView.getOrderArray(), lNumVertices * sizeof( VertexId ) ) &&
+               writeSection( lFile, lWritten, lHeader.mRanksPos, lView.getRankArray(), lNumAdjacencies * sizeof( VertexId ) );
+    }
+    lRet = lRet && writeSection( lFile, lWritten, lHeader.mFileBytes, NULL, 0 );
+
+    lRet = ( 0 == fclose( lFile ) ) && lRet;
+    return lRet;
+}
+
+bool BinaryGraphFile::isBinaryGraph( const char* pFilename )
+{
+    char lMagic[sizeof( BINARY_GRAPH_MAGIC )] = { 0 };
+
+    FILE* lFile = fopen( pFilename, "rb" );
+    if( !lFile )
+    {
+        return false;
+    }
+    bool lRet = ( fread( lMagic, 1, sizeof( lMagic ), lFile ) == sizeof( lMagic ) ) &&
+                ( 0 == memcmp( lMagic, BINARY_GRAPH_MAGIC, sizeof( lMagic ) ) );
+    fclose( lFile );
+
+    return lRet;
+}
+
+BinaryGraphFile::BinaryGraphFile()
+    : mHeader( NULL )
+{
+}
+
+void BinaryGraphFile::close()
+{
+    mHeader = NULL;
+    mFile.close();
+}
+
+bool BinaryGraphFile::open( const char* pFilename )
+{
+    close();
+
+    if( !mFile.open( pFilename ) || mFile.getSize() < sizeof( BinaryGraphHeader ) )
+    {
+        mFile.close();
+        return false;
+    }
+
+    const BinaryGraphHeader* lHeader = ( const BinaryGraphHeader* )mFile.getData();
+    uint64_t lSize = mFile.getSize();
+    uint64_t lNumVertices = lHeader->mNumVertices;
+    uint64_t lNumAdjacencies = lHeader->mNumAdjacencies;
+    uint64_t lIdBytes = lHeader->mIdBytes;
+
+    bool lValid = ( 0 == memcmp( lHeader->mMagic, BINARY_GRAPH_MAGIC, sizeof( lHeader->mMagic ) ) ) &&
+                  ( VERSION == lHeader->mVersion ) &&
+                  ( BINARY_GRAPH_BYTE_ORDER == lHeader->mByteOrder ) &&
+                  ( 2 == lIdBytes || 4 == lIdBytes || 8 == lIdBytes ) &&
+                  ( lNumVertices > 0 ) &&
+                  ( lHeader->mFileBytes <= lSize );
+
+    // every section must lie in the file and be aligned for its elements
+    struct Section
+    {
+        uint64_t mPos;
+        uint64_t mBytes;
+        bool mPresent;
+    };
+    Section lSections[] =
+    {
+        { lHeader->mOffsetsPos, ( lNumVertices + 1 ) * sizeof( uint64_t ), true },
+        { lHeader->mNeighborsPos, lNumAdjacencies * lIdBytes, true },
+        { lHeader->mNameOffsetsPos, ( lNumVertices + 1 ) * sizeof( uint64_t ), 0 != ( lHeader->mFlags & HAS_NAMES ) },
+        { lHeader->mOrderPos, lNumVertices * lIdBytes, 0 != ( lHeader->mFlags & HAS_ORDER ) },
+        { lHeader->mRanksPos, lNumAdjacencies * lIdBytes, 0 != ( lHeader->mFlags & HAS_ORDER ) }
+    };
+    for( size_t lIdx = 0; lValid && lIdx < sizeof( lSections ) / sizeof( lSections[0] ); ++lIdx )
+    {
+        const Section& rSection = lSections[lIdx];
+        lValid = !rSection.mPresent ||
+                 ( 0 == ( rSection.mPos & 7 ) && rSection.mPos <= lSize && rSection.mBytes <= lSize - rSection.mPos );
+    }
+
+    if( lValid )
+    {
+        // the offsets must close on the neighbor count
+        const uint64_t* lOffsets = ( const uint64_t* )( mFile.getData() + lHeader->mOffsetsPos );
+        lValid = ( 0 == lOffsets[0] ) && ( lNumAdjacencies == lOffsets[lNumVertices] );
+    }
+    if( lValid && ( lHeader->mFlags & HAS_NAMES ) )
+    {
+        const uint64_t* lNameOffsets = ( const uint64_t* )( mFile.getData() + lHeader->mNameOffsetsPos );
+        uint64_t lNamesBytes = lNameOffsets[lNumVertices];
+        lValid = ( lHeader->mNamesPos <= lSize ) && ( lNamesBytes <= lSize - lHeader->mNamesPos );
+    }
+
+    if( !lValid )
+    {
+        mFile.close();
+        return false;
+    }
+
+    mHeader = lHeader;
+    return true;
+}
+
+template< typename VertexId >
+bool BinaryGraphFile::attach( BasicCompactGraph<VertexId>& rGraph ) const
+{
+    if( !mHeader || sizeof( VertexId ) != mHeader->mIdBytes )
+    {
+        return false;
+    }
+
+    return rGraph.attach( ( const uint64_t* )getSection( mHeader->mOffsetsPos ),
+                          ( const VertexId* )getSection( mHeader->mNeighborsPos ),
+                          ( size_t )mHeader->mNumVertices,
+                          ( size_t )mHeader->mMaxDegree );
+}
+
+template< typename VertexId >
+bool BinaryGraphFile::attach( const BasicCompactGraph<VertexId>& rGraph, BasicComplementView<VertexId>& rView ) const
+{
+    if( !hasOrder() || sizeof( VertexId ) != mHeader->mIdBytes || rGraph.size() != mHeader->mNumVertices )
+    {
+        return false;
+    }
+
+    return rView.attach( rGraph,
+                         ( const VertexId* )getSection( mHeader->mOrderPos ),
+                         ( const VertexId* )getSection( mHeader->mRanksPos ) );
+}
+
+bool BinaryGraphFile::loadVertices( Graph& rGraph ) const
+{
+    size_t lNumVertices = getNumVertices();
+    if( !mHeader || !rGraph.empty() || !fitsVertexId<Graph::vertexId_t>( lNumVertices ) )
+    {
+        return false;
+    }
+
+    if( !hasNames() )
+    {
+        return rGraph.addNumberedVertices( lNumVertices, 0 );
+    }
+
+    const uint64_t* lNameOffsets = ( const uint64_t* )getSection( mHeader->mNameOffsetsPos );
+    const char* lNames = getSection( mHeader->mNamesPos );
+
+    for( size_t lIdx = 0; lIdx < lNumVertices; ++lIdx )
+    {
+        Graph::vertexId_t lId = 0;
+        bool lIsNew = rGraph.addVertex( lNames + lNameOffsets[lIdx], ( size_t )( lNameOffsets[lIdx + 1] - lNameOffsets[lIdx] ), lId );
+
+        // duplicate names would shift every later id
+        if( !lIsNew || lId != lIdx )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template< typename FileId >
+bool BinaryGraphFile::loadEdges( Graph& rGraph ) const
+{
+    BasicCompactGraph<FileId> lCsr;
+    if( !attach( lCsr ) )
+    {
+        return false;
+    }
+
+    // every edge once, from its lower end
+    Graph::idPairStore_t lEdges;
+    lEdges.reserve( lCsr.getNumAdjacencies() / 2 );
+    for( size_t lIdx = 0; lIdx < lCsr.size(); ++lIdx )
+    {
+        typename BasicCompactGraph<FileId>::NeighborRange lNeighbors = lCsr.getNeighbors( ( FileId )lIdx );
+        for( size_t lPos = 0; lPos < lNeighbors.size(); ++lPos )
+        {
+            if( lNeighbors[lPos] > lIdx )
+            {
+                lEdges.push_back( Graph::idPair_t( ( Graph::vertexId_t )lIdx, ( Graph::vertexId_t )lNeighbors[lPos] ) );
+            }
+        }
+    }
+
+    return lEdges.empty() || rGraph.addEdges( &lEdges[0], lEdges.size() );
+}
+
+bool BinaryGraphFile::loadGraph( Graph& rGraph ) const
+{
+    if( !loadVertices( rGraph ) )
+    {
+        return false;
+    }
+
+    switch( getIdBytes() )
+    {
+    case 2:
+        return loadEdges<uint16_t>( rGraph );
+    case 4:
+        return loadEdges<uint32_t>( rGraph );
+    case 8:
+        return loadEdges<uint64_t>( rGraph );
+    default:
+        return false;
+    }
+}
+
+BinaryGraphWriter::BinaryGraphWriter()
+    : mFile( NULL )
+    , mNumVertices( 0 )
+    , mIdBytes( 0 )
+    , mNumAdjacencies( 0 )
+    , mNeighborsPos( 0 )
+    , mFailed( false )
+{
+}
+
+BinaryGraphWriter::~BinaryGraphWriter()
+{
+    if( mFile )
+    {
+        fclose( mFile );
+    }
+}
+
+bool BinaryGraphWriter::open( const char* pFilename, size_t pNumVertices, size_t pIdBytes )
+{
+    static const char sZeros[4096] = { 0 };
+
+    if( mFile )
+    {
+        fclose( mFile );
+    }
+    mFile = fopen( pFilename, "wb" );
+    if( !mFile )
+    {
+        return false;
+    }
+
+    BinaryGraphHeader lHeader;
+    initHeader( lHeader, pIdBytes, 0, pNumVertices, 0, 0 );
+    mNumVertices = pNumVertices;
+    mIdBytes = pIdBytes;
+    mNumAdjacencies = 0;
+    mNeighborsPos = lHeader.mNeighborsPos;
+    mFailed = false;
+
+    // zeros up to the neighbors, close() writes the header and the offsets
+    // over them
+    for( uint64_t lPos = 0; !mFailed && lPos < mNeighborsPos; )
+    {
+        size_t lBytes = ( size_t )std::min<uint64_t>( sizeof( sZeros ), mNeighborsPos - lPos );
+        mFailed = ( fwrite( sZeros, 1, lBytes, mFile ) != lBytes );
+        lPos += lBytes;
+    }
+    return !mFailed;
+}
+
+bool BinaryGraphWriter::appendNeighbors( const void* pIds, size_t pNumIds )
+{
+    if( !mFile || mFailed )
+    {
+        return false;
+    }
+
+    size_t lBytes = pNumIds * ( size_t )mIdBytes;
+    mFailed = ( lBytes && fwrite( pIds, 1, lBytes, mFile ) != lBytes );
+    mNumAdjacencies += pNumIds;
+    return !mFailed;
+}
+
+bool BinaryGraphWriter::close( const uint64_t* pOffsets, size_t pMaxDegree )
+{
+    if( !mFile )
+    {
+        return false;
+    }
+
+    BinaryGraphHeader lHeader;
+    initHeader( lHeader, mIdBytes, 0, mNumVertices, mNumAdjacencies, pMaxDegree );
+    lHeader.mFileBytes = alignSection( mNeighborsPos + mNumAdjacencies * mIdBytes );
+
+    uint64_t lWritten = mNeighborsPos + mNumAdjacencies * mIdBytes;
+    bool lRet = !mFailed && ( pOffsets[mNumVertices] == mNumAdjacencies ) &&
+                writeSection( mFile, lWritten, lHeader.mFileBytes, NULL, 0 ) &&
+                ( 0 == fseek( mFile, 0, SEEK_SET ) );
+
+    lWritten = 0;
+    lRet = lRet &&
+           writeSection( mFile, lWritten, 0, &lHeader, sizeof( lHeader ) ) &&
+           writeSection( mFile, lWritten, lHeader.mOffsetsPos, pOffsets, ( size_t )( mNumVertices + 1 ) * sizeof( uint64_t ) );
+
+    lRet = ( 0 == fclose( mFile ) ) && lRet;
+    mFile = NULL;
+    return lRet;
+}
+
+#define INSTANTIATE_BINARY_GRAPH( VertexId ) \
+    template bool BinaryGraphFile::write<VertexId>( const char*, const Graph&, bool, bool ); \
+    template bool BinaryGraphFile::attach<VertexId>( BasicCompactGraph<VertexId>& ) const; \
+    template bool BinaryGraphFile::attach<VertexId>( const BasicCompactGraph<VertexId>&, BasicComplementView<VertexId>& ) const;
+
+INSTANTIATE_BINARY_GRAPH( uint16_t )
+INSTANTIATE_BINARY_GRAPH( uint32_t )
+INSTANTIATE_BINARY_GRAPH( uint64_t )
+
+// end of file
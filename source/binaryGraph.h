@@ -0,0 +1,169 @@
+#ifndef _BINARY_GRAPH_H_
+#define _BINARY_GRAPH_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <stdint.h>
+
+#include "graphFwd.h"
+#include "mappedFile.h"
+
+// Versioned binary graph file. A fixed header is followed by 8 byte
+// aligned sections, each located by its file position in the header:
+//   offsets      - V + 1 uint64 CSR offsets
+//   neighbors    - CSR neighbor ids, mIdBytes wide, rows ascending
+//   name offsets - V + 1 uint64 offsets into the name bytes  (optional)
+//   names        - vertex names back to back, no terminators  (optional)
+//   order        - ComplementView degree order, V ids         (optional)
+//   ranks        - ComplementView rank rows, laid out like
+//                  the neighbors                              (optional)
+// Integers are stored in the byte order of the writer; mByteOrder lets a
+// reader refuse a foreign one.
+struct BinaryGraphHeader
+{
+    char mMagic[8];
+    uint32_t mVersion;
+    uint32_t mByteOrder;
+    uint32_t mIdBytes;
+    uint32_t mFlags;
+    uint64_t mNumVertices;
+    uint64_t mNumAdjacencies;
+    uint64_t mMaxDegree;
+    uint64_t mOffsetsPos;
+    uint64_t mNeighborsPos;
+    uint64_t mNameOffsetsPos;
+    uint64_t mNamesPos;
+    uint64_t mOrderPos;
+    uint64_t mRanksPos;
+    uint64_t mFileBytes;
+};
+
+// Reads a binary graph file through a memory mapping; the CSR and the
+// order sections are handed out in place, without a copy, so they stay
+// valid only while the file is open.
+class BinaryGraphFile
+{
+public:
+    static const uint32_t VERSION;
+
+    enum
+    {
+        HAS_NAMES = 0x1,
+        HAS_ORDER = 0x2
+    };
+
+    // Writes rGraph as a CSR with VertexId wide ids, the names and the
+    // complement order as asked. False if the ids do not fit or the file
+    // cannot be written.
+    template< typename VertexId >
+    static bool write( const char* pFilename, const Graph& rGraph, bool pWithNames, bool pWithOrder );
+
+    // True if the file starts like a binary graph file
+    static bool isBinaryGraph( const char* pFilename );
+
+    BinaryGraphFile();
+
+    // Maps the file and checks the header and the section bounds
+    bool open( const char* pFilename );
+
+    void close();
+
+    size_t getNumVertices() const
+    {
+        return mHeader ? ( size_t )mHeader->mNumVertices : 0;
+    }
+
+    size_t getNumAdjacencies() const
+    {
+        return mHeader ? ( size_t )mHeader->mNumAdjacencies : 0;
+    }
+
+    size_t getIdBytes() const
+    {
+        return mHeader ? mHeader->mIdBytes : 0;
+    }
+
+    bool hasNames() const
+    {
+        return mHeader && ( mHeader->mFlags & HAS_NAMES );
+    }
+
+    bool hasOrder() const
+    {
+        return mHeader && ( mHeader->mFlags & HAS_ORDER );
+    }
+
+    // Points rGraph at the CSR sections. False if the file ids are not
+    // VertexId wide.
+    template< typename VertexId >
+    bool attach( BasicCompactGraph<VertexId>& rGraph ) const;
+
+    // Points rView at the order sections, over a CSR attached above
+    template< typename VertexId >
+    bool attach( const BasicCompactGraph<VertexId>& rGraph, BasicComplementView<VertexId>& rView ) const;
+
+    // Adds the vertices, under their names or, without a name table, under
+    // their decimal ids, to the empty rGraph; vertex ids are kept
+    bool loadVertices( Graph& rGraph ) const;
+
+    // Same as above, plus every edge
+    bool loadGraph( Graph& rGraph ) const;
+
+private:
+    template< typename FileId >
+    bool loadEdges( Graph& rGraph ) const;
+
+    const char* getSection( uint64_t pPos ) const
+    {
+        return mFile.getData() + pPos;
+    }
+
+    MappedFile mFile;
+    const BinaryGraphHeader* mHeader;
+};
+
+// Writes a binary graph file a few rows at a time, for a CSR that is built
+// in pieces and need not fit in memory. The neighbors go to the file as
+// they come; the offsets and the header, which only the caller's degrees
+// settle, are written over their placeholders by close(). No names and no
+// order sections.
+class BinaryGraphWriter
+{
+public:
+    BinaryGraphWriter();
+
+    // Closes without completing the file, see close()
+    ~BinaryGraphWriter();
+
+    // Creates the file for pNumVertices vertices and pIdBytes wide ids and
+    // reserves the header and the offsets
+    bool open( const char* pFilename, size_t pNumVertices, size_t pIdBytes );
+
+    // Appends the neighbors of the next rows, pNumIds ids of the width
+    // given to open()
+    bool appendNeighbors( const void* pIds, size_t pNumIds );
+
+    // Writes the V + 1 offsets and the header and closes the file. False,
+    // leaving an incomplete file, if the last offset is not the number of
+    // ids appended or a write fails.
+    bool close( const uint64_t* pOffsets, size_t pMaxDegree );
+
+    size_t getNumAdjacencies() const
+    {
+        return ( size_t )mNumAdjacencies;
+    }
+
+private:
+    // not copyable, owns the file
+    BinaryGraphWriter( const BinaryGraphWriter& );
+    BinaryGraphWriter& operator= ( const BinaryGraphWriter& );
+
+    FILE* mFile;
+    uint64_t mNumVertices;
+    uint64_t mIdBytes;
+    uint64_t mNumAdjacencies;
+    uint64_t mNeighborsPos;
+    bool mFailed;
+};
+
+#endif
@@ -0,0 +1,422 @@
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <malloc.h>
+#include <intrin.h>
+#endif
+
+#if defined( __AVX512F__ ) || defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+
+#include "bitMatrix.h"
+
+const size_t BitMatrix::WORD_BITS;
+const size_t BitMatrix::CACHE_LINE_SIZE;
+const size_t BitMatrix::WORDS_PER_LINE;
+const size_t BitMatrix::INVALID_POS = ~( size_t )0;
+
+static inline size_t popcount64( BitMatrix::word_t pWord )
+{
+#if defined( _MSC_VER ) && defined( _M_X64 )
+    return ( size_t )__popcnt64( pWord );
+#elif defined( __GNUC__ )
+    return ( size_t )__builtin_popcountll( pWord );
+#else
+    pWord = pWord - ( ( pWord >> 1 ) & 0x5555555555555555ULL );
+    pWord = ( pWord & 0x3333333333333333ULL ) + ( ( pWord >> 2 ) & 0x3333333333333333ULL );
+    pWord = ( pWord + ( pWord >> 4 ) ) & 0x0F0F0F0F0F0F0F0FULL;
+    return ( size_t )( ( pWord * 0x0101010101010101ULL ) >> 56 );
+#endif
+}
+
+// pWord must not be zero
+static inline size_t countTrailingZeros64( BitMatrix::word_t pWord )
+{
+#if defined( _MSC_VER ) && defined( _M_X64 )
+    unsigned long lIdx = 0;
+    _BitScanForward64( &lIdx, pWord );
+    return ( size_t )lIdx;
+#elif defined( __GNUC__ )
+    return ( size_t )__builtin_ctzll( pWord );
+#else
+    size_t lIdx = 0;
+    while( 0 == ( pWord & 1 ) )
+    {
+        pWord >>= 1;
+        ++lIdx;
+    }
+    return lIdx;
+#endif
+}
+
+static void* allocateAligned( size_t pNumBytes )
+{
+#ifdef _WIN32
+    return _aligned_malloc( pNumBytes, BitMatrix::CACHE_LINE_SIZE );
+#else
+    void* lPtr = NULL;
+    if( 0 != posix_memalign( &lPtr, BitMatrix::CACHE_LINE_SIZE, pNumBytes ) )
+    {
+        lPtr = NULL;
+    }
+    return lPtr;
+#endif
+}
+
+static void freeAligned( void* pPtr )
+{
+#ifdef _WIN32
+    _aligned_free( pPtr );
+#else
+    free( pPtr );
+#endif
+}
+
+BitMatrix::BitMatrix()
+    : mWords( NULL )
+    , mNumRows( 0 )
+    , mNumCols( 0 )
+    , mWordsPerRow( 0 )
+{
+}
+
+BitMatrix::BitMatrix( size_t pNumRows, size_t pNumCols )
+    : mWords( NULL )
+    , mNumRows( 0 )
+    , mNumCols( 0 )
+    , mWordsPerRow( 0 )
+{
+    resize( pNumRows, pNumCols );
+}
+
+BitMatrix::~BitMatrix()
+{
+    release();
+}
+
+void BitMatrix::release()
+{
+    if( mWords )
+    {
+        freeAligned( mWords );
+        mWords = NULL;
+    }
+    mNumRows = 0;
+    mNumCols = 0;
+    mWordsPerRow = 0;
+}
+
+size_t BitMatrix::wordsPerRow( size_t pNumCols )
+{
+    size_t lNumWords = ( pNumCols + WORD_BITS - 1 ) / WORD_BITS;
+    return ( ( lNumWords + WORDS_PER_LINE - 1 ) / WORDS_PER_LINE ) * WORDS_PER_LINE;
+}
+
+size_t BitMatrix::requiredBytes( size_t pNumRows, size_t pNumCols )
+{
+    return pNumRows * wordsPerRow( pNumCols ) * sizeof( word_t );
+}
+
+bool BitMatrix::resize( size_t pNumRows, size_t pNumCols )
+{
+    release();
+
+    size_t lNumBytes = requiredBytes( pNumRows, pNumCols );
+    if( lNumBytes )
+    {
+        mWords = ( word_t* )allocateAligned( lNumBytes );
+        if( !mWords )
+        {
+            return false;
+        }
+    }
+
+    mNumRows = pNumRows;
+    mNumCols = pNumCols;
+    mWordsPerRow = wordsPerRow( pNumCols );
+    clear();
+
+    return true;
+}
+
+void BitMatrix::clear()
+{
+    if( mWords )
+    {
+        memset( mWords, 0, getNumBytes() );
+    }
+}
+
+void BitMatrix::rowAnd( word_t* pDest, const word_t* pLhs, const word_t* pRhs, size_t pNumWords )
+{
+    size_t lIdx = 0;
+#if defined( __AVX512F__ )
+    for( ; lIdx + 8 <= pNumWords; lIdx += 8 )
+    {
+        __m512i lResult = _mm512_and_si512( _mm512_loadu_si512( pLhs + lIdx ),
+                                            _mm512_loadu_si512( pRhs + lIdx ) );
+        _mm512_storeu_si512( pDest + lIdx, lResult );
+    }
+#elif defined( __AVX2__ )
+    for( ; lIdx + 4 <= pNumWords; lIdx += 4 )
+    {
+        __m256i lResult = _mm256_and_si256( _mm256_loadu_si256( ( const __m256i* )( pLhs + lIdx ) ),
+                                            _mm256_loadu_si256( ( const __m256i* )( pRhs + lIdx ) ) );
+        _mm256_storeu_si256( ( __m256i* )( pDest + lIdx ), lResult );
+    }
+#endif
+    for( ; lIdx < pNumWords; ++lIdx )
+    {
+        pDest[lIdx] = pLhs[lIdx] & pRhs[lIdx];
+    }
+}
+
+void BitMatrix::rowAndNot( word_t* pDest, const word_t* pLhs, const word_t* pRhs, size_t pNumWords )
+{
+    size_t lIdx = 0;
+#if defined( __AVX512F__ )
+    for( ; lIdx + 8 <= pNumWords; lIdx += 8 )
+    {
+        // andnot computes ~first & second
+        __m512i lResult = _mm512_andnot_si512( _mm512_loadu_si512( pRhs + lIdx ),
+                                               _mm512_loadu_si512( pLhs + lIdx ) );
+        _mm512_storeu_si512( pDest + lIdx, lResult );
+    }
+#elif defined( __AVX2__ )
+    for( ; lIdx + 4 <= pNumWords; lIdx += 4 )
+    {
+        __m256i lResult = _mm256_andnot_si256( _mm256_loadu_si256( ( const __m256i* )( pRhs + lIdx ) ),
+                                               _mm256_loadu_si256( ( const __m256i* )( pLhs + lIdx ) ) );
+        _mm256_storeu_si256( ( __m256i* )( pDest + lIdx ), lResult );
+    }
+#endif
+    for( ; lIdx < pNumWords; ++lIdx )
+    {
+        pDest[lIdx] = pLhs[lIdx] & ~pRhs[lIdx];
+    }
+}
+
+void BitMatrix::rowOr( word_t* pDest, const word_t* pLhs, const word_t* pRhs, size_t pNumWords )
+{
+    size_t lIdx = 0;
+#if defined( __AVX512F__ )
+    for( ; lIdx + 8 <= pNumWords; lIdx += 8 )
+    {
+        __m512i lResult = _mm512_or_si512( _mm512_loadu_si512( pLhs + lIdx ),
+                                           _mm512_loadu_si512( pRhs + lIdx ) );
+        _mm512_storeu_si512( pDest + lIdx, lResult );
+    }
+#elif defined( __AVX2__ )
+    for( ; lIdx + 4 <= pNumWords; lIdx += 4 )
+    {
+        __m256i lResult = _mm256_or_si256( _mm256_loadu_si256( ( const __m256i* )( pLhs + lIdx ) ),
+                                           _mm256_loadu_si256( ( const __m256i* )( pRhs + lIdx ) ) );
+        _mm256_storeu_si256( ( __m256i* )( pDest + lIdx ), lResult );
+    }
+#endif
+    for( ; lIdx < pNumWords; ++lIdx )
+    {
+        pDest[lIdx] = pLhs[lIdx] | pRhs[lIdx];
+    }
+}
+
+size_t BitMatrix::rowPopcount( const word_t* pRow, size_t pNumWords )
+{
+    size_t lCount = 0;
+    size_t lIdx = 0;
+#if defined( __AVX512F__ ) && defined( __AVX512VPOPCNTDQ__ )
+    __m512i lSum = _mm512_setzero_si512();
+    for( ; lIdx + 8 <= pNumWords; lIdx += 8 )
+    {
+        lSum = _mm512_add_epi64( lSum, _mm512_popcnt_epi64( _mm512_loadu_si512( pRow + lIdx ) ) );
+    }
+    lCount = ( size_t )_mm512_reduce_add_epi64( lSum );
+#endif
+    // without VPOPCNTDQ the hardware popcnt instruction is already one
+    // word per cycle, which is as fast as the AVX2 nibble lookup
+    for( ; lIdx < pNumWords; ++lIdx )
+    {
+        lCount += popcount64( pRow[lIdx] );
+    }
+    return lCount;
+}
+
+bool BitMatrix::rowIntersects( const word_t* pLhs, const word_t* pRhs, size_t pNumWords )
+{
+    size_t lIdx = 0;
+#if defined( __AVX512F__ )
+    for( ; lIdx + 8 <= pNumWords; lIdx += 8 )
+    {
+        if( _mm512_test_epi64_mask( _mm512_loadu_si512( pLhs + lIdx ),
+                                    _mm512_loadu_si512( pRhs + lIdx ) ) )
+        {
+            return true;
+        }
+    }
+#elif defined( __AVX2__ )
+    for( ; lIdx + 4 <= pNumWords; lIdx += 4 )
+    {
+        if( !_mm256_testz_si256( _mm256_loadu_si256( ( const __m256i* )( pLhs + lIdx ) ),
+                                 _mm256_loadu_si256( ( const __m256i* )( pRhs + lIdx ) ) ) )
+        {
+            return true;
+        }
+    }
+#endif
+    for( ; lIdx < pNumWords; ++lIdx )
+    {
+        if( pLhs[lIdx] & pRhs[lIdx] )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t BitMatrix::rowFindFirstSet( const word_t* pRow, size_t pNumWords, size_t pFrom )
+{
+    size_t lIdx = pFrom / WORD_BITS;
+    if( lIdx >= pNumWords )
+    {
+        return INVALID_POS;
+    }
+
+    // the first word may be partially excluded
+    word_t lWord = pRow[lIdx] & ( ~( word_t )0 << ( pFrom % WORD_BITS ) );
+    if( lWord )
+    {
+        return lIdx * WORD_BITS + countTrailingZeros64( lWord );
+    }
+    ++lIdx;
+
+#if defined( __AVX512F__ )
+    for( ; lIdx + 8 <= pNumWords; lIdx += 8 )
+    {
+        __m512i lBlock = _mm512_loadu_si512( pRow + lIdx );
+        if( _mm512_test_epi64_mask( lBlock, lBlock ) )
+        {
+            break;
+        }
+    }
+#elif defined( __AVX2__ )
+    for( ; lIdx + 4 <= pNumWords; lIdx += 4 )
+    {
+        __m256i lBlock = _mm256_loadu_si256( ( const __m256i* )( pRow + lIdx ) );
+        if( !_mm256_testz_si256( lBlock, lBlock ) )
+        {
+            break;
+        }
+    }
+#endif
+    for( ; lIdx < pNumWords; ++lIdx )
+    {
+        if( pRow[lIdx] )
+        {
+            return lIdx * WORD_BITS + countTrailingZeros64( pRow[lIdx] );
+        }
+    }
+    return INVALID_POS;
+}
+
+size_t BitMatrix::rowFindFirstClear( const word_t* pRow, size_t pNumWords, size_t pFrom )
+{
+    size_t lIdx = pFrom / WORD_BITS;
+    if( lIdx >= pNumWords )
+    {
+        return INVALID_POS;
+    }
+
+    word_t lWord = ~pRow[lIdx] & ( ~( word_t )0 << ( pFrom % WORD_BITS ) );
+    if( lWord )
+    {
+        return lIdx * WORD_BITS + countTrailingZeros64( lWord );
+    }
+    ++lIdx;
+
+#if defined( __AVX512F__ )
+    const __m512i lOnes = _mm512_set1_epi64( -1 );
+    for( ; lIdx + 8 <= pNumWords; lIdx += 8 )
+    {
+        if( _mm512_cmpneq_epi64_mask( _mm512_loadu_si512( pRow + lIdx ), lOnes ) )
+        {
+            break;
+        }
+    }
+#elif defined( __AVX2__ )
+    const __m256i lOnes = _mm256_set1_epi64x( -1 );
+    for( ; lIdx + 4 <= pNumWords; lIdx += 4 )
+    {
+        // testc is set when every bit of the block is one
+        if( !_mm256_testc_si256( _mm256_loadu_si256( ( const __m256i* )( pRow + lIdx ) ), lOnes ) )
+        {
+            break;
+        }
+    }
+#endif
+    for( ; lIdx < pNumWords; ++lIdx )
+    {
+        if( ~pRow[lIdx] )
+        {
+            return lIdx * WORD_BITS + countTrailingZeros64( ~pRow[lIdx] );
+        }
+    }
+    return INVALID_POS;
+}
+
+bool BitMatrix::exportByteMatrix( byte_t*& rMatrix, size_t& rNumBytes ) const
+{
+    size_t lNumBits = mNumRows * mNumCols;
+    rNumBytes = ( lNumBits + 7 ) / 8;
+    rMatrix = new byte_t[rNumBytes];
+    std::fill( rMatrix, rMatrix + rNumBytes, 0 );
+
+    for( size_t lRow = 0; lRow < mNumRows; ++lRow )
+    {
+        const word_t* lWords = getRow( lRow );
+        size_t lRowOffset = lRow * mNumCols;
+
+        for( size_t lCol = rowFindFirstSet( lWords, mWordsPerRow );
+             lCol < mNumCols;
+             lCol = rowFindFirstSet( lWords, mWordsPerRow, lCol + 1 ) )
+        {
+            size_t lBit = lRowOffset + lCol;
+            rMatrix[lBit / 8] |= ( byte_t )( 0x80 >> ( lBit % 8 ) );
+        }
+    }
+
+    return true;
+}
+
+bool BitMatrix::importByteMatrix( const byte_t* pMatrix, size_t pNumRows, size_t pNumCols )
+{
+    if( !resize( pNumRows, pNumCols ) )
+    {
+        return false;
+    }
+
+    if( 0 == pNumCols )
+    {
+        return true;
+    }
+
+    size_t lNumBytes = ( pNumRows * pNumCols + 7 ) / 8;
+    for( size_t lByte = 0; lByte < lNumBytes; ++lByte )
+    {
+        byte_t lValue = pMatrix[lByte];
+        for( size_t lBitPos = 0; lValue; ++lBitPos, lValue <<= 1 )
+        {
+            if( lValue & 0x80 )
+            {
+                size_t lBit = lByte * 8 + lBitPos;
+                set( lBit / pNumCols, lBit % pNumCols );
+            }
+        }
+    }
+
+    return true;
+}
+
+// end of file
@@ -0,0 +1,102 @@
+#ifndef _BIT_MATRIX_H_
+#define _BIT_MATRIX_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+// Dense bit matrix stored as 64 bit words, bit c of a row lives in word
+// c / 64 at position c % 64 (LSB first). Every row is padded to a whole
+// number of cache lines and starts on a cache line boundary, so the row
+// operations below never straddle rows and can use full width SIMD loads.
+class BitMatrix
+{
+public:
+    typedef uint64_t word_t;
+    typedef unsigned char byte_t;
+
+    static const size_t WORD_BITS = 64;
+    static const size_t CACHE_LINE_SIZE = 64;
+    static const size_t WORDS_PER_LINE = CACHE_LINE_SIZE / sizeof( word_t );
+    static const size_t INVALID_POS;
+
+    BitMatrix();
+    BitMatrix( size_t pNumRows, size_t pNumCols );
+    ~BitMatrix();
+
+    // Reallocates the matrix and clears every bit
+    bool resize( size_t pNumRows, size_t pNumCols );
+
+    void clear();
+
+    void release();
+
+    size_t getNumRows() const { return mNumRows; }
+    size_t getNumCols() const { return mNumCols; }
+    size_t getWordsPerRow() const { return mWordsPerRow; }
+    size_t getNumBytes() const { return mNumRows * mWordsPerRow * sizeof( word_t ); }
+    bool empty() const { return ( 0 == mNumRows ); }
+
+    word_t* getRow( size_t pRow )
+    {
+        return mWords + pRow * mWordsPerRow;
+    }
+
+    const word_t* getRow( size_t pRow ) const
+    {
+        return mWords + pRow * mWordsPerRow;
+    }
+
+    bool test( size_t pRow, size_t pCol ) const
+    {
+        return 0 != ( getRow( pRow )[pCol / WORD_BITS] & ( ( word_t )1 << ( pCol % WORD_BITS ) ) );
+    }
+
+    void set( size_t pRow, size_t pCol )
+    {
+        getRow( pRow )[pCol / WORD_BITS] |= ( ( word_t )1 << ( pCol % WORD_BITS ) );
+    }
+
+    void reset( size_t pRow, size_t pCol )
+    {
+        getRow( pRow )[pCol / WORD_BITS] &= ~( ( word_t )1 << ( pCol % WORD_BITS ) );
+    }
+
+    // Number of words needed to hold a padded row of pNumCols bits
+    static size_t wordsPerRow( size_t pNumCols );
+
+    // Exact number of bytes a pNumRows x pNumCols matrix allocates
+    static size_t requiredBytes( size_t pNumRows, size_t pNumCols );
+
+    // Word level row operations. pNumWords is normally getWordsPerRow(), but
+    // any count is accepted. rDest may alias either operand.
+    static void rowAnd( word_t* pDest, const word_t* pLhs, const word_t* pRhs, size_t pNumWords );
+    static void rowAndNot( word_t* pDest, const word_t* pLhs, const word_t* pRhs, size_t pNumWords );
+    static void rowOr( word_t* pDest, const word_t* pLhs, const word_t* pRhs, size_t pNumWords );
+    static size_t rowPopcount( const word_t* pRow, size_t pNumWords );
+
+    // True if ( pLhs & pRhs ) has any bit set
+    static bool rowIntersects( const word_t* pLhs, const word_t* pRhs, size_t pNumWords );
+
+    // Position of the first set (clear) bit at or after pFrom, INVALID_POS
+    // if there is none
+    static size_t rowFindFirstSet( const word_t* pRow, size_t pNumWords, size_t pFrom = 0 );
+    static size_t rowFindFirstClear( const word_t* pRow, size_t pNumWords, size_t pFrom = 0 );
+
+    // Converts to / from the byte layout used by the OpenCL kernels: rows
+    // packed back to back without padding, bit ( r * cols + c ) stored MSB
+    // first (see Graph::getBit). rMatrix is allocated with new[].
+    bool exportByteMatrix( byte_t*& rMatrix, size_t& rNumBytes ) const;
+    bool importByteMatrix( const byte_t* pMatrix, size_t pNumRows, size_t pNumCols );
+
+private:
+    // not copyable
+    BitMatrix( const BitMatrix& );
+    BitMatrix& operator= ( const BitMatrix& );
+
+    word_t* mWords;
+    size_t mNumRows;
+    size_t mNumCols;
+    size_t mWordsPerRow;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "chromaticBounds.h"
+
+bool ChromaticBounds::write( const char* pFilename, const char* pModelName, uint64_t pNumVertices, uint64_t pSeed ) const
+{
+    FILE* lFile = fopen( pFilename, "w" );
+    if( !lFile )
+    {
+        return false;
+    }
+
+    fprintf( lFile, "# chromatic number of a generated graph, exact when the bounds agree\n" );
+    fprintf( lFile, "model %s\n", pModelName );
+    fprintf( lFile, "vertices %llu\n", ( unsigned long long )pNumVertices );
+    fprintf( lFile, "seed %llu\n", ( unsigned long long )pSeed );
+    fprintf( lFile, "lower %llu\n", ( unsigned long long )mLower );
+    fprintf( lFile, "upper %llu\n", ( unsigned long long )mUpper );
+
+    bool lRet = !ferror( lFile );
+    lRet = ( 0 == fclose( lFile ) ) && lRet;
+    return lRet;
+}
+
+bool ChromaticBounds::read( const char* pFilename )
+{
+    FILE* lFile = fopen( pFilename, "r" );
+    if( !lFile )
+    {
+        return false;
+    }
+
+    bool lHasLower = false;
+    bool lHasUpper = false;
+    char lLine[256];
+    while( fgets( lLine, sizeof( lLine ), lFile ) )
+    {
+        char lKey[64];
+        char lValue[128];
+        if( '#' == lLine[0] || 2 != sscanf( lLine, "%63s %127s", lKey, lValue ) )
+        {
+            continue;
+        }
+        if( 0 == strcmp( lKey, "lower" ) )
+        {
+            mLower = strtoull( lValue, NULL, 10 );
+            lHasLower = true;
+        }
+        else if( 0 == strcmp( lKey, "upper" ) )
+        {
+            mUpper = strtoull( lValue, NULL, 10 );
+            lHasUpper = true;
+        }
+    }
+    fclose( lFile );
+
+    return lHasLower && lHasUpper && mLower <= mUpper;
+}
+
+void ChromaticBounds::printGap( uint64_t pNumColors ) const
+{
+    if( isExact() )
+    {
+        printf( "Chromatic number %llu, %lld colours over it\n",
+                ( unsigned long long )mLower, ( long long )pNumColors - ( long long )mLower );
+    }
+    else
+    {
+        printf( "Chromatic number in [%llu, %llu], at most %lld colours over it\n",
+                ( unsigned long long )mLower, ( unsigned long long )mUpper, ( long long )pNumColors - ( long long )mLower );
+    }
+}
+
+// end of file
@@ -0,0 +1,50 @@
+#ifndef _CHROMATIC_BOUNDS_H_
+#define _CHROMATIC_BOUNDS_H_
+
+#include <stdint.h>
+
+// Chromatic number of a generated graph, or bounds on it. graphGen writes
+// them next to the graph, graphColor reads them back to tell how many
+// colors over the optimum a coloring is. The file holds one "key value"
+// line each for the model, the vertices, the seed and the bounds; lines
+// starting with # are comments.
+class ChromaticBounds
+{
+public:
+    ChromaticBounds()
+        : mLower( 0 ), mUpper( 0 )
+    {}
+
+    ChromaticBounds( uint64_t pLower, uint64_t pUpper )
+        : mLower( pLower ), mUpper( pUpper )
+    {}
+
+    uint64_t getLower() const
+    {
+        return mLower;
+    }
+
+    uint64_t getUpper() const
+    {
+        return mUpper;
+    }
+
+    bool isExact() const
+    {
+        return mLower == mUpper;
+    }
+
+    bool write( const char* pFilename, const char* pModelName, uint64_t pNumVertices, uint64_t pSeed ) const;
+
+    // False if the file cannot be read or lacks either bound
+    bool read( const char* pFilename );
+
+    // How far pNumColors colors are from the chromatic number
+    void printGap( uint64_t pNumColors ) const;
+
+private:
+    uint64_t mLower;
+    uint64_t mUpper;
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include <algorithm>
+
+#include "compactGraph.h"
+#include "graph.h"
+#include "parallelUtils.h"
+
+// Sorts the rows [pBegin, pEnd) of a scattered CSR in place and drops the
+// duplicates; rCounts receives the number of entries kept per row
+template< typename VertexId, typename Offset >
+struct SortRows
+{
+    SortRows( const Offset* pOffsets, VertexId* pNeighbors, std::vector<Offset>& rCounts )
+        : mOffsets( pOffsets ), mNeighbors( pNeighbors ), mCounts( rCounts )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        for( size_t lRow = pBegin; lRow < pEnd; ++lRow )
+        {
+            VertexId* lFirst = mNeighbors + mOffsets[lRow];
+            VertexId* lLast = mNeighbors + mOffsets[lRow + 1];
+            std::sort( lFirst, lLast );
+            mCounts[lRow] = std::unique( lFirst, lLast ) - lFirst;
+        }
+    }
+
+    const Offset* mOffsets;
+    VertexId* mNeighbors;
+    std::vector<Offset>& mCounts;
+};
+
+// Moves the kept prefix of every row to its final offset
+template< typename VertexId, typename Offset >
+struct CompactRows
+{
+    CompactRows( const Offset* pFrom, const VertexId* pScattered, const Offset* pTo, const std::vector<Offset>& rCounts, VertexId* pNeighbors )
+        : mFrom( pFrom ), mScattered( pScattered ), mTo( pTo ), mCounts( rCounts ), mNeighbors( pNeighbors )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        for( size_t lRow = pBegin; lRow < pEnd; ++lRow )
+        {
+            const VertexId* lFirst = mScattered + mFrom[lRow];
+            std::copy( lFirst, lFirst + mCounts[lRow], mNeighbors + mTo[lRow] );
+        }
+    }
+
+    const Offset* mFrom;
+    const VertexId* mScattered;
+    const Offset* mTo;
+    const std::vector<Offset>& mCounts;
+    VertexId* mNeighbors;
+};
+
+template< typename VertexId >
+BasicCompactGraph<VertexId>::BasicCompactGraph()
+    : mOffsetArray( NULL )
+    , mNeighborArray( NULL )
+    , mNumVertices( 0 )
+    , mMaxDegree( 0 )
+{
+}
+
+template< typename VertexId >
+void BasicCompactGraph<VertexId>::clear()
+{
+    mOffsets.clear();
+    mNeighbors.clear();
+    mOffsetArray = NULL;
+    mNeighborArray = NULL;
+    mNumVertices = 0;
+    mMaxDegree = 0;
+}
+
+template< typename VertexId >
+bool BasicCompactGraph<VertexId>::attach( const offset_t* pOffsets,
+                                          const vertexId_t* pNeighbors,
+                                          size_t pNumVertices,
+                                          size_t pMaxDegree )
+{
+    clear();
+
+    if( !pOffsets || 0 == pNumVertices || !fitsVertexId<vertexId_t>( pNumVertices ) )
+    {
+        return false;
+    }
+
+    mOffsetArray = pOffsets;
+    mNeighborArray = pNeighbors;
+    mNumVertices = pNumVertices;
+    mMaxDegree = pMaxDegree;
+    return true;
+}
+
+template< typename VertexId >
+template< typename SourceId >
+bool BasicCompactGraph<VertexId>::freeze( const BasicGraph<SourceId>& rGraph )
+{
+    bool lRet = false;
+
+    clear();
+
+    if( !rGraph.empty() && fitsVertexId<vertexId_t>( rGraph.size() ) )
+    {
+        size_t lNumVertices = rGraph.size();
+
+        offset_t lNumAdjacencies = 0;
+        for( size_t lIdx = 0; lIdx < lNumVertices; ++lIdx )
+        {
+            lNumAdjacencies += rGraph.getDegree( ( SourceId )lIdx );
+        }
+
+        mOffsets.resize( lNumVertices + 1 );
+        mNeighbors.resize( ( size_t )lNumAdjacencies );
+
+        // the sets are already ordered, so the copy keeps every row sorted
+        offset_t lOffset = 0;
+        for( size_t lIdx = 0; lIdx < lNumVertices; ++lIdx )
+        {
+            typename BasicGraph<SourceId>::NeighborRange lList = rGraph.getNeighbors( ( SourceId )lIdx );
+            mOffsets[lIdx] = lOffset;
+            std::copy( lList.begin(), lList.end(), mNeighbors.begin() + ( size_t )lOffset );
+            lOffset += lList.size();
+        }
+        mOffsets[lNumVertices] = lOffset;
+        mMaxDegree = rGraph.getMaxDegree();
+
+        mOffsetArray = &mOffsets[0];
+        mNeighborArray = mNeighbors.empty() ? NULL : &mNeighbors[0];
+        mNumVertices = lNumVertices;
+
+        lRet = true;
+    }
+
+    return lRet;
+}
+
+template< typename VertexId >
+bool BasicCompactGraph<VertexId>::build( size_t pNumVertices, const idPair_t* pEdges, size_t pNumEdges )
+{
+    clear();
+
+    if( 0 == pNumVertices || !fitsVertexId<vertexId_t>( pNumVertices ) )
+    {
+        return false;
+    }
+
+    // counting pass, both directions of every edge
+    offsetVec_t lScatterOffsets( pNumVertices + 1, 0 );
+    for( size_t lIdx = 0; lIdx < pNumEdges; ++lIdx )
+    {
+        const idPair_t& rEdge = pEdges[lIdx];
+        if( rEdge.first >= pNumVertices || rEdge.second >= pNumVertices )
+        {
+            return false;
+        }
+        if( rEdge.first != rEdge.second )
+        {
+            ++lScatterOffsets[rEdge.first];
+            ++lScatterOffsets[rEdge.second];
+        }
+    }
+    offset_t lNumArcs = parallelExclusiveScan( &lScatterOffsets[0], &lScatterOffsets[0], pNumVertices + 1 );
+
+    idVec_t lScattered( ( size_t )lNumArcs );
+    {
+        offsetVec_t lCursors( lScatterOffsets.begin(), lScatterOffsets.end() - 1 );
+        for( size_t lIdx = 0; lIdx < pNumEdges; ++lIdx )
+        {
+            const idPair_t& rEdge = pEdges[lIdx];
+            if( rEdge.first != rEdge.second )
+            {
+                lScattered[( size_t )lCursors[rEdge.first]++] = rEdge.second;
+                lScattered[( size_t )lCursors[rEdge.second]++] = rEdge.first;
+            }
+        }
+    }
+
+    // sort and dedupe every row, then pack the rows tight
+    vertexId_t* lScatteredArray = lScattered.empty() ? NULL : &lScattered[0];
+    std::vector<offset_t> lCounts( pNumVertices + 1, 0 );
+    SortRows<vertexId_t, offset_t> lSorter( &lScatterOffsets[0], lScatteredArray, lCounts );
+    parallelFor( 0, pNumVertices, lSorter );
+
+    mOffsets.resize( pNumVertices + 1 );
+    offset_t lNumAdjacencies = parallelExclusiveScan( &lCounts[0], &mOffsets[0], pNumVertices + 1 );
+
+    if( lNumAdjacencies == lNumArcs )
+    {
+        mNeighbors.swap( lScattered );
+    }
+    else
+    {
+        mNeighbors.resize( ( size_t )lNumAdjacencies );
+        CompactRows<vertexId_t, offset_t> lPacker( &lScatterOffsets[0], lScatteredArray, &mOffsets[0], lCounts,
+                                                   mNeighbors.empty() ? NULL : &mNeighbors[0] );
+        parallelFor( 0, pNumVertices, lPacker );
+    }
+
+    mMaxDegree = 0;
+    for( size_t lIdx = 0; lIdx < pNumVertices; ++lIdx )
+    {
+        mMaxDegree = std::max( mMaxDegree, ( size_t )lCounts[lIdx] );
+    }
+
+    mOffsetArray = &mOffsets[0];
+    mNeighborArray = mNeighbors.empty() ? NULL : &mNeighbors[0];
+    mNumVertices = pNumVertices;
+    return true;
+}
+
+template< typename VertexId >
+bool BasicCompactGraph<VertexId>::isEdge( const vertexId_t& rFirst, const vertexId_t& rSecond ) const
+{
+    NeighborRange lNeighbors = getNeighbors( rFirst );
+    return std::binary_search( lNeighbors.begin(), lNeighbors.end(), rSecond );
+}
+
+template class BasicCompactGraph<uint16_t>;
+template class BasicCompactGraph<uint32_t>;
+template class BasicCompactGraph<uint64_t>;
+
+#define INSTANTIATE_FREEZE( Id, SourceId ) \
+    template bool BasicCompactGraph<Id>::freeze<SourceId>( const BasicGraph<SourceId>& );
+
+INSTANTIATE_FREEZE( uint16_t, uint16_t )
+INSTANTIATE_FREEZE( uint16_t, uint32_t )
+INSTANTIATE_FREEZE( uint16_t, uint64_t )
+INSTANTIATE_FREEZE( uint32_t, uint16_t )
+INSTANTIATE_FREEZE( uint32_t, uint32_t )
+INSTANTIATE_FREEZE( uint32_t, uint64_t )
+INSTANTIATE_FREEZE( uint64_t, uint16_t )
+INSTANTIATE_FREEZE( uint64_t, uint32_t )
+INSTANTIATE_FREEZE( uint64_t, uint64_t )
+
+// end of file
@@ -0,0 +1,157 @@
+#ifndef _COMPACT_GRAPH_H_
+#define _COMPACT_GRAPH_H_
+
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+#include "graphFwd.h"
+#include "vertexIdTraits.h"
+
+// Immutable compressed sparse row (CSR) snapshot of a Graph.
+// The neighbors of vertex v are mNeighbors[ mOffsets[v] .. mOffsets[v + 1] ),
+// sorted in ascending id order.
+//
+// Templated on the vertex id type like BasicGraph; the id width of the
+// snapshot does not have to match the one of the graph it is built from.
+//
+// The arrays are either owned (freeze, build) or borrowed in place
+// (attach), e.g. from a mapped binary graph file; the accessors do not tell
+// them apart.
+template< typename VertexId >
+class BasicCompactGraph
+{
+public:
+    typedef VertexId vertexId_t;
+    typedef uint64_t offset_t;
+
+    typedef std::vector<offset_t> offsetVec_t;
+    typedef std::vector<vertexId_t> idVec_t;
+    typedef std::pair<vertexId_t, vertexId_t> idPair_t;
+
+    // Read only view over the neighbors of a single vertex
+    class NeighborRange
+    {
+    public:
+        typedef const vertexId_t* const_iterator;
+
+        NeighborRange( const vertexId_t* pBegin, const vertexId_t* pEnd )
+            : mBegin( pBegin ), mEnd( pEnd )
+        {}
+
+        const_iterator begin() const { return mBegin; }
+        const_iterator end() const { return mEnd; }
+        size_t size() const { return mEnd - mBegin; }
+        bool empty() const { return mBegin == mEnd; }
+        const vertexId_t& operator[] ( size_t pIdx ) const { return mBegin[pIdx]; }
+
+    private:
+        const vertexId_t* mBegin;
+        const vertexId_t* mEnd;
+    };
+
+    BasicCompactGraph();
+
+    // Builds the snapshot in a single pass over the adjacency sets of rGraph.
+    // Any previous contents are discarded. False if the graph is empty or
+    // has more vertices than vertexId_t can number.
+    template< typename SourceId >
+    bool freeze( const BasicGraph<SourceId>& rGraph );
+
+    // Builds the snapshot straight from an undirected edge list, without a
+    // Graph: rows are filled by a counting pass, then sorted and cleared of
+    // duplicates on the thread pool. Self loops are dropped. False if an
+    // id is not below pNumVertices.
+    bool build( size_t pNumVertices, const idPair_t* pEdges, size_t pNumEdges );
+
+    // Uses pNumVertices + 1 offsets and the neighbor array they index in
+    // place, without a copy. The arrays must outlive the snapshot and hold
+    // sorted rows. Any previous contents are discarded.
+    bool attach( const offset_t* pOffsets, const vertexId_t* pNeighbors, size_t pNumVertices, size_t pMaxDegree );
+
+    // True if the arrays are borrowed
+    bool isAttached() const
+    {
+        return ( mOffsetArray != NULL ) && mOffsets.empty();
+    }
+
+    NeighborRange getNeighbors( const vertexId_t& rId ) const
+    {
+        return NeighborRange( mNeighborArray + mOffsetArray[rId], mNeighborArray + mOffsetArray[rId + 1] );
+    }
+
+    size_t getDegree( const vertexId_t& rId ) const
+    {
+        return ( size_t )( mOffsetArray[rId + 1] - mOffsetArray[rId] );
+    }
+
+    size_t getMaxDegree() const
+    {
+        return mMaxDegree;
+    }
+
+    bool isEdge( const vertexId_t& rFirst, const vertexId_t& rSecond ) const;
+
+    bool isValidId( const vertexId_t& rId ) const
+    {
+        return ( rId < size() );
+    }
+
+    size_t size() const
+    {
+        return mNumVertices;
+    }
+
+    bool empty() const
+    {
+        return ( 0 == size() );
+    }
+
+    // Number of entries in the neighbor array, i.e. twice the number of
+    // undirected edges
+    size_t getNumAdjacencies() const
+    {
+        return mNumVertices ? ( size_t )mOffsetArray[mNumVertices] : 0;
+    }
+
+    // Heap bytes held by the offset and neighbor arrays, 0 when attached
+    size_t getNumBytes() const
+    {
+        return mOffsets.capacity() * sizeof( offset_t ) + mNeighbors.capacity() * sizeof( vertexId_t );
+    }
+
+    // Exact number of bytes freeze() allocates for a graph of pNumVertices
+    // vertices and pNumAdjacencies neighbor entries
+    static size_t requiredBytes( size_t pNumVertices, size_t pNumAdjacencies )
+    {
+        return ( pNumVertices + 1 ) * sizeof( offset_t ) + pNumAdjacencies * sizeof( vertexId_t );
+    }
+
+    // Raw arrays, suitable for uploading to the device
+    const offset_t* getOffsetArray() const
+    {
+        return mOffsetArray;
+    }
+
+    const vertexId_t* getNeighborArray() const
+    {
+        return mNeighborArray;
+    }
+
+private:
+    // not copyable, the array pointers may point into the vectors
+    BasicCompactGraph( const BasicCompactGraph& );
+    BasicCompactGraph& operator= ( const BasicCompactGraph& );
+
+    void clear();
+
+    offsetVec_t mOffsets;
+    idVec_t mNeighbors;
+
+    const offset_t* mOffsetArray;
+    const vertexId_t* mNeighborArray;
+    size_t mNumVertices;
+    size_t mMaxDegree;
+};
+
+#endif
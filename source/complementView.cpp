@@ -0,0 +1,96 @@
+#include <algorithm>
+
+#include "complementView.h"
+
+template< typename VertexId >
+BasicComplementView<VertexId>::BasicComplementView()
+    : mGraph( NULL )
+    , mOrderArray( NULL )
+    , mRankArray( NULL )
+    , mNumVertices( 0 )
+{
+}
+
+template< typename VertexId >
+bool BasicComplementView<VertexId>::attach( const compactGraph_t& rGraph, const vertexId_t* pOrder, const vertexId_t* pRanks )
+{
+    mGraph = &rGraph;
+    mOrder.clear();
+    mRanks.clear();
+    mOrderArray = pOrder;
+    mRankArray = pRanks;
+    mNumVertices = pOrder ? rGraph.size() : 0;
+
+    return ( 0 != mNumVertices );
+}
+
+template< typename VertexId >
+bool BasicComplementView<VertexId>::build( const compactGraph_t& rGraph )
+{
+    mGraph = &rGraph;
+    mOrder.clear();
+    mRanks.clear();
+    mOrderArray = NULL;
+    mRankArray = NULL;
+    mNumVertices = 0;
+
+    size_t lNumVertices = rGraph.size();
+    if( 0 == lNumVertices )
+    {
+        return false;
+    }
+
+    // counting sort on the degree, stable so ties stay in id order
+    std::vector<size_t> lStart( rGraph.getMaxDegree() + 2, 0 );
+    for( vertexId_t v = 0; v < lNumVertices; ++v )
+    {
+        ++lStart[rGraph.getDegree( v ) + 1];
+    }
+    for( size_t lDegree = 1; lDegree < lStart.size(); ++lDegree )
+    {
+        lStart[lDegree] += lStart[lDegree - 1];
+    }
+
+    mOrder.resize( lNumVertices );
+    idVec_t lRankOf( lNumVertices );
+    for( vertexId_t v = 0; v < lNumVertices; ++v )
+    {
+        size_t lPos = lStart[rGraph.getDegree( v )]++;
+        mOrder[lPos] = v;
+        lRankOf[v] = ( vertexId_t )lPos;
+    }
+
+    // CSR rows translated to ranks, each row sorted
+    const offset_t* lOffsets = rGraph.getOffsetArray();
+    const vertexId_t* lNeighbors = rGraph.getNeighborArray();
+
+    mRanks.resize( rGraph.getNumAdjacencies() );
+    for( vertexId_t v = 0; v < lNumVertices; ++v )
+    {
+        for( offset_t lIdx = lOffsets[v]; lIdx < lOffsets[v + 1]; ++lIdx )
+        {
+            mRanks[lIdx] = lRankOf[lNeighbors[lIdx]];
+        }
+        std::sort( mRanks.begin() + lOffsets[v], mRanks.begin() + lOffsets[v + 1] );
+    }
+
+    mOrderArray = &mOrder[0];
+    mRankArray = mRanks.empty() ? NULL : &mRanks[0];
+    mNumVertices = lNumVertices;
+
+    return true;
+}
+
+template< typename VertexId >
+size_t BasicComplementView<VertexId>::getNumNonNeighbors( vertexId_t pVertex ) const
+{
+    // a self loop already accounts for the vertex itself
+    size_t lSelf = mGraph->isEdge( pVertex, pVertex ) ? 0 : 1;
+    return mNumVertices - mGraph->getDegree( pVertex ) - lSelf;
+}
+
+template class BasicComplementView<uint16_t>;
+template class BasicComplementView<uint32_t>;
+template class BasicComplementView<uint64_t>;
+
+// end of file
@@ -0,0 +1,218 @@
+#ifndef _COMPLEMENT_VIEW_H_
+#define _COMPLEMENT_VIEW_H_
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+#include "compactGraph.h"
+
+// Implicit complement of a CompactGraph. The non neighbors of a vertex are
+// never stored; they are produced on the fly, in ascending degree order, by
+// walking one global degree sorted vertex order and skipping the vertex
+// itself and its neighbors. Memory is O(V + E) instead of the O(V^2) of
+// materialized non adjacency lists.
+//
+// To skip neighbors without a search, each CSR row is also kept as the
+// ascending positions ("ranks") of the neighbors in the global order, so a
+// walk is a merge of two sorted sequences. The order and the ranks use the
+// id type of the graph.
+template< typename VertexId >
+class BasicComplementView
+{
+public:
+    typedef BasicCompactGraph<VertexId> compactGraph_t;
+    typedef VertexId vertexId_t;
+    typedef typename compactGraph_t::offset_t offset_t;
+    typedef std::vector<vertexId_t> idVec_t;
+
+    // Forward iterator over the non neighbors of one vertex
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef vertexId_t value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const vertexId_t* pointer;
+        typedef vertexId_t reference;
+
+        const_iterator( const BasicComplementView* pView,
+                        vertexId_t pVertex,
+                        size_t pPos,
+                        const vertexId_t* pRank,
+                        const vertexId_t* pRankEnd )
+            : mView( pView )
+            , mVertex( pVertex )
+            , mPos( pPos )
+            , mRank( pRank )
+            , mRankEnd( pRankEnd )
+        {
+            settle();
+        }
+
+        vertexId_t operator* () const
+        {
+            return mView->mOrderArray[mPos];
+        }
+
+        const_iterator& operator++ ()
+        {
+            ++mPos;
+            settle();
+            return *this;
+        }
+
+        bool operator== ( const const_iterator& rOther ) const
+        {
+            return ( mPos == rOther.mPos );
+        }
+
+        bool operator!= ( const const_iterator& rOther ) const
+        {
+            return ( mPos != rOther.mPos );
+        }
+
+    private:
+        // Moves forward to the next position that is not a neighbor nor
+        // the vertex itself
+        void settle()
+        {
+            size_t lNumVertices = mView->mNumVertices;
+            while( mPos < lNumVertices )
+            {
+                if( mRank != mRankEnd && *mRank == mPos )
+                {
+                    ++mRank;
+                }
+                else if( mView->mOrderArray[mPos] != mVertex )
+                {
+                    return;
+                }
+                ++mPos;
+            }
+        }
+
+        const BasicComplementView* mView;
+        vertexId_t mVertex;
+        size_t mPos;
+        const vertexId_t* mRank;
+        const vertexId_t* mRankEnd;
+    };
+
+    // Non neighbors of a single vertex, in ascending degree order
+    class Range
+    {
+    public:
+        Range( const BasicComplementView& rView, vertexId_t pVertex )
+            : mView( &rView ), mVertex( pVertex )
+        {}
+
+        const_iterator begin() const
+        {
+            return const_iterator( mView, mVertex, 0, mView->rankBegin( mVertex ), mView->rankEnd( mVertex ) );
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator( mView, mVertex, mView->mNumVertices, NULL, NULL );
+        }
+
+        // Computed from the degree, the walk is not needed
+        size_t size() const
+        {
+            return mView->getNumNonNeighbors( mVertex );
+        }
+
+        bool empty() const
+        {
+            return ( 0 == size() );
+        }
+
+    private:
+        const BasicComplementView* mView;
+        vertexId_t mVertex;
+    };
+
+    BasicComplementView();
+
+    // Builds the global order and the rank rows. rGraph must outlive the view.
+    bool build( const compactGraph_t& rGraph );
+
+    // Uses a precomputed order ( getNumVertices() ids ) and rank array
+    // ( laid out like the neighbors of rGraph ) in place, without a copy.
+    // rGraph and both arrays must outlive the view.
+    bool attach( const compactGraph_t& rGraph, const vertexId_t* pOrder, const vertexId_t* pRanks );
+
+    Range getNonNeighbors( vertexId_t pVertex ) const
+    {
+        return Range( *this, pVertex );
+    }
+
+    size_t getNumNonNeighbors( vertexId_t pVertex ) const;
+
+    size_t size() const
+    {
+        return mNumVertices;
+    }
+
+    bool empty() const
+    {
+        return ( 0 == mNumVertices );
+    }
+
+    // Vertices sorted by ascending degree, ties by ascending id
+    const vertexId_t* getOrderArray() const
+    {
+        return mOrderArray;
+    }
+
+    // Ranks of the neighbors of each vertex, ascending, laid out like the
+    // CSR neighbor array of the graph (same offsets)
+    const vertexId_t* getRankArray() const
+    {
+        return mRankArray;
+    }
+
+    const compactGraph_t& getGraph() const
+    {
+        return *mGraph;
+    }
+
+    // Heap bytes held by the view, not counting the graph, 0 when attached
+    size_t getNumBytes() const
+    {
+        return ( mOrder.capacity() + mRanks.capacity() ) * sizeof( vertexId_t );
+    }
+
+    // Exact number of bytes build() keeps for a graph of pNumVertices
+    // vertices and pNumAdjacencies neighbor entries
+    static size_t requiredBytes( size_t pNumVertices, size_t pNumAdjacencies )
+    {
+        return ( pNumVertices + pNumAdjacencies ) * sizeof( vertexId_t );
+    }
+
+private:
+    // not copyable, the array pointers may point into the vectors
+    BasicComplementView( const BasicComplementView& );
+    BasicComplementView& operator= ( const BasicComplementView& );
+
+    const vertexId_t* rankBegin( vertexId_t pVertex ) const
+    {
+        return getRankArray() + mGraph->getOffsetArray()[pVertex];
+    }
+
+    const vertexId_t* rankEnd( vertexId_t pVertex ) const
+    {
+        return getRankArray() + mGraph->getOffsetArray()[pVertex + 1];
+    }
+
+    const compactGraph_t* mGraph;
+    idVec_t mOrder;
+    idVec_t mRanks;
+
+    const vertexId_t* mOrderArray;
+    const vertexId_t* mRankArray;
+    size_t mNumVertices;
+};
+
+#endif
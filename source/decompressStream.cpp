@@ -0,0 +1,377 @@
+#include <cstring>
+
+#ifdef _GRAFCOLOR_HAVE_ZLIB_
+#include <zlib.h>
+#endif
+#ifdef _GRAFCOLOR_HAVE_ZSTD_
+#include <zstd.h>
+#endif
+
+#include "decompressStream.h"
+
+namespace
+{
+    // compressed bytes read from the file at a time
+    const size_t INPUT_BYTES = 256 * 1024;
+
+    const unsigned char GZIP_MAGIC[] = { 0x1f, 0x8b };
+    const unsigned char ZSTD_MAGIC[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+    const char* getCompressionName( Compression_t pCompression )
+    {
+        return ( COMPRESSION_GZIP == pCompression ) ? "gzip" : "zstd";
+    }
+}
+
+DecompressStream::DecompressStream()
+    : mFile( NULL )
+    , mCompression( COMPRESSION_NONE )
+    , mBlockBytes( 0 )
+    , mInputSize( 0 )
+    , mCompressedBytes( 0 )
+    , mEnd( false )
+    , mFailed( false )
+    , mStop( false )
+{
+}
+
+DecompressStream::~DecompressStream()
+{
+    close();
+}
+
+Compression_t DecompressStream::detectCompression( const char* pFilename )
+{
+    unsigned char lMagic[4] = { 0 };
+    size_t lSize = 0;
+
+    FILE* lFile = fopen( pFilename, "rb" );
+    if( lFile )
+    {
+        lSize = fread( lMagic, 1, sizeof( lMagic ), lFile );
+        fclose( lFile );
+    }
+
+    if( lSize >= sizeof( GZIP_MAGIC ) && 0 == memcmp( lMagic, GZIP_MAGIC, sizeof( GZIP_MAGIC ) ) )
+    {
+        return COMPRESSION_GZIP;
+    }
+    if( lSize >= sizeof( ZSTD_MAGIC ) && 0 == memcmp( lMagic, ZSTD_MAGIC, sizeof( ZSTD_MAGIC ) ) )
+    {
+        return COMPRESSION_ZSTD;
+    }
+    return COMPRESSION_NONE;
+}
+
+bool DecompressStream::open( const char* pFilename, size_t pBlockBytes )
+{
+    close();
+
+    mCompression = detectCompression( pFilename );
+    if( COMPRESSION_NONE == mCompression )
+    {
+        return false;
+    }
+
+#ifndef _GRAFCOLOR_HAVE_ZLIB_
+    if( COMPRESSION_GZIP == mCompression )
+    {
+        printf( "%s is gzip compressed, rebuild with _GRAFCOLOR_HAVE_ZLIB_ to read it\n", pFilename );
+        return false;
+    }
+#endif
+#ifndef _GRAFCOLOR_HAVE_ZSTD_
+    if( COMPRESSION_ZSTD == mCompression )
+    {
+        printf( "%s is zstd compressed, rebuild with _GRAFCOLOR_HAVE_ZSTD_ to read it\n", pFilename );
+        return false;
+    }
+#endif
+
+    mFile = fopen( pFilename, "rb" );
+    if( !mFile )
+    {
+        return false;
+    }
+
+    mBlockBytes = pBlockBytes ? pBlockBytes : DECOMPRESS_BLOCK_BYTES;
+    mInput.resize( INPUT_BYTES );
+    if( !mThread.start( &DecompressStream::producerMain, this ) )
+    {
+        printf( "Unable to start the decompression thread\n" );
+        close();
+        return false;
+    }
+    return true;
+}
+
+void DecompressStream::close()
+{
+    if( mThread.isJoinable() )
+    {
+        {
+            ScopedLock lLock( mMutex );
+            mStop = true;
+        }
+        mDrained.notifyAll();
+        mThread.join();
+    }
+
+    if( mFile )
+    {
+        fclose( mFile );
+        mFile = NULL;
+    }
+
+    mCompression = COMPRESSION_NONE;
+    mBlockBytes = 0;
+    std::vector<char>().swap( mInput );
+    mInputSize = 0;
+    mCompressedBytes = 0;
+    mFull.clear();
+    mSpare.clear();
+    mEnd = false;
+    mFailed = false;
+    mStop = false;
+}
+
+bool DecompressStream::read( std::vector<char>& rBlock )
+{
+    ScopedLock lLock( mMutex );
+    while( mFull.empty() && !mEnd )
+    {
+        mFilled.wait( lLock );
+    }
+    if( mFull.empty() )
+    {
+        rBlock.clear();
+        return false;
+    }
+
+    // the caller's old buffer is filled again rather than reallocated
+    rBlock.swap( mFull.front() );
+    if( mFull.front().capacity() )
+    {
+        mSpare.push_back( std::vector<char>() );
+        mSpare.back().swap( mFull.front() );
+    }
+    mFull.pop_front();
+    lLock.unlock();
+
+    mDrained.notifyOne();
+    return true;
+}
+
+void DecompressStream::producerMain( void* pSelf )
+{
+    ( ( DecompressStream* )pSelf )->producerLoop();
+}
+
+void DecompressStream::producerLoop()
+{
+    bool lRet = ( COMPRESSION_GZIP == mCompression ) ? inflateGzip() : inflateZstd();
+
+    {
+        ScopedLock lLock( mMutex );
+        if( !lRet && !mStop )
+        {
+            printf( "Corrupt or truncated %s data\n", getCompressionName( mCompression ) );
+            mFailed = true;
+        }
+        mEnd = true;
+    }
+    mFilled.notifyAll();
+}
+
+bool DecompressStream::readInput()
+{
+    mInputSize = fread( &mInput[0], 1, mInput.size(), mFile );
+    mCompressedBytes += mInputSize;
+    return mInputSize > 0;
+}
+
+bool DecompressStream::pushBlock( std::vector<char>& rBlock, size_t pUsed )
+{
+    rBlock.resize( pUsed );
+
+    ScopedLock lLock( mMutex );
+    while( mFull.size() >= DECOMPRESS_BLOCKS_AHEAD && !mStop )
+    {
+        mDrained.wait( lLock );
+    }
+    if( mStop )
+    {
+        return false;
+    }
+
+    mFull.push_back( std::vector<char>() );
+    mFull.back().swap( rBlock );
+    if( !mSpare.empty() )
+    {
+        rBlock.swap( mSpare.back() );
+        mSpare.pop_back();
+    }
+    lLock.unlock();
+
+    mFilled.notifyOne();
+    rBlock.resize( mBlockBytes );
+    return true;
+}
+
+#ifdef _GRAFCOLOR_HAVE_ZLIB_
+
+bool DecompressStream::inflateGzip()
+{
+    z_stream lStream;
+    memset( &lStream, 0, sizeof( lStream ) );
+
+    // 32 lets zlib take the gzip header
+    if( Z_OK != inflateInit2( &lStream, 15 + 32 ) )
+    {
+        return false;
+    }
+
+    std::vector<char> lBlock( mBlockBytes );
+    size_t lUsed = 0;
+    int lStatus = Z_OK;
+    bool lRet = true;
+
+    // a full block may leave output pending without taking more input
+    bool lOutputFull = false;
+
+    while( lRet )
+    {
+        if( 0 == lStream.avail_in && !lOutputFull )
+        {
+            if( !readInput() )
+            {
+                // the last member has to be complete
+                lRet = ( Z_STREAM_END == lStatus );
+                break;
+            }
+            lStream.next_in = ( Bytef* )&mInput[0];
+            lStream.avail_in = ( uInt )mInputSize;
+        }
+
+        // concatenated members, as gzip writes them, are read on
+        if( Z_STREAM_END == lStatus && lStream.avail_in )
+        {
+            inflateReset( &lStream );
+        }
+
+        lStream.next_out = ( Bytef* )&lBlock[lUsed];
+        lStream.avail_out = ( uInt )( lBlock.size() - lUsed );
+        int lResult = inflate( &lStream, Z_NO_FLUSH );
+
+        // nothing was pending after all
+        if( Z_BUF_ERROR == lResult && lOutputFull )
+        {
+            lOutputFull = false;
+            continue;
+        }
+        if( Z_OK != lResult && Z_STREAM_END != lResult )
+        {
+            lRet = false;
+            break;
+        }
+        lStatus = lResult;
+
+        lUsed = lBlock.size() - lStream.avail_out;
+        lOutputFull = ( lUsed == lBlock.size() );
+        if( lOutputFull )
+        {
+            lRet = pushBlock( lBlock, lUsed );
+            lUsed = 0;
+        }
+    }
+
+    if( lRet && lUsed )
+    {
+        lRet = pushBlock( lBlock, lUsed );
+    }
+
+    inflateEnd( &lStream );
+    return lRet;
+}
+
+#else
+
+bool DecompressStream::inflateGzip()
+{
+    return false;
+}
+
+#endif
+
+#ifdef _GRAFCOLOR_HAVE_ZSTD_
+
+bool DecompressStream::inflateZstd()
+{
+    ZSTD_DStream* lStream = ZSTD_createDStream();
+    if( !lStream )
+    {
+        return false;
+    }
+    ZSTD_initDStream( lStream );
+
+    std::vector<char> lBlock( mBlockBytes );
+    size_t lUsed = 0;
+    ZSTD_inBuffer lInput = { NULL, 0, 0 };
+
+    // 0 once a frame is complete, the next frame starts fresh
+    size_t lStatus = 0;
+    bool lRet = true;
+
+    // a full block may leave output pending without taking more input
+    bool lOutputFull = false;
+
+    while( lRet )
+    {
+        if( lInput.pos == lInput.size && !lOutputFull )
+        {
+            if( !readInput() )
+            {
+                lRet = ( 0 == lStatus );
+                break;
+            }
+            lInput.src = &mInput[0];
+            lInput.size = mInputSize;
+            lInput.pos = 0;
+        }
+
+        ZSTD_outBuffer lOutput = { &lBlock[0], lBlock.size(), lUsed };
+        lStatus = ZSTD_decompressStream( lStream, &lOutput, &lInput );
+        if( ZSTD_isError( lStatus ) )
+        {
+            lRet = false;
+            break;
+        }
+
+        lUsed = lOutput.pos;
+        lOutputFull = ( lUsed == lBlock.size() );
+        if( lOutputFull )
+        {
+            lRet = pushBlock( lBlock, lUsed );
+            lUsed = 0;
+        }
+    }
+
+    if( lRet && lUsed )
+    {
+        lRet = pushBlock( lBlock, lUsed );
+    }
+
+    ZSTD_freeDStream( lStream );
+    return lRet;
+}
+
+#else
+
+bool DecompressStream::inflateZstd()
+{
+    return false;
+}
+
+#endif
+
+// end of file
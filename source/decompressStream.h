@@ -0,0 +1,103 @@
+#ifndef _DECOMPRESS_STREAM_H_
+#define _DECOMPRESS_STREAM_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include "hostPlatform.h"
+
+// Decompressed bytes a block holds, and how many full blocks the background
+// thread may get ahead of the reader. Together with the block the reader
+// holds and the one being filled they bound the memory of a stream.
+#define DECOMPRESS_BLOCK_BYTES ( 16 * 1024 * 1024 )
+#define DECOMPRESS_BLOCKS_AHEAD 2
+
+enum Compression_t
+{
+    COMPRESSION_NONE,
+    COMPRESSION_GZIP,
+    COMPRESSION_ZSTD
+};
+
+// Reads a gzip or zstd file as a sequence of decompressed blocks. A
+// background thread inflates the file while the caller works on the
+// previous block. Block boundaries fall anywhere, lines included.
+//
+// The codecs are compiled in with _GRAFCOLOR_HAVE_ZLIB_ (link zlib) and
+// _GRAFCOLOR_HAVE_ZSTD_ (link libzstd); without them open() refuses the
+// format with a message.
+class DecompressStream
+{
+public:
+    DecompressStream();
+    ~DecompressStream();
+
+    // The format from the magic bytes of the file
+    static Compression_t detectCompression( const char* pFilename );
+
+    static bool isCompressed( const char* pFilename )
+    {
+        return COMPRESSION_NONE != detectCompression( pFilename );
+    }
+
+    // Starts decompressing pFilename. False if the file is not compressed,
+    // cannot be read, or its codec was not compiled in.
+    bool open( const char* pFilename, size_t pBlockBytes = DECOMPRESS_BLOCK_BYTES );
+
+    void close();
+
+    // Waits for the next block and swaps it into rBlock, whose old buffer
+    // goes back to the background thread. False, with rBlock emptied, at the
+    // end of the data or on a decompression error, see hasFailed().
+    bool read( std::vector<char>& rBlock );
+
+    bool hasFailed() const
+    {
+        return mFailed;
+    }
+
+    // Compressed bytes consumed so far
+    size_t getCompressedBytes() const
+    {
+        return mCompressedBytes;
+    }
+
+private:
+    // not copyable, owns the thread
+    DecompressStream( const DecompressStream& );
+    DecompressStream& operator= ( const DecompressStream& );
+
+    static void producerMain( void* pSelf );
+    void producerLoop();
+    bool inflateGzip();
+    bool inflateZstd();
+
+    // Fills mInput from the file, false at the end of the file
+    bool readInput();
+
+    // Queues the first pUsed bytes of rBlock and hands back an empty block
+    // to fill. False if the reader closed the stream.
+    bool pushBlock( std::vector<char>& rBlock, size_t pUsed );
+
+    FILE* mFile;
+    Compression_t mCompression;
+    size_t mBlockBytes;
+
+    std::vector<char> mInput;
+    size_t mInputSize;
+    size_t mCompressedBytes;
+
+    Thread mThread;
+    Mutex mMutex;
+    ConditionVariable mFilled;
+    ConditionVariable mDrained;
+    std::deque< std::vector<char> > mFull;
+    std::vector< std::vector<char> > mSpare;
+    bool mEnd;
+    bool mFailed;
+    bool mStop;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include <cstdio>
+
+#include "deviceSetup.h"
+#include "utils.h"
+#include "parallelUtils.h"
+
+DeviceSetup::DeviceSetup()
+    : mHasRequest( false )
+    , mFinishing( false )
+    , mStarted( false )
+    , mDeviceReady( false )
+    , mKernelReady( false )
+    , mFinished( false )
+    , mInitMs( 0 )
+    , mBackgroundBuildMs( 0 )
+    , mRebuildMs( 0 )
+    , mWaitMs( 0 )
+    , mDevice( NULL )
+    , mContext( NULL )
+    , mCommands( NULL )
+    , mProgram( NULL )
+    , mKernel( NULL )
+{
+}
+
+DeviceSetup::~DeviceSetup()
+{
+    join();
+
+    releaseKernel();
+    if( mCommands )
+    {
+        clReleaseCommandQueue( mCommands );
+    }
+    if( mContext )
+    {
+        clReleaseContext( mContext );
+    }
+}
+
+void DeviceSetup::start()
+{
+    if( !mStarted )
+    {
+        mStarted = true;
+        if( !mThread.start( &DeviceSetup::setupMain, this ) )
+        {
+            printf( "Unable to start the device setup thread\n" );
+        }
+    }
+}
+
+void DeviceSetup::requestKernel( const char* pKernelFile, const char* pKernelName, const std::string& rOptions )
+{
+    {
+        ScopedLock lLock( mMutex );
+        if( mHasRequest || mFinishing )
+        {
+            return;
+        }
+        mRequestFile = pKernelFile;
+        mRequestName = pKernelName;
+        mRequestOptions = rOptions;
+        mHasRequest = true;
+    }
+    mRequested.notifyOne();
+}
+
+void DeviceSetup::setupMain( void* pSelf )
+{
+    ( ( DeviceSetup* )pSelf )->setupLoop();
+}
+
+void DeviceSetup::setupLoop()
+{
+    WallTimer lTimer;
+    if( !initOCL( mDevice, mContext, mCommands ) )
+    {
+        return;
+    }
+    mInitMs = lTimer.getElapsedMs();
+    mDeviceReady = true;
+
+    std::string lFile;
+    std::string lName;
+    std::string lOptions;
+    {
+        ScopedLock lLock( mMutex );
+        while( !mHasRequest && !mFinishing )
+        {
+            mRequested.wait( lLock );
+        }
+        if( !mHasRequest )
+        {
+            return;
+        }
+        lFile = mRequestFile;
+        lName = mRequestName;
+        lOptions = mRequestOptions;
+    }
+
+    WallTimer lBuildTimer;
+    buildKernel( lFile, lName, lOptions );
+    mBackgroundBuildMs = lBuildTimer.getElapsedMs();
+}
+
+bool DeviceSetup::buildKernel( const std::string& rFile, const std::string& rName, const std::string& rOptions )
+{
+    releaseKernel();
+
+    mBuiltFile = rFile;
+    mBuiltName = rName;
+    mBuiltOptions = rOptions;
+    mKernelReady = createKernelFromSource( rFile.c_str(), mDevice, mContext, mProgram, mCommands, mKernel,
+                                           rName.c_str(), rOptions.c_str() );
+    return mKernelReady;
+}
+
+void DeviceSetup::join()
+{
+    if( !mThread.isJoinable() )
+    {
+        return;
+    }
+
+    {
+        ScopedLock lLock( mMutex );
+        mFinishing = true;
+    }
+    mRequested.notifyOne();
+    mThread.join();
+}
+
+void DeviceSetup::releaseKernel()
+{
+    if( mKernel )
+    {
+        clReleaseKernel( mKernel );
+        mKernel = NULL;
+    }
+    if( mProgram )
+    {
+        clReleaseProgram( mProgram );
+        mProgram = NULL;
+    }
+    mKernelReady = false;
+}
+
+void DeviceSetup::selectKernel( const char* pKernelFile, const char* pKernelName, const std::string& rOptions )
+{
+    mSelectedFile = pKernelFile;
+    mSelectedName = pKernelName;
+    mSelectedOptions = rOptions;
+}
+
+bool DeviceSetup::finish()
+{
+    if( mFinished )
+    {
+        return mKernelReady;
+    }
+    mFinished = true;
+
+    WallTimer lWaitTimer;
+    join();
+    mWaitMs = lWaitTimer.getElapsedMs();
+
+    if( !mDeviceReady )
+    {
+        // never started, set up now
+        if( mStarted || !initOCL( mDevice, mContext, mCommands ) )
+        {
+            return false;
+        }
+        mInitMs = lWaitTimer.getElapsedMs();
+        mWaitMs = mInitMs;
+        mDeviceReady = true;
+    }
+
+    if( mKernelReady && mBuiltFile == mSelectedFile && mBuiltName == mSelectedName && mBuiltOptions == mSelectedOptions )
+    {
+        return true;
+    }
+
+    // the guess was off, or nothing was requested in time
+    WallTimer lBuildTimer;
+    bool lRet = buildKernel( mSelectedFile, mSelectedName, mSelectedOptions );
+    mRebuildMs = lBuildTimer.getElapsedMs();
+    return lRet;
+}
+
+void DeviceSetup::cancel()
+{
+    join();
+    mFinished = true;
+
+    releaseKernel();
+    if( mCommands )
+    {
+        clReleaseCommandQueue( mCommands );
+        mCommands = NULL;
+    }
+    if( mContext )
+    {
+        clReleaseContext( mContext );
+        mContext = NULL;
+    }
+    mDeviceReady = false;
+}
+
+void DeviceSetup::printTimes() const
+{
+    double lBackgroundMs = mInitMs + mBackgroundBuildMs;
+    double lHiddenMs = ( lBackgroundMs > mWaitMs ) ? lBackgroundMs - mWaitMs : 0;
+
+    printf( "Device setup: context %.2f ms, kernel build %.2f ms", mInitMs, mBackgroundBuildMs );
+    if( mRebuildMs > 0 )
+    {
+        printf( " + %.2f ms rebuilt after the load", mRebuildMs );
+    }
+    printf( ", waited %.2f ms, %.2f ms overlapped with the host stages\n", mWaitMs, lHiddenMs );
+}
+
+// end of file
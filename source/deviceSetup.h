@@ -0,0 +1,121 @@
+#ifndef _DEVICE_SETUP_H_
+#define _DEVICE_SETUP_H_
+
+#include <string>
+
+#include <CL/cl.h>
+
+#include "hostPlatform.h"
+
+// Brings the OpenCL device up on a background thread while the host loads
+// and preprocesses the graph: the context and queue right away, then the
+// kernel once requestKernel() names it. The build options carry the id
+// width, which is final only once the graph is loaded, so the request is
+// a guess; finish() rebuilds if the kernel selectKernel() names differs.
+class DeviceSetup
+{
+public:
+    DeviceSetup();
+
+    // Waits for the background thread and releases the OpenCL objects
+    ~DeviceSetup();
+
+    // Starts creating the context and queue
+    void start();
+
+    // Kernel to build as soon as the context is up. Only the first request
+    // is built in the background.
+    void requestKernel( const char* pKernelFile, const char* pKernelName, const std::string& rOptions );
+
+    // The kernel the run uses, known once the graph is loaded and planned
+    void selectKernel( const char* pKernelFile, const char* pKernelName, const std::string& rOptions );
+
+    // Waits for the background work and makes sure the kernel built is the
+    // one selected, building it now otherwise. Called by the device paths
+    // right before they need the kernel, so everything the host does until
+    // then overlaps the setup. False if the device or the kernel could not
+    // be set up.
+    bool finish();
+
+    // The run turned out to need no device: waits for the background work
+    // and releases whatever it set up. finish() fails afterwards.
+    void cancel();
+
+    // Stage times and how much of them the host work hid
+    void printTimes() const;
+
+    cl_device_id& getDevice()
+    {
+        return mDevice;
+    }
+
+    cl_context& getContext()
+    {
+        return mContext;
+    }
+
+    cl_command_queue& getCommands()
+    {
+        return mCommands;
+    }
+
+    cl_program& getProgram()
+    {
+        return mProgram;
+    }
+
+    cl_kernel& getKernel()
+    {
+        return mKernel;
+    }
+
+private:
+    // not copyable, owns the thread and the OpenCL objects
+    DeviceSetup( const DeviceSetup& );
+    DeviceSetup& operator= ( const DeviceSetup& );
+
+    static void setupMain( void* pSelf );
+    void setupLoop();
+    bool buildKernel( const std::string& rFile, const std::string& rName, const std::string& rOptions );
+    void join();
+    void releaseKernel();
+
+    Thread mThread;
+    Mutex mMutex;
+    ConditionVariable mRequested;
+
+    // pending request, taken by the background thread
+    std::string mRequestFile;
+    std::string mRequestName;
+    std::string mRequestOptions;
+    bool mHasRequest;
+    bool mFinishing;
+    bool mStarted;
+
+    // kernel the run uses
+    std::string mSelectedFile;
+    std::string mSelectedName;
+    std::string mSelectedOptions;
+
+    // kernel built so far
+    std::string mBuiltFile;
+    std::string mBuiltName;
+    std::string mBuiltOptions;
+
+    bool mDeviceReady;
+    bool mKernelReady;
+    bool mFinished;
+
+    double mInitMs;
+    double mBackgroundBuildMs;
+    double mRebuildMs;
+    double mWaitMs;
+
+    cl_device_id mDevice;
+    cl_context mContext;
+    cl_command_queue mCommands;
+    cl_program mProgram;
+    cl_kernel mKernel;
+};
+
+#endif
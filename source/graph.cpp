@@ -1,7 +1,10 @@
 #include <string>
 #include <algorithm>
 #include <ostream>
+#include <iterator>
 #include <cmath>
+#include <cstring>
+#include <cstdio>
 
 #ifdef _DEBUG
 #include <iostream>
@@ -9,24 +12,14 @@
 
 #include "graph.h"
 #include "defines.h"
-#include "nonAdjacencyNode.h"
-
-struct VertexIdGenerator
-{
-    VertexIdGenerator() : mCurrId( 0 )
-    {}
-
-    Graph::vertexId_t operator() ()
-    {
-        return mCurrId++;
-    }
-    
-    Graph::vertexId_t mCurrId;
-};
+#include "bitMatrix.h"
+#include "triangularBitMatrix.h"
+#include "parallelUtils.h"
 
+template< typename GraphT >
 struct GraphPrinter
 {
-    GraphPrinter( const Graph& pGraph, std::ostream& pOutStream ) 
+    GraphPrinter( const GraphT& pGraph, std::ostream& pOutStream ) 
                 : mGraph( pGraph ), mOutStream( pOutStream )
     {}
 
@@ -34,270 +27,507 @@ struct GraphPrinter
     {
         mOutStream << pNodeName << " " << std::endl;
 
-        Graph::vertexId_t lId = 0;
+        typename GraphT::vertexId_t lId = 0;
         if( mGraph.getId( pNodeName, lId ) )
         {
-            Graph::idSet_t lList;
-            if( mGraph.getAdjacencyList( lId, lList ) )
-            {
-                std::copy( lList.begin(), 
-                           lList.end(),  
-                           std::ostream_iterator<Graph::vertexId_t>( mOutStream, " | " ) );
-                mOutStream << std::endl;
-            }
+            typename GraphT::NeighborRange lList = mGraph.getNeighbors( lId );
+            std::copy( lList.begin(), 
+                       lList.end(),  
+                       std::ostream_iterator<typename GraphT::vertexId_t>( mOutStream, " | " ) );
+            mOutStream << std::endl;
         }
     }
-    const Graph& mGraph;
+    const GraphT& mGraph;
     std::ostream& mOutStream;
 };
 
+// Fills the rows [pBegin, pEnd) of a dense or bit adjacency matrix. Rows are
+// independent, so disjoint ranges may be filled concurrently; for the bit
+// matrix the ranges must start on a multiple of 8 rows so that no two of
+// them share a byte.
+template< typename GraphT >
 struct CreateAdjacencyMatrix
 {
-    CreateAdjacencyMatrix( Graph::vertexId_t* pVertexMatrix, const Graph& pGraph )
+    CreateAdjacencyMatrix( typename GraphT::vertexId_t* pVertexMatrix, const GraphT& pGraph )
         : mMatrix( pVertexMatrix )
+        , mBitMatrix( NULL )
         , mGraph( pGraph )
-        , mCurrIdx( 0 )
         , mIsBitMatrix( false )
     {
         mNumVertices = mGraph.size();
     }
 
     // BitMatrix overloaded ctor
-    CreateAdjacencyMatrix( Graph::byte_t* pBitMatrix, const Graph& pGraph )
-        : mBitMatrix( pBitMatrix )
+    CreateAdjacencyMatrix( typename GraphT::byte_t* pBitMatrix, const GraphT& pGraph )
+        : mMatrix( NULL )
+        , mBitMatrix( pBitMatrix )
         , mGraph( pGraph )
-        , mCurrIdx( 0 )
         , mIsBitMatrix( true )
     {
         mNumVertices = mGraph.size();
     }
 
-    void operator() ( const Graph::idSet_t& pList )
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
     {
-        size_t lOffset = mCurrIdx * mNumVertices;
-        for( Graph::idSetConstIter_t lIter = pList.begin();
-            lIter != pList.end();
-            ++lIter )
+        for( size_t lRow = pBegin; lRow < pEnd; ++lRow )
         {
-            Graph::vertexId_t lVertexId = *lIter;
-            size_t lIdx = lOffset + lVertexId;
-            if( mIsBitMatrix )
+            size_t lOffset = lRow * mNumVertices;
+            typename GraphT::NeighborRange lList = mGraph.getNeighbors( ( typename GraphT::vertexId_t )lRow );
+            for( typename GraphT::idSetConstIter_t lIter = lList.begin();
+                lIter != lList.end();
+                ++lIter )
             {
-                Graph::setBit( mBitMatrix, lIdx, true );
-            }
-            else
-            {
-                mMatrix[lIdx] = 1;
+                typename GraphT::vertexId_t lVertexId = *lIter;
+                size_t lIdx = lOffset + lVertexId;
+                if( mIsBitMatrix )
+                {
+                    GraphT::setBit( mBitMatrix, lIdx, true );
+                }
+                else
+                {
+                    mMatrix[lIdx] = 1;
+                }
             }
         }
-        ++mCurrIdx;
     }
 
 private:
-    const Graph& mGraph;
-    size_t mNumVertices;
-    
-    Graph::vertexId_t* mMatrix;
-    Graph::byte_t* mBitMatrix;
+    typename GraphT::vertexId_t* mMatrix;
+    typename GraphT::byte_t* mBitMatrix;
 
-    size_t mCurrIdx;
+    const GraphT& mGraph;
+    size_t mNumVertices;
     bool mIsBitMatrix;
 };
 
-struct LesserDegree
+template< typename GraphT >
+struct CreateRowAlignedAdjacencyMatrix
 {
-    LesserDegree( const Graph& rGraph ) 
-                : mGraph( rGraph ) 
-                , mDegrees( rGraph.size() )
-    {
-        loadDegrees();
-    }
+    CreateRowAlignedAdjacencyMatrix( BitMatrix& rMatrix, const GraphT& pGraph )
+        : mMatrix( rMatrix ), mGraph( pGraph )
+    {}
 
-    void loadDegrees()
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
     {
-        for( Graph::vertexId_t v = 0; v < mGraph.size(); ++v )
+        for( size_t lRow = pBegin; lRow < pEnd; ++lRow )
         {
-            mGraph.getDegree( v, mDegrees[v] );
+            typename GraphT::NeighborRange lList = mGraph.getNeighbors( ( typename GraphT::vertexId_t )lRow );
+            for( typename GraphT::idSetConstIter_t lIter = lList.begin(); lIter != lList.end(); ++lIter )
+            {
+                mMatrix.set( lRow, *lIter );
+            }
         }
     }
 
-    bool operator() ( Graph::vertexId_t& rVertex1, Graph::vertexId_t& rVertex2 )
+private:
+    BitMatrix& mMatrix;
+    const GraphT& mGraph;
+};
+
+template< typename GraphT >
+struct LesserDegree
+{
+    LesserDegree( const GraphT& rGraph ) 
+                : mDegrees( rGraph.getDegrees() )
+    {
+    }
+
+    // Id may be narrower or wider than the graph ids
+    template< typename Id >
+    bool operator() ( const Id& rVertex1, const Id& rVertex2 ) const
     {
         return ( mDegrees[rVertex1] < mDegrees[rVertex2] );
     }
 
 private:
-    const Graph& mGraph;
-    std::vector<size_t> mDegrees;
+    const typename GraphT::degreeVec_t& mDegrees;
 };
 
-struct CreateNonAdjacencyListArray
+template< typename GraphT >
+struct CreateNonAdjacencyMatrix
 {
-    CreateNonAdjacencyListArray( const Graph::idVec_t& pVertices, 
-                                 NonAdjacencyNode_t* pAdjListArray, 
-                                 const Graph& pGraph )
-        : mVertices( pVertices ) 
-        , mAdjListArray( pAdjListArray )
+    CreateNonAdjacencyMatrix( typename GraphT::vertexId_t* pVertexMatrix, const GraphT& pGraph )
+        : mMatrix( pVertexMatrix )
         , mGraph( pGraph )
-        , mCurrIdx( 0 )
         , mLesserDegreeSorter( pGraph )
-    {}
-
-    void operator() ( const Graph::idSet_t& pList )
+        , mScratch( ThreadPool::instance().getNumThreads() )
     {
-        // compute the non adjacent nodes
-        Graph::idVec_t lDifference( mGraph.size() );
-        Graph::idVec_t::iterator lResult = std::set_difference( mVertices.begin(), 
-                                                                mVertices.end(), 
-                                                                pList.begin(), 
-                                                                pList.end(), 
-                                                                lDifference.begin() );
+        mNumVertices = mGraph.size();
+        mVertices.reserve( mNumVertices );
+
+        for( typename GraphT::vertexId_t v = 0; v < mNumVertices; ++v )
+        {
+            mVertices.push_back( v );
+        }
+    }
 
-        size_t lNumElems = lResult - lDifference.begin();
+    void operator() ( size_t pBegin, size_t pEnd, size_t pThreadIdx )
+    {
+        typename GraphT::idVec_t& rDifference = mScratch[pThreadIdx];
+        rDifference.resize( mNumVertices );
 
-        if( lNumElems )
+        for( size_t lRow = pBegin; lRow < pEnd; ++lRow )
         {
-            std::sort( lDifference.begin(), lResult, mLesserDegreeSorter );
+            size_t lStart = lRow * ( mNumVertices + 1 );
+            typename GraphT::NeighborRange lList = mGraph.getNeighbors( ( typename GraphT::vertexId_t )lRow );
+
+            // compute the non adjacent nodes
+            typename GraphT::idVec_t::iterator lResult = std::set_difference( mVertices.begin(), 
+                                                                    mVertices.end(), 
+                                                                    lList.begin(), 
+                                                                    lList.end(), 
+                                                                    rDifference.begin() );
+
+            size_t lNumElems = lResult - rDifference.begin();
 
-            NonAdjacencyNode_t* lNode = &mAdjListArray[mCurrIdx];
-            lNode->mNumElems = lNumElems;
-            lNode->mNodes = new Graph::vertexId_t[lNumElems];
-            std::copy( lDifference.begin(), lResult, lNode->mNodes );
+            if( lNumElems )
+            {
+                std::sort( rDifference.begin(), lResult, mLesserDegreeSorter );
+                mMatrix[lStart] = lNumElems;
+                std::copy( rDifference.begin(), lResult, mMatrix + lStart + 1 );
+            }
         }
-        ++mCurrIdx;
     }
 
 private:
-    const Graph& mGraph;
+    typename GraphT::vertexId_t* mMatrix;
+    const GraphT& mGraph;
     size_t mNumVertices;
-    NonAdjacencyNode_t* mAdjListArray;
-    size_t mCurrIdx;
-    const Graph::idVec_t& mVertices;
-    LesserDegree mLesserDegreeSorter;
+    typename GraphT::idVec_t mVertices;
+    LesserDegree<GraphT> mLesserDegreeSorter;
+    std::vector<typename GraphT::idVec_t> mScratch;
 };
 
-struct CreateNonAdjacencyMatrix
+// Writes the size of the non adjacency list of every vertex. A vertex is
+// non adjacent to every vertex but its neighbors, itself included.
+template< typename GraphT, typename OffsetT >
+struct CountNonAdjacencyElems
 {
-    CreateNonAdjacencyMatrix( Graph::vertexId_t* pVertexMatrix, const Graph& pGraph )
-        : mMatrix( pVertexMatrix ), mGraph( pGraph ), mCurrIdx( 0 )
-    {
-        mNumVertices = mGraph.size();
-        mVertices.reserve( mNumVertices );
+    CountNonAdjacencyElems( const GraphT& pGraph, OffsetT* pCounts )
+        : mGraph( pGraph ), mCounts( pCounts )
+    {}
 
-        for( Graph::vertexId_t v = 0; v < mNumVertices; ++v )
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
         {
-            mVertices.push_back( v );
+            mCounts[lIdx] = ( OffsetT )( mGraph.size() - mGraph.getDegree( ( typename GraphT::vertexId_t )lIdx ) );
         }
     }
 
-    void operator() ( const Graph::idSet_t& pList )
+private:
+    const GraphT& mGraph;
+    OffsetT* mCounts;
+};
+
+// Writes the non adjacency list of the rows [pBegin, pEnd) straight to
+// their offsets in the stream and sorts them there
+template< typename GraphT, typename StreamId, typename OffsetT >
+struct CreateNonAdjacencyStream
+{
+    CreateNonAdjacencyStream( const GraphT& pGraph,
+                              const OffsetT* pOffsets,
+                              StreamId* pStream )
+        : mGraph( pGraph )
+        , mOffsets( pOffsets )
+        , mStream( pStream )
+        , mLesserDegreeSorter( pGraph )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
     {
-        size_t lStart = mCurrIdx * ( mNumVertices + 1 );
-        size_t lEnd = lStart + mNumVertices + 1;
+        size_t lNumVertices = mGraph.size();
+
+        for( size_t lRow = pBegin; lRow < pEnd; ++lRow )
+        {
+            typename GraphT::NeighborRange lList = mGraph.getNeighbors( ( typename GraphT::vertexId_t )lRow );
+            typename GraphT::idSetConstIter_t lNeighbor = lList.begin();
+
+            // every id that is not a neighbor, in ascending order
+            StreamId* lBegin = mStream + mOffsets[lRow];
+            StreamId* lOut = lBegin;
+            for( size_t v = 0; v < lNumVertices; ++v )
+            {
+                if( lNeighbor != lList.end() && *lNeighbor == v )
+                {
+                    ++lNeighbor;
+                }
+                else
+                {
+                    *lOut++ = ( StreamId )v;
+                }
+            }
 
-        // compute the non adjacent nodes
-        Graph::idVec_t lDifference( mNumVertices );
-        Graph::idVec_t::iterator lResult = std::set_difference( mVertices.begin(), 
-                                                                mVertices.end(), 
-                                                                pList.begin(), 
-                                                                pList.end(), 
-                                                                lDifference.begin() );
+            std::sort( lBegin, lOut, mLesserDegreeSorter );
+        }
+    }
 
-        size_t lNumElems = lResult - lDifference.begin();
+private:
+    const GraphT& mGraph;
+    const OffsetT* mOffsets;
+    StreamId* mStream;
+    LesserDegree<GraphT> mLesserDegreeSorter;
+};
+
+// Counts, per block of pBlockSize edges, the edges that are not self
+// loops, and flags the blocks holding an id outside the graph
+template< typename GraphT >
+struct CountBulkArcs
+{
+    CountBulkArcs( const GraphT& pGraph,
+                   const typename GraphT::idPair_t* pEdges,
+                   size_t pBlockSize,
+                   std::vector<size_t>& rCounts,
+                   std::vector<char>& rInvalid )
+        : mGraph( pGraph ), mEdges( pEdges ), mBlockSize( pBlockSize ), mCounts( rCounts ), mInvalid( rInvalid )
+    {}
 
-        if( lNumElems )
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        size_t lCount = 0;
+        bool lInvalid = false;
+        for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
         {
-            std::sort( lDifference.begin(), lResult, LesserDegree( mGraph ) );
-            std::fill( mMatrix + lStart, mMatrix + lEnd, 0 );
-            mMatrix[lStart] = lNumElems;
-            std::copy( lDifference.begin(), lResult, mMatrix + lStart + 1 );
+            const typename GraphT::idPair_t& rEdge = mEdges[lIdx];
+            lInvalid = lInvalid || !mGraph.isValidId( rEdge.first ) || !mGraph.isValidId( rEdge.second );
+            lCount += ( rEdge.first != rEdge.second );
         }
-        ++mCurrIdx;
+        mCounts[pBegin / mBlockSize] = lCount;
+        mInvalid[pBegin / mBlockSize] = lInvalid;
     }
 
 private:
-    const Graph& mGraph;
-    size_t mNumVertices;
-    Graph::vertexId_t* mMatrix;
-    size_t mCurrIdx;
-    Graph::idVec_t mVertices;
+    const GraphT& mGraph;
+    const typename GraphT::idPair_t* mEdges;
+    size_t mBlockSize;
+    std::vector<size_t>& mCounts;
+    std::vector<char>& mInvalid;
 };
 
-struct CopyKey
+// Writes both directions of every edge that is not a self loop, each block
+// starting at twice its scanned count
+template< typename GraphT >
+struct CreateBulkArcs
 {
-    CopyKey( Graph::stringSet_t& rDest ) : mDest( rDest ) {}
+    CreateBulkArcs( const typename GraphT::idPair_t* pEdges,
+                    size_t pBlockSize,
+                    const std::vector<size_t>& rOffsets,
+                    typename GraphT::idPair_t* pArcs )
+        : mEdges( pEdges ), mBlockSize( pBlockSize ), mOffsets( rOffsets ), mArcs( pArcs )
+    {}
 
-    void operator () ( const Graph::string2IdPair_t& rSource )
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
     {
-        mDest.insert( rSource.first );
+        typename GraphT::idPair_t* lOut = mArcs + 2 * mOffsets[pBegin / mBlockSize];
+        for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+        {
+            const typename GraphT::idPair_t& rEdge = mEdges[lIdx];
+            if( rEdge.first != rEdge.second )
+            {
+                *lOut++ = rEdge;
+                *lOut++ = typename GraphT::idPair_t( rEdge.second, rEdge.first );
+            }
+        }
     }
 
-    Graph::stringSet_t& mDest;
+private:
+    const typename GraphT::idPair_t* mEdges;
+    size_t mBlockSize;
+    const std::vector<size_t>& mOffsets;
+    typename GraphT::idPair_t* mArcs;
 };
 
-const char Graph::COMMENT_CHAR = '#';
-const int Graph::MAX_LINE_SIZE = 256;
-const int Graph::BYTE_SIZE = 8;
+template< typename IdPair >
+struct ArcSourceLess
+{
+    bool operator() ( const IdPair& rArc, size_t pSource ) const
+    {
+        return ( rArc.first < pSource );
+    }
+};
 
-Graph::Graph()
+// Merges the sorted arcs of the vertices [pBegin, pEnd) into their
+// adjacency sets and degrees. An empty set is built from its run in one
+// pass, a set that has neighbors already takes the run by hinted inserts.
+// With pNewFlags set, every arc that became a new edge ( first < second )
+// is flagged for the edge list.
+template< typename GraphT >
+struct InsertBulkArcs
 {
-}
+    InsertBulkArcs( const std::vector<typename GraphT::idPair_t>& rArcs,
+                    typename GraphT::idSetStore_t& rAdjacencyLists,
+                    typename GraphT::degreeVec_t& rDegrees,
+                    char* pNewFlags )
+        : mArcs( rArcs ), mAdjacencyLists( rAdjacencyLists ), mDegrees( rDegrees ), mNewFlags( pNewFlags )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        size_t lArc = std::lower_bound( mArcs.begin(), mArcs.end(), pBegin,
+                                        ArcSourceLess<typename GraphT::idPair_t>() ) - mArcs.begin();
+
+        typename GraphT::idVec_t lRow;
+        while( lArc < mArcs.size() && mArcs[lArc].first < pEnd )
+        {
+            typename GraphT::vertexId_t lSource = mArcs[lArc].first;
+            typename GraphT::idSet_t& rSet = mAdjacencyLists[lSource];
+
+            size_t lRunEnd = lArc;
+            while( lRunEnd < mArcs.size() && mArcs[lRunEnd].first == lSource )
+            {
+                ++lRunEnd;
+            }
+
+            if( rSet.empty() )
+            {
+                // a new row is the run without its repeats, which sit next
+                // to each other, and is built in one pass
+                lRow.clear();
+                for( ; lArc < lRunEnd; ++lArc )
+                {
+                    if( lRow.empty() || lRow.back() != mArcs[lArc].second )
+                    {
+                        lRow.push_back( mArcs[lArc].second );
+                        flagNew( lArc );
+                    }
+                }
 
-Graph::Graph( size_t pNumVertices )
+                typename GraphT::idSet_t lSet( lRow.begin(), lRow.end() );
+                rSet.swap( lSet );
+                mDegrees[lSource] = rSet.size();
+                continue;
+            }
+
+            // rows that already have neighbors take the run one id at a
+            // time; the run is sorted, so a new id usually goes last
+            for( ; lArc < lRunEnd; ++lArc )
+            {
+                size_t lOldSize = rSet.size();
+                rSet.insert( rSet.end(), mArcs[lArc].second );
+                if( rSet.size() != lOldSize )
+                {
+                    ++mDegrees[lSource];
+                    flagNew( lArc );
+                }
+            }
+        }
+    }
+
+private:
+    // the edge list keeps every new edge once, from its lower end
+    void flagNew( size_t pArc )
+    {
+        if( mNewFlags && mArcs[pArc].first < mArcs[pArc].second )
+        {
+            mNewFlags[pArc] = 1;
+        }
+    }
+
+    const std::vector<typename GraphT::idPair_t>& mArcs;
+    typename GraphT::idSetStore_t& mAdjacencyLists;
+    typename GraphT::degreeVec_t& mDegrees;
+    char* mNewFlags;
+};
+
+template< typename VertexId >
+const char BasicGraph<VertexId>::COMMENT_CHAR = '#';
+template< typename VertexId >
+const int BasicGraph<VertexId>::MAX_LINE_SIZE = 256;
+template< typename VertexId >
+const int BasicGraph<VertexId>::BYTE_SIZE = 8;
+
+template< typename VertexId >
+BasicGraph<VertexId>::BasicGraph()
+    : mNumNumbered( 0 )
+    , mFirstLabel( 0 )
+    , mKeepEdgeList( true )
+    , mMaxDegree( 0 )
 {
 }
 
-bool Graph::getVertexNames( Graph::stringSet_t& rNames ) const
+template< typename VertexId >
+bool BasicGraph<VertexId>::getVertexNames( stringSet_t& rNames ) const
 {
     bool lRet = false;
 
     if( !empty() )
     {
-        std::for_each( mVertexName2IdMap.begin(),
-                       mVertexName2IdMap.end(),
-                       CopyKey( rNames ) );
+        std::string lName;
+        for( vertexId_t lId = 0; lId < size(); ++lId )
+        {
+            getName( lId, lName );
+            rNames.insert( lName );
+        }
         lRet = true;
     }
 
     return lRet;
 }
 
-bool Graph::getId( const std::string& pVertexName, Graph::vertexId_t& rVertexId ) const
+template< typename VertexId >
+bool BasicGraph<VertexId>::getId( const std::string& pVertexName, vertexId_t& rVertexId ) const
 {
-    bool lRet = false;
-    rVertexId = 0;
-
-    if( !mVertexName2IdMap.empty() )
+    if( isNumbered() )
     {
-        string2IdMapConstIter_t lIter = mVertexName2IdMap.find( pVertexName );
-        if( lIter != mVertexName2IdMap.end() )
+        // plain decimal digits only, as getName writes them
+        const char* lDigits = pVertexName.c_str();
+        char* lEnd = NULL;
+        unsigned long long lLabel = strtoull( lDigits, &lEnd, 10 );
+        rVertexId = 0;
+        if( pVertexName.empty() || *lEnd || !( '0' <= lDigits[0] && lDigits[0] <= '9' ) )
         {
-            rVertexId = lIter->second;
-            lRet = true;
+            return false;
         }
+        if( !mLabels.empty() )
+        {
+            std::vector<uint64_t>::const_iterator lIter = std::lower_bound( mLabels.begin(), mLabels.end(), ( uint64_t )lLabel );
+            if( lIter == mLabels.end() || *lIter != lLabel )
+            {
+                return false;
+            }
+            rVertexId = ( vertexId_t )( lIter - mLabels.begin() );
+            return true;
+        }
+        if( lLabel < mFirstLabel || lLabel - mFirstLabel >= mNumNumbered )
+        {
+            return false;
+        }
+        rVertexId = ( vertexId_t )( lLabel - mFirstLabel );
+        return true;
     }
+
+    NameInterner::nameId_t lNameId = 0;
+    bool lRet = mVertexNames.find( pVertexName.data(), pVertexName.size(), lNameId );
+    rVertexId = ( vertexId_t )lNameId;
     return lRet;
 }
 
-bool Graph::getName( const Graph::vertexId_t& rId, std::string& rVertexName ) const
+template< typename VertexId >
+bool BasicGraph<VertexId>::getName( const vertexId_t& rId, std::string& rVertexName ) const
 {
     bool lRet = false;
 
-    if( isValidId( rId ) && !mVertexId2NameMap.empty() )
+    if( isValidId( rId ) )
     {
-        id2StringConstIter_t lIter = mVertexId2NameMap.find( rId );
-
-        if( lIter != mVertexId2NameMap.end() )
+        uint64_t lLabel = 0;
+        if( getLabel( rId, lLabel ) )
+        {
+            char lBuffer[24];
+            int lLength = sprintf( lBuffer, "%llu", ( unsigned long long )lLabel );
+            rVertexName.assign( lBuffer, lLength );
+        }
+        else
         {
-            rVertexName = lIter->second;
-            lRet = true;
+            mVertexNames.getName( rId, rVertexName );
         }
+        lRet = true;
     }
     return lRet;
 }
 
 
-bool Graph::getAdjacencyList( const Graph::vertexId_t& pIdx, Graph::idSet_t& rAdjList ) const
+template< typename VertexId >
+bool BasicGraph<VertexId>::getAdjacencyList( const vertexId_t& pIdx, idSet_t& rAdjList ) const
 {
     bool lRet = false;
 
@@ -309,28 +539,100 @@ bool Graph::getAdjacencyList( const Graph::vertexId_t& pIdx, Graph::idSet_t& rAd
     return lRet;
 }
 
-bool Graph::addVertex( const std::string& pVertexName, vertexId_t& rVertexId )
+template< typename VertexId >
+bool BasicGraph<VertexId>::addVertex( const std::string& pVertexName, vertexId_t& rVertexId )
+{
+    return addVertex( pVertexName.data(), pVertexName.size(), rVertexId );
+}
+
+template< typename VertexId >
+bool BasicGraph<VertexId>::addVertex( const char* pVertexName, size_t pLength, vertexId_t& rVertexId )
+{
+    return addVertex( pVertexName, pLength, NameInterner::hash( pVertexName, pLength ), rVertexId );
+}
+
+template< typename VertexId >
+bool BasicGraph<VertexId>::addVertex( const char* pVertexName,
+                                      size_t pLength,
+                                      NameInterner::hash_t pHash,
+                                      vertexId_t& rVertexId )
 {
     bool lRet = false;
 
     rVertexId = 0;
 
-    if( !getId( pVertexName, rVertexId ) )
+    NameInterner::nameId_t lNameId = 0;
+    if( isNumbered() )
     {
-        rVertexId = mVertexName2IdMap.size();
-        
-        mVertexName2IdMap.insert( string2IdPair_t( pVertexName, rVertexId ) );
-        mVertexId2NameMap.insert( id2StringPair_t( rVertexId, pVertexName ) );
+        getId( std::string( pVertexName, pLength ), rVertexId );
+    }
+    else if( !fitsVertexId<vertexId_t>( size() + 1 ) )
+    {
+        // no room for another id, only existing names resolve
+        mVertexNames.find( pVertexName, pLength, pHash, lNameId );
+        rVertexId = ( vertexId_t )lNameId;
+    }
+    else
+    {
+        lRet = mVertexNames.intern( pVertexName, pLength, pHash, lNameId );
+        rVertexId = ( vertexId_t )lNameId;
+    }
 
-        idSet_t lAdjSet;
-        mAdjacencyLists.push_back( lAdjSet );
-        lRet = true;
+    if( lRet )
+    {
+        mAdjacencyLists.push_back( idSet_t() );
+        mDegrees.push_back( 0 );
+
+        if( mDegreeHistogram.empty() )
+        {
+            mDegreeHistogram.push_back( 0 );
+        }
+        ++mDegreeHistogram[0];
     }
     
     return lRet;
 }
 
-bool Graph::addEdge( Graph::vertexId_t& rFirst, Graph::vertexId_t& rSecond )
+template< typename VertexId >
+bool BasicGraph<VertexId>::addNumberedVertices( size_t pNumVertices, uint64_t pFirstLabel )
+{
+    bool lRet = false;
+
+    if( empty() && pNumVertices && fitsVertexId<vertexId_t>( pNumVertices ) )
+    {
+        mNumNumbered = pNumVertices;
+        mFirstLabel = pFirstLabel;
+
+        mAdjacencyLists.resize( pNumVertices );
+        mDegrees.assign( pNumVertices, 0 );
+        mDegreeHistogram.assign( 1, pNumVertices );
+        mMaxDegree = 0;
+        lRet = true;
+    }
+
+    return lRet;
+}
+
+template< typename VertexId >
+bool BasicGraph<VertexId>::addNumberedVertices( const uint64_t* pLabels, size_t pNumVertices )
+{
+    bool lRet = false;
+
+    if( pLabels && addNumberedVertices( pNumVertices, pLabels[0] ) )
+    {
+        // a run without gaps needs no table
+        if( pLabels[pNumVertices - 1] - pLabels[0] != pNumVertices - 1 )
+        {
+            mLabels.assign( pLabels, pLabels + pNumVertices );
+        }
+        lRet = true;
+    }
+
+    return lRet;
+}
+
+template< typename VertexId >
+bool BasicGraph<VertexId>::addEdge( vertexId_t& rFirst, vertexId_t& rSecond )
 {
     bool lRet = false;
 
@@ -339,15 +641,18 @@ bool Graph::addEdge( Graph::vertexId_t& rFirst, Graph::vertexId_t& rSecond )
         idSet_t& rFirstSet = mAdjacencyLists[rFirst];
         idSet_t& rSecondSet = mAdjacencyLists[rSecond];
 
-        size_t lInitSize = rFirstSet.size();
-        bool lIsAdded = false;
-
-        rFirstSet.insert( rSecond );
-        lIsAdded = ( ( rFirstSet.size() - lInitSize ) > 0 );
+        bool lIsAdded = rFirstSet.insert( rSecond ).second;
+        if( lIsAdded )
+        {
+            incrementDegree( rFirst );
+        }
 
-        rSecondSet.insert( rFirst );
+        if( rSecondSet.insert( rFirst ).second )
+        {
+            incrementDegree( rSecond );
+        }
 
-        if( lIsAdded )
+        if( lIsAdded && mKeepEdgeList )
         {
             mEdges.push_back( idPair_t( rFirst, rSecond ) );
         }
@@ -357,31 +662,114 @@ bool Graph::addEdge( Graph::vertexId_t& rFirst, Graph::vertexId_t& rSecond )
     return lRet;
 }
 
-bool Graph::getAdjacencyMatrix( Graph::vertexId_t*& rMatrix, size_t& rNumElems ) const
+template< typename VertexId >
+bool BasicGraph<VertexId>::addEdges( const idPair_t* pEdges, size_t pNumEdges )
+{
+    if( 0 == pNumEdges )
+    {
+        return true;
+    }
+
+    // 1. count the edges that stay per block, and check every id
+    const size_t lBlockSize = 65536;
+    const size_t lNumBlocks = ( pNumEdges + lBlockSize - 1 ) / lBlockSize;
+    std::vector<size_t> lOffsets( lNumBlocks, 0 );
+    std::vector<char> lInvalid( lNumBlocks, 0 );
+
+    CountBulkArcs<BasicGraph> lCounter( *this, pEdges, lBlockSize, lOffsets, lInvalid );
+    parallelFor( 0, pNumEdges, lCounter, lBlockSize );
+
+    if( std::find( lInvalid.begin(), lInvalid.end(), 1 ) != lInvalid.end() )
+    {
+        return false;
+    }
+
+    // 2. both directions of every edge, sorted by source then target
+    size_t lNumKept = parallelExclusiveScan( &lOffsets[0], &lOffsets[0], lNumBlocks );
+    std::vector<idPair_t> lArcs( 2 * lNumKept );
+    if( lArcs.empty() )
+    {
+        return true;
+    }
+
+    CreateBulkArcs<BasicGraph> lCreator( pEdges, lBlockSize, lOffsets, &lArcs[0] );
+    parallelFor( 0, pNumEdges, lCreator, lBlockSize );
+
+    parallelSort( lArcs );
+
+    // 3. every vertex owns its run of arcs, so the sets fill in parallel
+    std::vector<char> lNewFlags( mKeepEdgeList ? lArcs.size() : 0, 0 );
+    InsertBulkArcs<BasicGraph> lInserter( lArcs, mAdjacencyLists, mDegrees, mKeepEdgeList ? &lNewFlags[0] : NULL );
+    parallelFor( 0, size(), lInserter );
+
+    for( size_t lArc = 0; lArc < lNewFlags.size(); ++lArc )
+    {
+        if( lNewFlags[lArc] )
+        {
+            mEdges.push_back( lArcs[lArc] );
+        }
+    }
+
+    // the histogram is cheaper to rebuild than to maintain per arc
+    mMaxDegree = 0;
+    for( size_t lIdx = 0; lIdx < mDegrees.size(); ++lIdx )
+    {
+        mMaxDegree = std::max( mMaxDegree, mDegrees[lIdx] );
+    }
+
+    mDegreeHistogram.assign( mMaxDegree + 1, 0 );
+    for( size_t lIdx = 0; lIdx < mDegrees.size(); ++lIdx )
+    {
+        ++mDegreeHistogram[mDegrees[lIdx]];
+    }
+
+    return true;
+}
+
+template< typename VertexId >
+void BasicGraph<VertexId>::incrementDegree( const vertexId_t& rId )
+{
+    size_t lDegree = mDegrees[rId]++;
+
+    --mDegreeHistogram[lDegree];
+    if( mDegreeHistogram.size() == lDegree + 1 )
+    {
+        mDegreeHistogram.push_back( 0 );
+    }
+    ++mDegreeHistogram[lDegree + 1];
+
+    if( lDegree + 1 > mMaxDegree )
+    {
+        mMaxDegree = lDegree + 1;
+    }
+}
+
+template< typename VertexId >
+bool BasicGraph<VertexId>::getAdjacencyMatrix( vertexId_t*& rMatrix, size_t& rNumElems ) const
 {
     bool lRet = false;
 
-    if( !mVertexName2IdMap.empty() )
+    if( !empty() )
     {
-        size_t lNumVertices = mVertexName2IdMap.size();
+        size_t lNumVertices = size();
         rNumElems = lNumVertices * lNumVertices;
         rMatrix = new vertexId_t[rNumElems];
         
         std::fill( rMatrix, rMatrix + rNumElems, 0 );
 
-        std::for_each( mAdjacencyLists.begin(),
-                       mAdjacencyLists.end(),
-                       CreateAdjacencyMatrix( rMatrix, *this ) );
+        CreateAdjacencyMatrix<BasicGraph> lBuilder( rMatrix, *this );
+        parallelFor( 0, lNumVertices, lBuilder );
         lRet = true;
     }
     return lRet;
 }
 
-bool Graph::createAdjacencyBitMatrix( byte_t*& rMatrix, size_t& rNumElems, size_t pNumVertices ) const
+template< typename VertexId >
+bool BasicGraph<VertexId>::createAdjacencyBitMatrix( byte_t*& rMatrix, size_t& rNumElems, size_t pNumVertices )
 {
     bool lRet = false;
     rNumElems = pNumVertices * pNumVertices;
-    size_t lNumBytes = std::ceil( ( ( double )rNumElems ) / Graph::BYTE_SIZE );
+    size_t lNumBytes = std::ceil( ( ( double )rNumElems ) / BYTE_SIZE );
     rMatrix = new byte_t[lNumBytes];
     std::fill( rMatrix, rMatrix + lNumBytes, 0 );
 
@@ -392,63 +780,112 @@ bool Graph::createAdjacencyBitMatrix( byte_t*& rMatrix, size_t& rNumElems, size_
     return lRet;
 }
 
-bool Graph::computeAdjacencyBitMatrix( Graph::byte_t*& rMatrix, size_t& rNumElems ) const
+template< typename VertexId >
+bool BasicGraph<VertexId>::computeAdjacencyBitMatrix( byte_t*& rMatrix, size_t& rNumElems ) const
 {
     bool lRet = false;
 
-    if( !mVertexName2IdMap.empty() && createAdjacencyBitMatrix( rMatrix, rNumElems, size() ) )
+    if( !empty() && createAdjacencyBitMatrix( rMatrix, rNumElems, size() ) )
     {
-        std::for_each( mAdjacencyLists.begin(),
-                       mAdjacencyLists.end(),
-                       CreateAdjacencyMatrix( rMatrix, *this ) );
+        // rows are packed back to back, chunks of 8 rows never share a byte
+        size_t lGrain = size() / ( 8 * ThreadPool::instance().getNumThreads() ) + 1;
+        lGrain = ( lGrain + 7 ) & ~( size_t )7;
+
+        CreateAdjacencyMatrix<BasicGraph> lBuilder( rMatrix, *this );
+        parallelFor( 0, size(), lBuilder, lGrain );
+        lRet = true;
+    }
+    return lRet;
+}
+
+template< typename VertexId >
+bool BasicGraph<VertexId>::computeAdjacencyBitMatrix( BitMatrix& rMatrix ) const
+{
+    bool lRet = false;
+
+    if( !empty() && rMatrix.resize( size(), size() ) )
+    {
+        // rows are padded to whole cache lines, any split is safe
+        CreateRowAlignedAdjacencyMatrix<BasicGraph> lBuilder( rMatrix, *this );
+        parallelFor( 0, size(), lBuilder );
+        lRet = true;
+    }
+    return lRet;
+}
+
+template< typename VertexId >
+bool BasicGraph<VertexId>::computeAdjacencyBitMatrix( TriangularBitMatrix& rMatrix ) const
+{
+    bool lRet = false;
+
+    if( !empty() && rMatrix.resize( size() ) )
+    {
+        for( vertexId_t lRow = 0; lRow < size(); ++lRow )
+        {
+            // only the upper triangle is stored, skip to the first neighbor above the diagonal
+            const idSet_t& rList = mAdjacencyLists[lRow];
+            for( idSetConstIter_t lIter = rList.upper_bound( lRow ); lIter != rList.end(); ++lIter )
+            {
+                rMatrix.setEdge( lRow, *lIter );
+            }
+        }
         lRet = true;
     }
     return lRet;
 }
 
-bool Graph::getNonAdjacencyMatrix( vertexId_t*& rMatrix, size_t& rNumElems ) const
+template< typename VertexId >
+bool BasicGraph<VertexId>::getNonAdjacencyMatrix( vertexId_t*& rMatrix, size_t& rNumElems ) const
 {
     bool lRet = false;
-    if( !mVertexName2IdMap.empty() )
+    if( !empty() )
     {
-        size_t lNumVertices = mVertexName2IdMap.size();
+        size_t lNumVertices = size();
         rNumElems = lNumVertices * ( lNumVertices + 1 );
         rMatrix = new vertexId_t[rNumElems];
         
         std::fill( rMatrix, rMatrix + rNumElems, 0 );
 
-        std::for_each( mAdjacencyLists.begin(),
-                       mAdjacencyLists.end(),
-                       CreateNonAdjacencyMatrix( rMatrix, *this ) );
+        CreateNonAdjacencyMatrix<BasicGraph> lBuilder( rMatrix, *this );
+        parallelFor( 0, lNumVertices, lBuilder );
         lRet = true;
     }
     return lRet;
 }
 
-bool Graph::getNonAdjacencyListArray( NonAdjacencyNode_t*& rNonAdjacencyListArray ) const
+template< typename VertexId >
+template< typename StreamId >
+bool BasicGraph<VertexId>::getNonAdjacencyStream( StreamId*& rNonAdjStream,
+                                                  size_t& rNonAdjStreamSize,
+                                                  typename VertexIdTraits<StreamId>::offset_t*& rNonAdjStreamIdxArray ) const
 {
+    typedef typename VertexIdTraits<StreamId>::offset_t offset_t;
+
     bool lRet = false;
-    if( !mVertexName2IdMap.empty() )
+    if( !empty() && fitsNonAdjacencyStream<StreamId>() )
     {
-        size_t lNumVertices = mVertexName2IdMap.size();
-        
-        rNonAdjacencyListArray = new NonAdjacencyNode_t[lNumVertices];
-        
-        Graph::idVec_t cVertices( lNumVertices );
+        size_t lNumVertices = size();
 
-        std::generate( cVertices.begin(), cVertices.end(), VertexIdGenerator() );
+        // the list sizes follow from the degrees, so the offsets and the
+        // single stream allocation are known before any list is built
+        rNonAdjStreamIdxArray = new offset_t[lNumVertices];
+
+        CountNonAdjacencyElems<BasicGraph, offset_t> lCounter( *this, rNonAdjStreamIdxArray );
+        parallelFor( 0, lNumVertices, lCounter );
+
+        rNonAdjStreamSize = parallelExclusiveScan( rNonAdjStreamIdxArray, rNonAdjStreamIdxArray, lNumVertices );
+        rNonAdjStream = new StreamId[rNonAdjStreamSize];
+
+        CreateNonAdjacencyStream<BasicGraph, StreamId, offset_t> lBuilder( *this, rNonAdjStreamIdxArray, rNonAdjStream );
+        parallelFor( 0, lNumVertices, lBuilder );
 
-        std::for_each( mAdjacencyLists.begin(),
-                       mAdjacencyLists.end(),
-                       CreateNonAdjacencyListArray( cVertices, 
-                                                    rNonAdjacencyListArray,
-                                                    *this ) );
         lRet = true;
     }
     return lRet;
 }
 
-void Graph::releaseMatrix( Graph::vertexId_t*& rMatrix ) const
+template< typename VertexId >
+void BasicGraph<VertexId>::releaseMatrix( vertexId_t*& rMatrix ) const
 {
     if( rMatrix )
     {
@@ -457,17 +894,35 @@ void Graph::releaseMatrix( Graph::vertexId_t*& rMatrix ) const
     }
 }
 
-void Graph::printAdjacencyList( std::ostream& rOutStream ) const
+template< typename VertexId >
+void BasicGraph<VertexId>::printAdjacencyList( std::ostream& rOutStream ) const
 {
-    Graph::stringSet_t lNames;
+    stringSet_t lNames;
     if( getVertexNames( lNames ) )
     {
-        std::for_each( lNames.begin(), lNames.end(), GraphPrinter( *this, rOutStream ) );
+        std::for_each( lNames.begin(), lNames.end(), GraphPrinter<BasicGraph>( *this, rOutStream ) );
     }
 }
 
-void Graph::print( std::ostream& rOutStream ) const
+template< typename VertexId >
+void BasicGraph<VertexId>::print( std::ostream& rOutStream ) const
 {
+    if( !mKeepEdgeList )
+    {
+        // every edge once, from its lower end
+        for( size_t lId = 0; lId < size(); ++lId )
+        {
+            const idSet_t& rSet = mAdjacencyLists[lId];
+            for( idSetConstIter_t lIter = rSet.upper_bound( ( vertexId_t )lId );
+                 lIter != rSet.end();
+                 ++lIter )
+            {
+                rOutStream << lId << ", " << *lIter << std::endl;
+            }
+        }
+        return;
+    }
+
     for( idPairStoreConstIter_t lIter = mEdges.begin();
          lIter != mEdges.end();
          ++lIter )
@@ -476,33 +931,36 @@ void Graph::print( std::ostream& rOutStream ) const
     }
 }
 
-bool Graph::getBit( const Graph::byte_t* pBitMatrix, size_t pBitOffset )
+template< typename VertexId >
+bool BasicGraph<VertexId>::getBit( const byte_t* pBitMatrix, size_t pBitOffset )
 {
-    size_t lByteNum = pBitOffset / Graph::BYTE_SIZE;
-    int lBitPos = pBitOffset % Graph::BYTE_SIZE;
-    const Graph::byte_t& lVertexByte = pBitMatrix[lByteNum];
-    return ( 0 != ( lVertexByte & ( 0x1 << ( Graph::BYTE_SIZE - ( lBitPos + 1 ) ) ) ) );
+    size_t lByteNum = pBitOffset / BYTE_SIZE;
+    int lBitPos = pBitOffset % BYTE_SIZE;
+    const byte_t& lVertexByte = pBitMatrix[lByteNum];
+    return ( 0 != ( lVertexByte & ( 0x1 << ( BYTE_SIZE - ( lBitPos + 1 ) ) ) ) );
 }
 
-void Graph::setBit( Graph::byte_t* pBitMatrix, size_t pBitOffset, bool pVal )
+template< typename VertexId >
+void BasicGraph<VertexId>::setBit( byte_t* pBitMatrix, size_t pBitOffset, bool pVal )
 {
-    size_t lByteNum = pBitOffset / Graph::BYTE_SIZE;
-    int lBitPos = pBitOffset % Graph::BYTE_SIZE;
-    Graph::byte_t& lVertexByte = pBitMatrix[lByteNum];
+    size_t lByteNum = pBitOffset / BYTE_SIZE;
+    int lBitPos = pBitOffset % BYTE_SIZE;
+    byte_t& lVertexByte = pBitMatrix[lByteNum];
 
     if( pVal )
     {
-        lVertexByte |= ( 0x1 << ( Graph::BYTE_SIZE - ( lBitPos + 1 ) ) );
+        lVertexByte |= ( 0x1 << ( BYTE_SIZE - ( lBitPos + 1 ) ) );
     }
     else
     {
-        lVertexByte &= ~( 0x1 << ( Graph::BYTE_SIZE - ( lBitPos + 1 ) ) );
+        lVertexByte &= ~( 0x1 << ( BYTE_SIZE - ( lBitPos + 1 ) ) );
     }
 }
 
-void Graph::printBitMatrix( std::ostream& rOutStream, const byte_t* pBitMatrix, size_t pMatrixSize ) const
+template< typename VertexId >
+void BasicGraph<VertexId>::printBitMatrix( std::ostream& rOutStream, const byte_t* pBitMatrix ) const
 {
-    Graph::stringSet_t lNames;
+    stringSet_t lNames;
     if( getVertexNames( lNames ) )
     {
         rOutStream << "  ";
@@ -510,26 +968,26 @@ void Graph::printBitMatrix( std::ostream& rOutStream, const byte_t* pBitMatrix,
         rOutStream << std::endl;
  
         size_t lNumVertices = size();
-        for( Graph::stringSetConstIter_t lIter = lNames.begin();
+        for( stringSetConstIter_t lIter = lNames.begin();
             lIter != lNames.end();
             ++lIter )
         {
-            Graph::vertexId_t i;
+            vertexId_t i;
             std::string lVertName = *lIter;
             if( getId( lVertName, i ) )
             {
                 rOutStream << lVertName << " ";
 
-                for( Graph::stringSetConstIter_t lInnerIter = lNames.begin();
+                for( stringSetConstIter_t lInnerIter = lNames.begin();
                     lInnerIter != lNames.end();
                     ++lInnerIter )
                 {
                     std::string lInnerVert = *lInnerIter;
-                    Graph::vertexId_t j;
+                    vertexId_t j;
 
                     if( getId( lInnerVert, j ) )
                     {
-                        int lVal = Graph::getBit( pBitMatrix, ( i * lNumVertices + j ) ) ? 1 : 0;
+                        int lVal = getBit( pBitMatrix, ( i * lNumVertices + j ) ) ? 1 : 0;
                         rOutStream << lVal << " ";
                     }
                 }
@@ -540,9 +998,10 @@ void Graph::printBitMatrix( std::ostream& rOutStream, const byte_t* pBitMatrix,
     }
 }
 
-void Graph::printMatrix( std::ostream& rOutStream, const vertexId_t* pMatrix, size_t pMatrixSize ) const
+template< typename VertexId >
+void BasicGraph<VertexId>::printMatrix( std::ostream& rOutStream, const vertexId_t* pMatrix ) const
 {
-    Graph::stringSet_t lNames;
+    stringSet_t lNames;
     if( getVertexNames( lNames ) )
     {
         rOutStream << "  ";
@@ -550,22 +1009,22 @@ void Graph::printMatrix( std::ostream& rOutStream, const vertexId_t* pMatrix, si
         rOutStream << std::endl;
  
         size_t lNumVertices = size();
-        for( Graph::stringSetConstIter_t lIter = lNames.begin();
+        for( stringSetConstIter_t lIter = lNames.begin();
             lIter != lNames.end();
             ++lIter )
         {
-            Graph::vertexId_t i;
+            vertexId_t i;
             std::string lVertName = *lIter;
             if( getId( lVertName, i ) )
             {
                 rOutStream << lVertName << " ";
 
-                for( Graph::stringSetConstIter_t lInnerIter = lNames.begin();
+                for( stringSetConstIter_t lInnerIter = lNames.begin();
                     lInnerIter != lNames.end();
                     ++lInnerIter )
                 {
                     std::string lInnerVert = *lInnerIter;
-                    Graph::vertexId_t j;
+                    vertexId_t j;
 
                     if( getId( lInnerVert, j ) )
                     {
@@ -579,37 +1038,24 @@ void Graph::printMatrix( std::ostream& rOutStream, const vertexId_t* pMatrix, si
     }
 }
 
-void Graph::marshallAdjacencyListArray( const NonAdjacencyNode_t* pNonAdjListArray, 
-                                        size_t pNumElems, 
-                                        vertexId_t*& rNonAdjStream,
-                                        size_t& rNonAdjStreamSize,
-                                        vertexId_t*& rNonAdjStreamIdxArray )
-{
-    size_t lMarshallSize = 0;
-
-    rNonAdjStreamIdxArray = new vertexId_t[pNumElems];
-
-    for( size_t lIdx = 0; lIdx < pNumElems; ++lIdx )
-    {
-        lMarshallSize += pNonAdjListArray[lIdx].mNumElems;
-
-        if( 0 == lIdx )
-        {
-            rNonAdjStreamIdxArray[lIdx] = 0;
-        }
-        else
-        {
-            rNonAdjStreamIdxArray[lIdx] = rNonAdjStreamIdxArray[lIdx - 1] + pNonAdjListArray[lIdx - 1].mNumElems;
-        }
-    }
-
-    rNonAdjStream = new vertexId_t[lMarshallSize];
-    rNonAdjStreamSize = lMarshallSize;
-
-    for( size_t lIdx = 0; lIdx < pNumElems; ++lIdx )
-    {
-        memcpy( rNonAdjStream + rNonAdjStreamIdxArray[lIdx], pNonAdjListArray[lIdx].mNodes, sizeof( vertexId_t ) * pNonAdjListArray[lIdx].mNumElems );
-    }
-}
+// every id width, and every stream width for each of them
+template class BasicGraph<uint16_t>;
+template class BasicGraph<uint32_t>;
+template class BasicGraph<uint64_t>;
+
+#define INSTANTIATE_NON_ADJACENCY_STREAM( GraphId, StreamId ) \
+    template bool BasicGraph<GraphId>::getNonAdjacencyStream<StreamId>( StreamId*&, \
+                                                                        size_t&, \
+                                                                        VertexIdTraits<StreamId>::offset_t*& ) const;
+
+INSTANTIATE_NON_ADJACENCY_STREAM( uint16_t, uint16_t )
+INSTANTIATE_NON_ADJACENCY_STREAM( uint16_t, uint32_t )
+INSTANTIATE_NON_ADJACENCY_STREAM( uint16_t, uint64_t )
+INSTANTIATE_NON_ADJACENCY_STREAM( uint32_t, uint16_t )
+INSTANTIATE_NON_ADJACENCY_STREAM( uint32_t, uint32_t )
+INSTANTIATE_NON_ADJACENCY_STREAM( uint32_t, uint64_t )
+INSTANTIATE_NON_ADJACENCY_STREAM( uint64_t, uint16_t )
+INSTANTIATE_NON_ADJACENCY_STREAM( uint64_t, uint32_t )
+INSTANTIATE_NON_ADJACENCY_STREAM( uint64_t, uint64_t )
 
 // end of file
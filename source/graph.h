@@ -1,64 +1,122 @@
 #ifndef _GRAPH_H_
 #define _GRAPH_H_
 
-#include <map>
 #include <set>
 #include <vector>
 #include <string>
 #include <ostream>
-#include "nonAdjacencyNode.h"
-
-struct NumericLess
-{
-    bool operator() ( std::string& pLhs, std::string& pRhs )
-    {
-        int lLhs = atoi( pLhs.c_str() );
-        int lRhs = atoi( pRhs.c_str() );
-
-        return ( lLhs < lRhs );
-    }
-};
-
-class Graph
+#include <cstdlib>
+#include <limits>
+#include "nameInterner.h"
+#include "graphFwd.h"
+#include "vertexIdTraits.h"
+
+class BitMatrix;
+class TriangularBitMatrix;
+
+// Thread safety: all const member functions are read only and keep no
+// hidden (static or mutable) state, so any number of threads may query a
+// Graph concurrently without locking, provided no thread is calling
+// addVertex / addEdge at the same time.
+//
+// The class is a template on the vertex id type; it is instantiated for
+// 16, 32 and 64 bit ids (see graphFwd.h). Vertex names go through a
+// NameInterner, so a named graph holds at most 2^32 - 1 vertices whatever
+// the id width. A numbered graph (addNumberedVertices) stores no names at
+// all, its vertices are named by their decimal number, their label.
+template< typename VertexId >
+class BasicGraph
 {
 public:
     typedef unsigned char byte_t;
-    typedef unsigned int vertexId_t;
+    typedef VertexId vertexId_t;
 
     typedef std::set<vertexId_t> idSet_t;
-    typedef idSet_t::iterator idSetIter_t;
-    typedef idSet_t::const_iterator idSetConstIter_t;
+    typedef typename idSet_t::iterator idSetIter_t;
+    typedef typename idSet_t::const_iterator idSetConstIter_t;
     typedef std::vector<idSet_t> idSetStore_t;
 
     typedef std::vector<vertexId_t> idVec_t;
+
+    typedef std::vector<size_t> degreeVec_t;
     
-    typedef std::map<const std::string, vertexId_t> string2IdMap_t;
-    typedef std::pair<const std::string, vertexId_t> string2IdPair_t;
-    typedef string2IdMap_t::const_iterator string2IdMapConstIter_t;
-
-    typedef std::map<const vertexId_t, const std::string> id2StringMap_t;
-    typedef std::pair<const vertexId_t, const std::string> id2StringPair_t;
-    typedef id2StringMap_t::const_iterator id2StringConstIter_t;
-        
     typedef std::set<std::string> stringSet_t;
     typedef stringSet_t::const_iterator stringSetConstIter_t;
 
     typedef std::pair<vertexId_t, vertexId_t> idPair_t;
     typedef std::vector<idPair_t> idPairStore_t;
-    typedef idPairStore_t::const_iterator idPairStoreConstIter_t;
+    typedef typename idPairStore_t::const_iterator idPairStoreConstIter_t;
+
+    // Read only view over the neighbors of a single vertex, in ascending
+    // id order. Valid until the next addVertex / addEdge.
+    class NeighborRange
+    {
+    public:
+        typedef idSetConstIter_t const_iterator;
+
+        NeighborRange( const idSet_t& rSet )
+            : mSet( &rSet )
+        {}
+
+        const_iterator begin() const { return mSet->begin(); }
+        const_iterator end() const { return mSet->end(); }
+        size_t size() const { return mSet->size(); }
+        bool empty() const { return mSet->empty(); }
+
+    private:
+        const idSet_t* mSet;
+    };
 
     static const char COMMENT_CHAR;
     static const int MAX_LINE_SIZE;
     static const int BYTE_SIZE;
 
-    Graph();
-    Graph( size_t pNumVertices );
+    BasicGraph();
 
     bool addVertex( const std::string& pVertexName, vertexId_t& rVertexId );
 
+    // Same as above, but interns the name straight from a character buffer
+    bool addVertex( const char* pVertexName, size_t pLength, vertexId_t& rVertexId );
+
+    // Same as above, with pHash = NameInterner::hash( pVertexName, pLength )
+    bool addVertex( const char* pVertexName, size_t pLength, NameInterner::hash_t pHash, vertexId_t& rVertexId );
+
+    // Adds pNumVertices vertices to the empty graph, vertex v being named
+    // by the number pFirstLabel + v. Nothing is interned, getName and getId
+    // convert on the fly. addVertex only resolves existing numbers
+    // afterwards.
+    bool addNumberedVertices( size_t pNumVertices, uint64_t pFirstLabel );
+
+    // Same as above with gaps: vertex v is labeled pLabels[v], the labels
+    // must be strictly ascending. Only the labels are stored, getId
+    // searches them.
+    bool addNumberedVertices( const uint64_t* pLabels, size_t pNumVertices );
+
+    bool isNumbered() const
+    {
+        return ( 0 != mNumNumbered );
+    }
+
     bool addEdge( vertexId_t& rFirst, vertexId_t& rSecond );
 
-    bool isEdge( const Graph::vertexId_t& rFirst, const Graph::vertexId_t& rSecond ) const
+    // Adds many edges at once: the edges are expanded to both directions
+    // and sorted on the thread pool, then every vertex without neighbors
+    // gets its set built from its run of arcs in one pass, repeats dropped,
+    // which is far cheaper than one addEdge per edge. The sets still cost
+    // a node per neighbor; for a graph without those, freeze a
+    // CompactGraph or load one straight from a file. Self loops are
+    // dropped. False, with the graph untouched, if any id is invalid.
+    bool addEdges( const idPair_t* pEdges, size_t pNumEdges );
+
+    // The graph keeps every added edge in insertion order for print(), a
+    // third copy of the topology. Turn it off before adding edges to save
+    // the memory; print() then lists the edges by vertex.
+    void setKeepEdgeList( bool pKeep )
+    {
+        mKeepEdgeList = pKeep;
+    }
+
+    bool isEdge( const vertexId_t& rFirst, const vertexId_t& rSecond ) const
     {
         const idSet_t& rFirstSet = mAdjacencyLists[rFirst];
         return ( rFirstSet.find( rSecond ) != rFirstSet.end() );
@@ -66,81 +124,208 @@ public:
 
     bool isValidId( const vertexId_t& rId ) const
     {
-        return ( rId < mVertexName2IdMap.size() );
+        return ( rId < size() );
     }
 
     bool empty() const
     {
-        return mVertexName2IdMap.empty();
+        return ( 0 == size() );
     }
 
-    static bool getBit( const Graph::byte_t* pBitMatrix, size_t pBitOffset );
-
-    static void setBit( Graph::byte_t* pBitMatrix, size_t pBitOffset, bool pVal );
+    static bool getBit( const byte_t* pBitMatrix, size_t pBitOffset );
 
-    // Helper function: Copies the non adjacency list array data to contiguous memory
-    //                  for passing to GPU, and updates the stream idx array with
-    //                  appropriate indices
-    static void marshallAdjacencyListArray( const NonAdjacencyNode_t* pNonAdjListArray, 
-                                            size_t pNumElems, 
-                                            vertexId_t*& rNonAdjStream,
-                                            size_t& rNonAdjStreamSize,
-                                            vertexId_t*& rNonAdjStreamIdxArray );
+    static void setBit( byte_t* pBitMatrix, size_t pBitOffset, bool pVal );
 
     bool getId( const std::string& rVertexName, vertexId_t& rId ) const;
     
     bool getName( const vertexId_t& rId, std::string& rVertexName ) const;
 
+    // Number of a vertex of a numbered graph, false on a named one
+    bool getLabel( const vertexId_t& rId, uint64_t& rLabel ) const
+    {
+        bool lRet = false;
+        rLabel = 0;
+
+        if( isNumbered() && isValidId( rId ) )
+        {
+            rLabel = mLabels.empty() ? mFirstLabel + rId : mLabels[rId];
+            lRet = true;
+        }
+        return lRet;
+    }
+
+    // Copies the neighbors of rId into rList. Prefer getNeighbors, which
+    // does not allocate.
     bool getAdjacencyList( const vertexId_t& rId, idSet_t& rList ) const;
 
+    // rId must be a valid id
+    NeighborRange getNeighbors( const vertexId_t& rId ) const
+    {
+        return NeighborRange( mAdjacencyLists[rId] );
+    }
+
     bool getVertexNames( stringSet_t& rNames ) const;
 
     bool getAdjacencyMatrix( vertexId_t*& rMatrix, size_t& rNumElems ) const;
 
-    bool createAdjacencyBitMatrix( byte_t*& rMatrix, size_t& rNumElems, size_t pNumVertices ) const;
+    // Zeroed pNumVertices x pNumVertices bit matrix. It is not sized from
+    // the graph, which holds no vertices when the coloring runs on a CSR
+    // read straight from a numbered file.
+    static bool createAdjacencyBitMatrix( byte_t*& rMatrix, size_t& rNumElems, size_t pNumVertices );
 
     bool computeAdjacencyBitMatrix( byte_t*& rMatrix, size_t& rNumElems ) const;
 
+    // Word based, row padded variant. Use BitMatrix::exportByteMatrix to get
+    // the byte layout above for the kernels.
+    bool computeAdjacencyBitMatrix( BitMatrix& rMatrix ) const;
+
+    // Upper triangular variant, half the memory of the full matrix
+    bool computeAdjacencyBitMatrix( TriangularBitMatrix& rMatrix ) const;
+
     bool getDegree( const vertexId_t& rId, size_t& rDegree ) const
     {
         bool lRet = false;
-        static idSet_t sIds;
         rDegree = 0;
 
-        if( getAdjacencyList( rId, sIds ) )
+        if( isValidId( rId ) )
         {
-            rDegree = sIds.size();
+            rDegree = mDegrees[rId];
             lRet = true;
         }
 
         return lRet;
     }
 
+    // Degrees are maintained incrementally by addEdge, the accessors
+    // below are O(1)
+    size_t getDegree( const vertexId_t& rId ) const
+    {
+        return mDegrees[rId];
+    }
+
+    const degreeVec_t& getDegrees() const
+    {
+        return mDegrees;
+    }
+
+    // Sum of the degrees, i.e. twice the number of edges
+    size_t getNumAdjacencies() const
+    {
+        size_t lNumAdjacencies = 0;
+        for( size_t lIdx = 0; lIdx < mDegrees.size(); ++lIdx )
+        {
+            lNumAdjacencies += mDegrees[lIdx];
+        }
+        return lNumAdjacencies;
+    }
+
+    // Heap bytes held by the graph. The adjacency sets are estimated, one
+    // tree node (three links, a color and the id) per neighbor entry.
+    size_t getNumBytes() const
+    {
+        const size_t lNodeBytes = 4 * sizeof( void* ) + sizeof( vertexId_t );
+        return mAdjacencyLists.capacity() * sizeof( idSet_t ) + getNumAdjacencies() * lNodeBytes +
+               mVertexNames.getNumBytes() + mLabels.capacity() * sizeof( uint64_t ) +
+               mEdges.capacity() * sizeof( idPair_t ) +
+               ( mDegrees.capacity() + mDegreeHistogram.capacity() ) * sizeof( size_t );
+    }
+
+    // Exact number of bytes computeAdjacencyBitMatrix( byte_t*&, size_t& )
+    // allocates for pNumVertices vertices
+    static size_t requiredBitMatrixBytes( size_t pNumVertices )
+    {
+        return ( pNumVertices * pNumVertices + BYTE_SIZE - 1 ) / BYTE_SIZE;
+    }
+
+    // True when getNonAdjacencyStream can build the stream for StreamId:
+    // the ids fit and so do the V * V - E offsets into the stream
+    template< typename StreamId >
+    bool fitsNonAdjacencyStream() const
+    {
+        typedef typename VertexIdTraits<StreamId>::offset_t offset_t;
+
+        uint64_t lStreamSize = ( uint64_t )size() * size() - getNumAdjacencies();
+        return fitsVertexId<StreamId>( size() ) &&
+               lStreamSize <= ( uint64_t )std::numeric_limits<offset_t>::max();
+    }
+
+    // Exact number of bytes getNonAdjacencyStream allocates for StreamId
+    template< typename StreamId >
+    size_t getNonAdjacencyStreamBytes() const
+    {
+        return ( size() * size() - getNumAdjacencies() ) * sizeof( StreamId ) +
+               size() * sizeof( typename VertexIdTraits<StreamId>::offset_t );
+    }
+
+    size_t getMaxDegree() const
+    {
+        return mMaxDegree;
+    }
+
+    // Element d is the number of vertices with degree d, the vector has
+    // getMaxDegree() + 1 elements
+    const degreeVec_t& getDegreeHistogram() const
+    {
+        return mDegreeHistogram;
+    }
+
     // Returns the non adjacency matrix as a single dimension array.
     // the size of the array is num_vertices * ( num_vertices + 1 )
     // The first element of each row contains the number of elements
     // that are non adjacent
     bool getNonAdjacencyMatrix( vertexId_t*& rMatrix, size_t& rNumElems ) const;
 
-    bool getNonAdjacencyListArray( NonAdjacencyNode_t*& rNonAdjacencyListArray ) const;
+    // Builds the non adjacency list of every vertex, sorted by ascending
+    // degree, directly into one contiguous stream ready for the device.
+    // The list of vertex v starts at rNonAdjStreamIdxArray[v]. The stream
+    // may use a narrower or wider id type than the graph; false if the ids
+    // or the stream offsets do not fit. Release both arrays with delete [].
+    template< typename StreamId >
+    bool getNonAdjacencyStream( StreamId*& rNonAdjStream,
+                                size_t& rNonAdjStreamSize,
+                                typename VertexIdTraits<StreamId>::offset_t*& rNonAdjStreamIdxArray ) const;
 
     void releaseMatrix( vertexId_t*& rMatrix ) const;
 
+    // Exchanges the contents of two graphs without copying
+    void swap( BasicGraph& rOther )
+    {
+        mAdjacencyLists.swap( rOther.mAdjacencyLists );
+        mVertexNames.swap( rOther.mVertexNames );
+        mEdges.swap( rOther.mEdges );
+        std::swap( mKeepEdgeList, rOther.mKeepEdgeList );
+        mDegrees.swap( rOther.mDegrees );
+        mDegreeHistogram.swap( rOther.mDegreeHistogram );
+        std::swap( mMaxDegree, rOther.mMaxDegree );
+        std::swap( mNumNumbered, rOther.mNumNumbered );
+        std::swap( mFirstLabel, rOther.mFirstLabel );
+        mLabels.swap( rOther.mLabels );
+    }
+
     size_t size() const
     {
-        return mVertexName2IdMap.size();
+        return mNumNumbered ? mNumNumbered : mVertexNames.size();
     }
 
     void print( std::ostream& rOutStream ) const;
     void printAdjacencyList( std::ostream& rOutStream ) const;
-    void printMatrix( std::ostream& rOutStream, const vertexId_t* pMatrix, size_t pMatrixSize ) const;
-    void printBitMatrix( std::ostream& rOutStream, const byte_t* pBitMatrix, size_t pMatrixSize ) const;
+    void printMatrix( std::ostream& rOutStream, const vertexId_t* pMatrix ) const;
+    void printBitMatrix( std::ostream& rOutStream, const byte_t* pBitMatrix ) const;
     
 private:
     idSetStore_t mAdjacencyLists;
-    string2IdMap_t mVertexName2IdMap;
-    id2StringMap_t mVertexId2NameMap;
+    NameInterner mVertexNames;
+    size_t mNumNumbered;
+    uint64_t mFirstLabel;
+    std::vector<uint64_t> mLabels;
     idPairStore_t mEdges;
+    bool mKeepEdgeList;
+
+    degreeVec_t mDegrees;
+    degreeVec_t mDegreeHistogram;
+    size_t mMaxDegree;
+
+    void incrementDegree( const vertexId_t& rId );
 };
 
 #endif
@@ -4,28 +4,336 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <string>
+#include <vector>
 
 #include <CL/cl.h>
 
 #include "defines.h"
 #include "graph.h"
+#include "compactGraph.h"
+#include "triangularBitMatrix.h"
+#include "complementView.h"
 #include "graphLoader.h"
 #include "utils.h"
 #include "lubyColor.h"
 #include "nonAdjacencyColor.h"
-#include "nonAdjacencyNode.h"
+#include "sparseVisColor.h"
+#include "jonesPlassmannColor.h"
+#include "speculativeColor.h"
+#include "parallelUtils.h"
+#include "vertexOrdering.h"
+#include "memoryBudget.h"
+#include "binaryGraph.h"
+#include "numericGraphLoader.h"
+#include "decompressStream.h"
+#include "mappedFile.h"
+#include "deviceSetup.h"
+#include "chromaticBounds.h"
 
 void usage( const char* pProgramName )
 {
-    printf( "usage: %s <vis|luby> [<OpenCL code file> <Kernel Name>] <Graph data file>\n", pProgramName );
+    printf( "usage: %s [options] <vis|luby> [<OpenCL code file> <Kernel Name>] <Graph data file>\n", pProgramName );
+    printf( "       %s [options] <svis|jp|spec> <Graph data file>\n", pProgramName );
+    printf( "algorithms:\n" );
+    printf( "  vis    vertex independent sets on the OpenCL device\n" );
+    printf( "  luby   Luby independent sets on the OpenCL device\n" );
+    printf( "  svis   vertex independent sets on the host over compressed sparse bitmaps\n" );
+    printf( "  jp     Jones-Plassmann, Luby's sets as a full coloring, on the host threads\n" );
+    printf( "  spec   speculative first fit with conflict repair on the host threads\n" );
+    printf( "options:\n" );
+    printf( "  --triangular   vis: upload only the upper triangle of the adjacency bit matrix\n" );
+    printf( "  --implicit     vis: walk the non neighbors on the device from the CSR graph\n" );
+    printf( "                 instead of uploading non adjacency lists and the adjacency matrix\n" );
+    printf( "  --threads <n>  host threads for the preprocessing, jp and spec (default: all hardware threads)\n" );
+    printf( "  --order <none|rcm|degree|bfs>\n" );
+    printf( "                 renumber the vertices for locality before coloring (default: none)\n" );
+    printf( "  --format <edges|ids|dimacs|metis|mtx>\n" );
+    printf( "                 input format (default: from the extension, .col, .graph, .metis\n" );
+    printf( "                 and .mtx, an edge list otherwise, read as ids if its names are numbers)\n" );
+    printf( "  --mem-budget <MB>\n" );
+    printf( "                 host memory budget; plain vis picks the densest representation that\n" );
+    printf( "                 fits, any other run is refused up front if it does not fit\n" );
+    printf( "  --chromatic <file>\n" );
+    printf( "                 chromatic number written by graphGen --chromatic; the colours\n" );
+    printf( "                 used are reported against it\n" );
+    printf( "The graph data file is an edge list or a binary graph file written by the\n" );
+    printf( "loader with --to-binary. When the graph is neither reordered nor budgeted,\n" );
+    printf( "svis, jp and spec use the CSR of a binary file with 32 bit ids in place, as\n" );
+    printf( "does vis --implicit with the narrowest ids that fit, and all of them\n" );
+    printf( "build the CSR of the numbered formats straight from the file. An edge list\n" );
+    printf( "may be gzip or zstd compressed when the loader is built with the codec.\n" );
+}
+
+// rColors is indexed by input id. rOldToNew maps the input ids to the ids
+// of a reordered rGraph, empty if the graph was not reordered. pBounds, if
+// given, is the chromatic number the colours are reported against.
+void printColoring( const Graph& rGraph, const std::vector<int>& rColors, const Graph::idVec_t& rOldToNew, const ChromaticBounds* pBounds )
+{
+    int lNumColors = 0;
+    std::string lVertexName;
+    uint64_t lVertexLabel = 0;
+
+    for( Graph::vertexId_t v = 0; v < rColors.size(); ++v )
+    {
+        // numbered vertices print without building their name
+        Graph::vertexId_t lId = rOldToNew.empty() ? v : rOldToNew[v];
+        if( rGraph.getLabel( lId, lVertexLabel ) )
+        {
+            printf( "colour of vertex %llu is %d\n", ( unsigned long long )lVertexLabel, rColors[v] );
+        }
+        else
+        {
+            rGraph.getName( lId, lVertexName );
+            printf( "colour of vertex %s is %d\n", lVertexName.c_str(), rColors[v] );
+        }
+        lNumColors = std::max( lNumColors, rColors[v] + 1 );
+    }
+
+    printf( "Number of colours used: %d\n", lNumColors );
+    if( pBounds )
+    {
+        pBounds->printGap( lNumColors );
+    }
 }
 
 #define DEFAULT_VIS_KERNEL_NAME "kernelColor"
 #define DEFAULT_VIS_KERNEL_FILE "..\\kernels\\individualSet.cl"
+#define DEFAULT_VIS_TRIANGULAR_KERNEL_FILE "..\\kernels\\individualSetTriangular.cl"
+#define DEFAULT_VIS_IMPLICIT_KERNEL_FILE "..\\kernels\\individualSetImplicit.cl"
 
 #define DEFAULT_LUBY_KERNEL_NAME "getISSet"
 #define DEFAULT_LUBY_KERNEL_FILE "..\\kernels\\lubyColor.cl"
 
+// Kernel build options naming the id and offset types the host picked for
+// the graph size
+struct KernelIdOptions
+{
+    std::string mOptions;
+
+    template< typename VertexId >
+    bool run()
+    {
+        mOptions = std::string( "-D VERTEX_ID_T=" ) + VertexIdTraits<VertexId>::CL_TYPE_NAME() +
+                   " -D OFFSET_T=" + VertexIdTraits<VertexId>::CL_OFFSET_NAME();
+        return true;
+    }
+};
+
+// Width of the ids the host picks for the graph size
+struct VertexIdBytes
+{
+    size_t mBytes;
+
+    template< typename VertexId >
+    bool run()
+    {
+        mBytes = sizeof( VertexId );
+        return true;
+    }
+};
+
+// Kernel file, name and build options of a device run. A kernel file given
+// on the command line is kept, the default follows the representation.
+void chooseKernel( bool pDoLuby, bool pImplicit, bool pTriangular, size_t pNumVertices,
+                   const char*& rKernelFile, const char*& rKernelName, std::string& rOptions )
+{
+    if( NULL == rKernelFile )
+    {
+        if( pDoLuby )
+        {
+            rKernelFile = DEFAULT_LUBY_KERNEL_FILE;
+        }
+        else if( pImplicit )
+        {
+            rKernelFile = DEFAULT_VIS_IMPLICIT_KERNEL_FILE;
+        }
+        else
+        {
+            rKernelFile = pTriangular ? DEFAULT_VIS_TRIANGULAR_KERNEL_FILE : DEFAULT_VIS_KERNEL_FILE;
+        }
+        rKernelName = pDoLuby ? DEFAULT_LUBY_KERNEL_NAME : DEFAULT_VIS_KERNEL_NAME;
+    }
+
+    KernelIdOptions lIdOptions;
+    dispatchOnVertexCount( pNumVertices, lIdOptions );
+    rOptions = lIdOptions.mOptions;
+}
+
+// Has the device build the kernel the run will most likely use while the
+// graph loads; pNumVertices may be an upper bound
+void prebuildKernel( DeviceSetup& rDevice, bool pDoLuby, bool pImplicit, bool pTriangular, size_t pNumVertices,
+                     const char* pKernelFile, const char* pKernelName )
+{
+    std::string lOptions;
+    chooseKernel( pDoLuby, pImplicit, pTriangular, pNumVertices, pKernelFile, pKernelName, lOptions );
+    rDevice.requestKernel( pKernelFile, pKernelName, lOptions );
+}
+
+// An edge list holds at most one vertex per two bytes ("a\n"), which bounds
+// the id width before it is read. Compressed input is taken to need 32 bit
+// ids.
+size_t boundEdgeListVertices( const char* pFilename )
+{
+    if( DecompressStream::isCompressed( pFilename ) )
+    {
+        return 0x10000;
+    }
+
+    MappedFile lFile;
+    return lFile.open( pFilename ) ? lFile.getSize() / 2 : 0;
+}
+
+// vis from the non adjacency stream, built with the dispatched id width
+struct VisListColorer
+{
+    const Graph& mGraph;
+    DeviceSetup& mDevice;
+    Graph::byte_t* mAdj;
+    size_t mAdjSize;
+
+    VisListColorer( const Graph& rGraph, DeviceSetup& rDevice, Graph::byte_t* pAdj, size_t pAdjSize )
+        : mGraph( rGraph ), mDevice( rDevice ), mAdj( pAdj ), mAdjSize( pAdjSize )
+    {}
+
+    template< typename VertexId >
+    bool run()
+    {
+        typedef typename VertexIdTraits<VertexId>::offset_t offset_t;
+
+        VertexId* lNonAdjArray = NULL;
+        offset_t* lNonAdjOffsetArray = NULL;
+        size_t lNumNonAdjArrayElems = 0;
+        const size_t lNumVertices = mGraph.size();
+
+        // built in place, the stream is uploaded as is
+        WallTimer lTimer;
+        if( !mGraph.getNonAdjacencyStream( lNonAdjArray, lNumNonAdjArrayElems, lNonAdjOffsetArray ) )
+        {
+            printf( "Unable to compute non adjacency matrix\n" );
+            return false;
+        }
+        printf( "Non adjacency lists built in %.2f ms (%u bit ids)\n",
+                lTimer.getElapsedMs(), ( unsigned int )( 8 * sizeof( VertexId ) ) );
+#ifdef _DEBUG
+        std::cout << "G' adjacency list" << std::endl;
+
+        size_t lLastIdx = 0;
+        for( size_t i = 0; i < lNumVertices; ++i )
+        {
+            size_t lCurrIdx = lNonAdjOffsetArray[i];
+            if( lCurrIdx != 0 )
+            {
+                PRINT_VERT( mGraph, ( i - 1 ) );
+                std::cout << " : ";
+                for( size_t j = lLastIdx; j < lCurrIdx; ++j )
+                {
+                    PRINT_VERT( mGraph, lNonAdjArray[j] );
+                    std::cout << " ";
+                }
+                std::cout << std::endl;
+            }
+            lLastIdx = lCurrIdx;
+        }
+#endif // _DEBUG
+
+        CompactGraph lCompactGraph;
+        bool lSuccess = lCompactGraph.freeze( mGraph );
+        if( !lSuccess )
+        {
+            printf( "Unable to build compact graph\n" );
+        }
+        else if( !mDevice.finish() )
+        {
+            lSuccess = false;
+        }
+        else
+        {
+            nonAdjacencyColor( mGraph,
+                lCompactGraph,
+                mDevice.getCommands(),
+                mDevice.getContext(),
+                mDevice.getKernel(),
+                mDevice.getProgram(),
+                mAdj,
+                mAdjSize,
+                lNonAdjArray,
+                lNumNonAdjArrayElems,
+                lNonAdjOffsetArray,
+                lNumVertices );
+        }
+
+        delete [] lNonAdjArray;
+        delete [] lNonAdjOffsetArray;
+        return lSuccess;
+    }
+};
+
+// vis walking the complement of a CSR graph with the dispatched id width.
+// With a binary file the CSR and the order are used in place, with a
+// numeric loader the CSR is built from the file.
+struct VisImplicitColorer
+{
+    const Graph& mGraph;
+    DeviceSetup& mDevice;
+    const BinaryGraphFile* mBinaryFile;
+    NumericGraphLoader* mNumericLoader;
+
+    // the numbered file broke its format, a load error rather than a
+    // coloring one
+    bool mLoadFailed;
+
+    VisImplicitColorer( const Graph& rGraph, DeviceSetup& rDevice, const BinaryGraphFile* pBinaryFile,
+                        NumericGraphLoader* pNumericLoader )
+        : mGraph( rGraph ), mDevice( rDevice ), mBinaryFile( pBinaryFile ), mNumericLoader( pNumericLoader )
+        , mLoadFailed( false )
+    {}
+
+    template< typename VertexId >
+    bool run()
+    {
+        BasicCompactGraph<VertexId> lCompactGraph;
+        BasicComplementView<VertexId> lComplement;
+        bool lReady = false;
+        if( mBinaryFile )
+        {
+            lReady = mBinaryFile->attach( lCompactGraph ) && mBinaryFile->attach( lCompactGraph, lComplement );
+        }
+        else if( mNumericLoader )
+        {
+            mLoadFailed = !mNumericLoader->loadCsr( lCompactGraph );
+            if( mLoadFailed )
+            {
+                return false;
+            }
+            mNumericLoader->printStats();
+            lReady = lComplement.build( lCompactGraph );
+        }
+        else
+        {
+            lReady = lCompactGraph.freeze( mGraph ) && lComplement.build( lCompactGraph );
+        }
+        if( !lReady )
+        {
+            printf( "Unable to build compact graph\n" );
+            return false;
+        }
+        if( !mDevice.finish() )
+        {
+            return false;
+        }
+
+        nonAdjacencyColor( mGraph,
+            lCompactGraph,
+            lComplement,
+            mDevice.getCommands(),
+            mDevice.getContext(),
+            mDevice.getKernel(),
+            mDevice.getProgram() );
+        return true;
+    }
+};
+
 // *********************************************************************
 // Main function
 // *********************************************************************
@@ -35,11 +343,77 @@ int main(int argc, char **argv)
     const char* lKernelFile = NULL;
     const char* lKernelName = NULL;
     const char* lGraphData = NULL;
+    const char* lProgramName = argv[0];
     bool lDoLuby = false;
+    bool lDoSparseVis = false;
+    bool lDoJonesPlassmann = false;
+    bool lDoSpeculative = false;
+    bool lTriangular = false;
+    bool lImplicit = false;
+    VertexOrder_t lOrder = VERTEX_ORDER_NONE;
+    GraphFormat_t lFormat = GRAPH_FORMAT_EDGE_LIST;
+    bool lFormatGiven = false;
+    size_t lMemBudget = 0;
+    ChromaticBounds lBounds;
+    bool lBoundsGiven = false;
+
+    // options come before the positional arguments
+    while( argc > 1 && 0 == strncmp( argv[1], "--", 2 ) )
+    {
+        if( 0 == strcmp( argv[1], "--triangular" ) )
+        {
+            lTriangular = true;
+        }
+        else if( 0 == strcmp( argv[1], "--implicit" ) )
+        {
+            lImplicit = true;
+        }
+        else if( 0 == strcmp( argv[1], "--order" ) && argc > 2 && parseVertexOrder( argv[2], lOrder ) )
+        {
+            --argc;
+            ++argv;
+        }
+        else if( 0 == strcmp( argv[1], "--format" ) && argc > 2 && parseGraphFormat( argv[2], lFormat ) )
+        {
+            lFormatGiven = true;
+            --argc;
+            ++argv;
+        }
+        else if( 0 == strcmp( argv[1], "--mem-budget" ) && argc > 2 && atof( argv[2] ) > 0 )
+        {
+            lMemBudget = ( size_t )( atof( argv[2] ) * 1024 * 1024 );
+            --argc;
+            ++argv;
+        }
+        else if( 0 == strcmp( argv[1], "--threads" ) && argc > 2 && atoi( argv[2] ) > 0 )
+        {
+            ThreadPool::setDefaultNumThreads( atoi( argv[2] ) );
+            --argc;
+            ++argv;
+        }
+        else if( 0 == strcmp( argv[1], "--chromatic" ) && argc > 2 )
+        {
+            if( !lBounds.read( argv[2] ) )
+            {
+                printf( "Unable to read the chromatic number from %s\n", argv[2] );
+                return 1;
+            }
+            lBoundsGiven = true;
+            --argc;
+            ++argv;
+        }
+        else
+        {
+            usage( lProgramName );
+            return 1;
+        }
+        --argc;
+        ++argv;
+    }
     
     if( argc < 3 )
     {
-        usage( argv[0] );
+        usage( lProgramName );
         return 1;
     }
     else 
@@ -49,11 +423,31 @@ int main(int argc, char **argv)
         {
             lDoLuby = true;
         }
+        else if( 0 == strcmp( lAlgorithm, "svis" ) )
+        {
+            lDoSparseVis = true;
+        }
+        else if( 0 == strcmp( lAlgorithm, "jp" ) )
+        {
+            lDoJonesPlassmann = true;
+        }
+        else if( 0 == strcmp( lAlgorithm, "spec" ) )
+        {
+            lDoSpeculative = true;
+        }
 
-        if( argc == 3 )
+        if( lDoSparseVis || lDoJonesPlassmann || lDoSpeculative )
+        {
+            if( argc != 3 )
+            {
+                usage( lProgramName );
+                return 1;
+            }
+            lGraphData = argv[2];
+        }
+        else if( argc == 3 )
         {
-            lKernelFile = lDoLuby ? DEFAULT_LUBY_KERNEL_FILE : DEFAULT_VIS_KERNEL_FILE;
-            lKernelName = lDoLuby ? DEFAULT_LUBY_KERNEL_NAME : DEFAULT_VIS_KERNEL_NAME;
+            // the default kernel is picked once the representation is known
             lGraphData = argv[2];
         }
         else if( argc == 5 )
@@ -64,136 +458,375 @@ int main(int argc, char **argv)
         }
         else
         {
-            usage( argv[0] );
+            usage( lProgramName );
             return 1;
         }
     }
     
+    // the device comes up while the host loads and preprocesses the graph
+    bool lOnHost = lDoSparseVis || lDoJonesPlassmann || lDoSpeculative;
+    WallTimer lTotalTimer;
+    DeviceSetup lDevice;
+    if( !lOnHost )
+    {
+        lDevice.start();
+    }
+
     Graph lGraph;
     GraphLoader lGraphLoader;
+    BinaryGraphFile lBinaryFile;
+    NumericGraphLoader lNumericLoader;
+    CompactGraph lCompactGraph;
+    bool lAttachBinary = false;
+    bool lNumericCsr = false;
+    lGraph.setKeepEdgeList( false );
+
+    // Nothing renumbers or costs the graph, so the paths that read only the
+    // CSR can take it without the adjacency sets
+    bool lCsrOnly = VERTEX_ORDER_NONE == lOrder && 0 == lMemBudget && ( lOnHost || ( lImplicit && !lDoLuby ) );
+    if( !lFormatGiven )
+    {
+        lFormat = detectGraphFormat( lGraphData );
+    }
+
+    // a guessed id edge list may turn to names past the sniffed lines
+    bool lNumericOpen = false;
+    if( GRAPH_FORMAT_EDGE_LIST != lFormat && !BinaryGraphFile::isBinaryGraph( lGraphData ) )
+    {
+        lNumericOpen = lNumericLoader.open( lGraphData, lFormat );
+        if( !lNumericOpen && !lFormatGiven && GRAPH_FORMAT_ID_EDGE_LIST == lFormat )
+        {
+            printf( "Reading %s as named edge list\n", lGraphData );
+            lFormat = GRAPH_FORMAT_EDGE_LIST;
+        }
+    }
+    if( lNumericOpen && !lOnHost )
+    {
+        prebuildKernel( lDevice, lDoLuby, lImplicit, lTriangular, lNumericLoader.getNumVertices(), lKernelFile, lKernelName );
+    }
     
-    if( !lGraphLoader.loadInput( lGraphData, lGraph ) )
+    if( BinaryGraphFile::isBinaryGraph( lGraphData ) )
+    {
+        if( !lBinaryFile.open( lGraphData ) )
+        {
+            printf( "Unable to load graph data from %s\n", lGraphData );
+            return 2;
+        }
+
+        if( !lOnHost )
+        {
+            prebuildKernel( lDevice, lDoLuby, lImplicit, lTriangular, lBinaryFile.getNumVertices(), lKernelFile, lKernelName );
+        }
+
+        // the CSR is taken from the mapping and only the names are loaded;
+        // jp and spec need no order
+        VertexIdBytes lIdBytes;
+        dispatchOnVertexCount( lBinaryFile.getNumVertices(), lIdBytes );
+        lAttachBinary = lCsrOnly && ( lDoJonesPlassmann || lDoSpeculative || lBinaryFile.hasOrder() ) &&
+                        ( lOnHost ? sizeof( Graph::vertexId_t ) : lIdBytes.mBytes ) == lBinaryFile.getIdBytes();
+
+        WallTimer lLoadTimer;
+        if( !( lAttachBinary ? lBinaryFile.loadVertices( lGraph ) : lBinaryFile.loadGraph( lGraph ) ) )
+        {
+            printf( "Unable to load graph data from %s\n", lGraphData );
+            return 2;
+        }
+        printf( "Read binary graph: %lu vertices, %lu adjacencies, %u bit ids, %s in %.2f ms\n",
+                ( unsigned long )lBinaryFile.getNumVertices(),
+                ( unsigned long )lBinaryFile.getNumAdjacencies(),
+                ( unsigned int )( 8 * lBinaryFile.getIdBytes() ),
+                lAttachBinary ? "CSR mapped in place" : "edges loaded",
+                lLoadTimer.getElapsedMs() );
+        if( lCsrOnly && !lAttachBinary && lBinaryFile.getIdBytes() != ( lOnHost ? sizeof( Graph::vertexId_t ) : lIdBytes.mBytes ) )
+        {
+            printf( "Write the file with --id-bytes %u to map its CSR in place\n",
+                    ( unsigned int )( lOnHost ? sizeof( Graph::vertexId_t ) : lIdBytes.mBytes ) );
+        }
+    }
+    else if( GRAPH_FORMAT_EDGE_LIST != lFormat )
+    {
+        // the vertices are numbered and the CSR is built straight from the
+        // file: for the host engines now, so a bad line fails the load, for
+        // vis --implicit once its id width is known
+        lNumericCsr = lCsrOnly;
+        bool lLoaded = lNumericOpen &&
+                       ( lNumericCsr ? lNumericLoader.loadVertices( lGraph ) : lNumericLoader.loadInput( lGraph ) );
+        if( lLoaded && lNumericCsr && lOnHost )
+        {
+            lLoaded = lNumericLoader.loadCsr( lCompactGraph );
+        }
+        if( !lLoaded )
+        {
+            printf( "Unable to load graph data from %s\n", lGraphData );
+            return 2;
+        }
+        if( !lNumericCsr || lOnHost )
+        {
+            lNumericLoader.printStats();
+        }
+    }
+    else
+    {
+        if( !lOnHost )
+        {
+            prebuildKernel( lDevice, lDoLuby, lImplicit, lTriangular, boundEdgeListVertices( lGraphData ), lKernelFile, lKernelName );
+        }
+        if( !lGraphLoader.loadInput( lGraphData, lGraph ) )
+        {
+            printf( "Unable to load graph data from %s\n", lGraphData );
+            return 2;
+        }
+        lGraphLoader.printStats();
+    }
+
+    // Vertices keep their names when renumbered, so the device paths,
+    // which print by name, need no mapping back
+    Graph::idVec_t lNewToOld;
+    Graph::idVec_t lOldToNew;
+    if( lOrder != VERTEX_ORDER_NONE )
+    {
+        WallTimer lOrderTimer;
+        BandwidthStats lBefore;
+        BandwidthStats lAfter;
+        Graph lOrdered;
+        lOrdered.setKeepEdgeList( false );
+
+        measureBandwidth( lGraph, lBefore );
+        if( !computeVertexOrder( lGraph, lOrder, lNewToOld ) || !permuteGraph( lGraph, lNewToOld, lOrdered ) )
+        {
+            printf( "Unable to reorder the graph\n" );
+            return 2;
+        }
+        measureBandwidth( lOrdered, lAfter );
+
+        lGraph.swap( lOrdered );
+        invertVertexOrder( lNewToOld, lOldToNew );
+
+        printf( "Vertex order %s: bandwidth %lu -> %lu, profile %llu -> %llu, reordered in %.2f ms\n",
+                getVertexOrderName( lOrder ),
+                ( unsigned long )lBefore.mBandwidth, ( unsigned long )lAfter.mBandwidth,
+                ( unsigned long long )lBefore.mProfile, ( unsigned long long )lAfter.mProfile,
+                lOrderTimer.getElapsedMs() );
+    }
+
+    // Every representation is costed before any is built. Only a plain vis
+    // run with the default kernel is free to change representation. A graph
+    // going straight to a CSR has no adjacency sets to cost.
+    MemoryEstimate lEstimate;
+    if( !lAttachBinary && !lNumericCsr )
     {
-        printf( "Unable to load graph data from %d\n", lGraphData );
-        return 2;
+        estimateMemory( lGraph, lEstimate );
+        printMemoryReport( lEstimate );
+    }
+
+    if( lMemBudget )
+    {
+        ColoringPlan_t lPlan = lDoLuby ? PLAN_LUBY :
+                               lDoJonesPlassmann ? PLAN_JONES_PLASSMANN :
+                               lDoSpeculative ? PLAN_SPECULATIVE :
+                               lDoSparseVis ? PLAN_SPARSE_VIS :
+                               lImplicit ? PLAN_VIS_IMPLICIT :
+                               lTriangular ? PLAN_VIS_TRIANGULAR : PLAN_VIS;
+
+        if( PLAN_VIS == lPlan && NULL == lKernelFile )
+        {
+            if( !selectVisPlan( lEstimate, lMemBudget, lPlan ) )
+            {
+                printf( "No representation fits the memory budget of %.2f MB, svis needs %.2f MB\n",
+                        lMemBudget / ( 1024.0 * 1024.0 ),
+                        lEstimate.mPlanBytes[PLAN_SPARSE_VIS] / ( 1024.0 * 1024.0 ) );
+                return 6;
+            }
+
+            lTriangular = ( PLAN_VIS_TRIANGULAR == lPlan );
+            lImplicit = ( PLAN_VIS_IMPLICIT == lPlan );
+            lDoSparseVis = ( PLAN_SPARSE_VIS == lPlan );
+
+            // falling back to svis leaves the device unused
+            if( lDoSparseVis )
+            {
+                lOnHost = true;
+                lDevice.cancel();
+            }
+        }
+        else if( MEMORY_NOT_AVAILABLE == lEstimate.mPlanBytes[lPlan] )
+        {
+            printf( "%s cannot index the non adjacency stream of %lu vertices\n",
+                    getPlanName( lPlan ), ( unsigned long )lGraph.size() );
+            return 6;
+        }
+        else if( lEstimate.mPlanBytes[lPlan] > lMemBudget )
+        {
+            printf( "%s needs %.2f MB, over the memory budget of %.2f MB\n",
+                    getPlanName( lPlan ),
+                    lEstimate.mPlanBytes[lPlan] / ( 1024.0 * 1024.0 ),
+                    lMemBudget / ( 1024.0 * 1024.0 ) );
+            return 6;
+        }
+
+        printf( "Running %s, %.2f MB of the %.2f MB budget\n",
+                getPlanName( lPlan ),
+                lEstimate.mPlanBytes[lPlan] / ( 1024.0 * 1024.0 ),
+                lMemBudget / ( 1024.0 * 1024.0 ) );
+    }
+
+    if( lOnHost )
+    {
+        ComplementView lComplement;
+        std::vector<int> lColors;
+
+        bool lReady = false;
+        if( lAttachBinary )
+        {
+            lReady = lBinaryFile.attach( lCompactGraph ) &&
+                     ( lDoJonesPlassmann || lDoSpeculative || lBinaryFile.attach( lCompactGraph, lComplement ) );
+        }
+        else if( lNumericCsr )
+        {
+            // read with the vertices
+            lReady = true;
+        }
+        else
+        {
+            lReady = lCompactGraph.freeze( lGraph );
+        }
+        bool lColored = false;
+        if( lReady && lDoJonesPlassmann )
+        {
+            WallTimer lColorTimer;
+            size_t lNumRounds = 0;
+            lColored = jonesPlassmannColor( lCompactGraph, lColors, 0, lNumRounds );
+            printf( "Jones-Plassmann on %u host threads: %lu rounds in %.2f ms\n",
+                    ( unsigned int )ThreadPool::instance().getNumThreads(), ( unsigned long )lNumRounds, lColorTimer.getElapsedMs() );
+        }
+        else if( lReady && lDoSpeculative )
+        {
+            WallTimer lColorTimer;
+            size_t lNumIterations = 0;
+            size_t lNumRecolored = 0;
+            lColored = speculativeColor( lCompactGraph, lColors, lNumIterations, lNumRecolored );
+            printf( "Speculative coloring on %u host threads: %lu iterations, %lu vertices recolored in %.2f ms\n",
+                    ( unsigned int )ThreadPool::instance().getNumThreads(), ( unsigned long )lNumIterations,
+                    ( unsigned long )lNumRecolored, lColorTimer.getElapsedMs() );
+        }
+        else if( lReady )
+        {
+            lColored = sparseVisColor( lCompactGraph, lColors, lAttachBinary ? &lComplement : NULL );
+        }
+        if( !lColored )
+        {
+            printf( "Unable to color the graph\n" );
+            return 4;
+        }
+
+        // back to input ids
+        if( !lNewToOld.empty() )
+        {
+            std::vector<int> lOriginalColors;
+            mapColorsToOriginal( lColors, lNewToOld, lOriginalColors );
+            lColors.swap( lOriginalColors );
+        }
+
+        printColoring( lGraph, lColors, lOldToNew, lBoundsGiven ? &lBounds : NULL );
+        return 0;
     }
 
     size_t lNumElems = 0;
     Graph::vertexId_t* h_adj = NULL;
     Graph::byte_t* h_bit_adj = NULL;
+    TriangularBitMatrix lTriangularAdj;
+
+    // size of memory required to store the matrix
+    size_t adj_size = 0;
+
+    printf( "Preprocessing on %u host threads\n", ( unsigned int )ThreadPool::instance().getNumThreads() );
+    WallTimer lTimer;
 
-    if( !lGraph.computeAdjacencyBitMatrix( h_bit_adj, lNumElems ) )
+    if( lImplicit && !lDoLuby )
     {
-        printf( "Unable to load adjacency bit matrix\n" );
-        return 3;
+        // the implicit kernel reads the CSR graph, no matrix is uploaded
     }
+    else if( lTriangular )
+    {
+        if( !lGraph.computeAdjacencyBitMatrix( lTriangularAdj ) )
+        {
+            printf( "Unable to load triangular adjacency bit matrix\n" );
+            return 3;
+        }
 
-    // size of memory required to store the matrix
-    const size_t adj_size = std::ceil( ( ( double )lNumElems ) / Graph::BYTE_SIZE );
+        // the packed words are uploaded as is
+        h_bit_adj = ( Graph::byte_t* )lTriangularAdj.getWords();
+        adj_size = lTriangularAdj.getNumBytes();
+    }
+    else
+    {
+        if( !lGraph.computeAdjacencyBitMatrix( h_bit_adj, lNumElems ) )
+        {
+            printf( "Unable to load adjacency bit matrix\n" );
+            return 3;
+        }
+
+        adj_size = std::ceil( ( ( double )lNumElems ) / Graph::BYTE_SIZE );
 
 #ifdef _DEBUG
-    std::cout << "Adjacency Bit Matrix" << std::endl;
-    lGraph.printBitMatrix( std::cout, h_bit_adj, lNumElems );
+        std::cout << "Adjacency Bit Matrix" << std::endl;
+        lGraph.printBitMatrix( std::cout, h_bit_adj );
 #endif // _DEBUG
+    }
 
-    const unsigned int lNumVertices = lGraph.size();
-
-    cl_device_id device_id;
-    cl_command_queue commands;
-    cl_context context;
-
-    if( !initOCL( device_id, context, commands ) )
+    if( adj_size )
     {
-        return EXIT_FAILURE;
+        printf( "Adjacency matrix built in %.2f ms\n", lTimer.getElapsedMs() );
     }
 
-    // Create program and kernel
-    cl_kernel kernel;
-    cl_program program;
+    const unsigned int lNumVertices = lGraph.size();
 
-    if( !createKernelFromSource( lKernelFile,
-                                 device_id, 
-                                 context, 
-                                 program, 
-                                 commands,
-                                 kernel, 
-                                 lKernelName ) )
-    {
-        return EXIT_FAILURE;
-    }
+    // the width is final now, the device rebuilds if it guessed another
+    std::string lKernelOptions;
+    chooseKernel( lDoLuby, lImplicit, lTriangular, lNumVertices, lKernelFile, lKernelName, lKernelOptions );
+    lDevice.selectKernel( lKernelFile, lKernelName, lKernelOptions );
 
     if( lDoLuby )
     {
+        if( !lDevice.finish() )
+        {
+            return EXIT_FAILURE;
+        }
         lubyColor( lGraph,
-            commands, 
-            context, 
-            kernel, 
-            program, 
+            lDevice.getCommands(), 
+            lDevice.getContext(), 
+            lDevice.getKernel(), 
+            lDevice.getProgram(), 
             h_adj, 
             adj_size, 
             lNumVertices );
     }
-    else
+    else if( lImplicit )
     {
-        NonAdjacencyNode_t* lNonAdjListArray = NULL;
-        Graph::vertexId_t* lNonAdjArray = NULL;
-        Graph::vertexId_t* lNonAdjOffsetArray = NULL;
-
-        if( !lGraph.getNonAdjacencyListArray( lNonAdjListArray ) )
-        {
-            printf( "Unable to compute non adjacency matrix\n" );
-            return 4;
-        }
-
-        size_t lNumNonAdjArrayElems = 0;
-        Graph::marshallAdjacencyListArray( lNonAdjListArray, 
-                                           lNumVertices, 
-                                           lNonAdjArray,
-                                           lNumNonAdjArrayElems, 
-                                           lNonAdjOffsetArray );
-#ifdef _DEBUG
-        std::cout << "G' adjacency list" << std::endl;
-
-        size_t lLastIdx = 0;
-        for( size_t i = 0; i < lNumVertices; ++i )
+        VisImplicitColorer lColorer( lGraph, lDevice, lAttachBinary ? &lBinaryFile : NULL, lNumericCsr ? &lNumericLoader : NULL );
+        if( !dispatchOnVertexCount( lNumVertices, lColorer ) )
         {
-            size_t lCurrIdx = lNonAdjOffsetArray[i];
-            if( lCurrIdx != 0 )
+            if( lColorer.mLoadFailed )
             {
-                PRINT_VERT( lGraph, ( i - 1 ) );
-                std::cout << " : ";
-                for( size_t j = lLastIdx; j < lCurrIdx; ++j )
-                {
-                    PRINT_VERT( lGraph, lNonAdjArray[j] );
-                    std::cout << " ";
-                }
-                std::cout << std::endl;
+                printf( "Unable to load graph data from %s\n", lGraphData );
+                return 2;
             }
-            lLastIdx = lCurrIdx;
+            return 5;
+        }
+    }
+    else
+    {
+        VisListColorer lColorer( lGraph, lDevice, h_bit_adj, adj_size );
+        if( !dispatchOnVertexCount( lNumVertices, lColorer ) )
+        {
+            return 4;
         }
-#endif // _DEBUG
-
-        nonAdjacencyColor( lGraph,
-            commands,
-            context, 
-            kernel,
-            program,
-            h_bit_adj,
-            adj_size,
-            lNonAdjArray,
-            lNumNonAdjArrayElems,
-            lNonAdjOffsetArray,
-            lNumVertices );
-
-        lGraph.releaseMatrix( ( Graph::vertexId_t*& )lNonAdjArray );
     }
 
-    ::clFinish( commands );
+    ::clFinish( lDevice.getCommands() );
 
-    clReleaseKernel(kernel);
-    clReleaseProgram(program);
-    clReleaseCommandQueue(commands);
-    clReleaseContext(context);
+    lDevice.printTimes();
+    printf( "Colored in %.2f ms from the start of the load\n", lTotalTimer.getElapsedMs() );
 
     lGraph.releaseMatrix( ( Graph::vertexId_t*& )h_adj );
 
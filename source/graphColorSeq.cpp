@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include "graph.h"
+#include "compactGraph.h"
 #include "graphLoader.h"
 
 
@@ -19,29 +20,19 @@ void assignColor(Graph& lGraph, const unsigned int num_vertices)
 {
     printf("the number of vertices are %d\n", num_vertices);
 
-    Graph::vertexId_t* lMatrix;
-    size_t lNumElems;
+    CompactGraph lCompactGraph;
 
-    if( lGraph.getAdjacencyMatrix( lMatrix, lNumElems ) )
+    if( lCompactGraph.freeze( lGraph ) )
     {
-        unsigned int maxDegree = 0;
-        size_t degree = 0;
-
-        for (unsigned int i = 0; i < num_vertices; i++)
-        {
-            if( lGraph.getDegree( i, degree ) )
-            {
-                if ( degree > maxDegree )
-                    maxDegree = degree;
-            }
-        }
+        unsigned int maxDegree = lCompactGraph.getMaxDegree();
 
         printf("Max Degree is %d\n", maxDegree);
         unsigned int* vertexColor = (unsigned int *) malloc (num_vertices * sizeof(unsigned int));
 
-
-
-        unsigned int* tempColorSlot = (unsigned int *) malloc (maxDegree * sizeof(unsigned int));
+        // a vertex can see at most maxDegree distinct colors, so one of the
+        // first maxDegree + 1 slots is always free
+        unsigned int numColorSlots = maxDegree + 1;
+        unsigned int* tempColorSlot = (unsigned int *) malloc (numColorSlots * sizeof(unsigned int));
 
         for (unsigned int i = 1; i < num_vertices; i++)
         {
@@ -52,24 +43,28 @@ void assignColor(Graph& lGraph, const unsigned int num_vertices)
 
         for (unsigned int i = 1; i < num_vertices; i++)
         {   
-            for (unsigned int j = 0; j < maxDegree; j++)
+            for (unsigned int j = 0; j < numColorSlots; j++)
             {
                 tempColorSlot[j] = 0;
             }
 
             printf("Working for vertex %d\n", i);
-            for (unsigned int j = 0; j < num_vertices; j++)
+
+            CompactGraph::NeighborRange lNeighbors = lCompactGraph.getNeighbors( i );
+            for( CompactGraph::NeighborRange::const_iterator lIter = lNeighbors.begin();
+                 lIter != lNeighbors.end();
+                 ++lIter )
             {
-                if ((lMatrix [ i * num_vertices + j] == 1) && (vertexColor[j] != -1))
+                unsigned int j = *lIter;
+                if (vertexColor[j] != -1)
                 {
                     printf("vertexColor[%d] is %d\n", j, vertexColor[j]);                 
                     tempColorSlot[vertexColor[j]] = 1;
-                    //printf("%d color match with %d\n", i, j);
                 }
             }
 
             //The first unused color slot is used to assign color to i
-            for (unsigned int j = 0; j < maxDegree; j++)
+            for (unsigned int j = 0; j < numColorSlots; j++)
             {
                 if (tempColorSlot[j] == 0)
                 {
@@ -81,12 +76,22 @@ void assignColor(Graph& lGraph, const unsigned int num_vertices)
 
         for (unsigned int j = 0; j < num_vertices; j++)
         {
+            uint64_t lVertexLabel = 0;
+            if( lGraph.getLabel( j, lVertexLabel ) )
+            {
+                printf( "colour of vertex %llu is %d\n", ( unsigned long long )lVertexLabel, vertexColor[j] );
+                continue;
+            }
+
             std::string lVertexName;
             lGraph.getName( j, lVertexName );
             printf( "colour of vertex %s is %d\n", 
                     lVertexName.c_str(), 
                     vertexColor[j]);
         }
+
+        free(tempColorSlot);
+        free(vertexColor);
     }
 
     getchar();
@@ -95,10 +100,10 @@ void assignColor(Graph& lGraph, const unsigned int num_vertices)
 int main(int argc, char **argv)
 {
     const char* lGraphData = FILENAME;
-    unsigned int* h_adj = NULL;
 
     Graph lGraph;
     GraphLoader lGraphLoader;
+    lGraph.setKeepEdgeList( false );
 
     if( !lGraphLoader.loadInput( lGraphData, lGraph ) )
     {
@@ -106,6 +111,8 @@ int main(int argc, char **argv)
         return 2;
     }
 
+#ifdef _DEBUG
+    unsigned int* h_adj = NULL;
     size_t lNumElems = 0;
     if( !lGraph.getAdjacencyMatrix( ( Graph::vertexId_t*& )h_adj, lNumElems ) )
     {
@@ -113,9 +120,9 @@ int main(int argc, char **argv)
         return 3;
     }
 
-#ifdef _DEBUG
     std::cout << "Adjacency Matrix" << std::endl;
-    lGraph.printMatrix( std::cout, ( const Graph::vertexId_t* )h_adj, lNumElems );
+    lGraph.printMatrix( std::cout, ( const Graph::vertexId_t* )h_adj );
+    lGraph.releaseMatrix( ( Graph::vertexId_t*& )h_adj );
 #endif
 
     const unsigned int num_vertices = lGraph.size();
@@ -0,0 +1,17 @@
+#ifndef _GRAPH_FWD_H_
+#define _GRAPH_FWD_H_
+
+#include <stdint.h>
+
+// Forward declarations of the graph types, which are templates on the
+// vertex id type. Graph, CompactGraph and ComplementView are the 32 bit
+// instantiations the host code uses by default.
+template< typename VertexId > class BasicGraph;
+template< typename VertexId > class BasicCompactGraph;
+template< typename VertexId > class BasicComplementView;
+
+typedef BasicGraph<uint32_t> Graph;
+typedef BasicCompactGraph<uint32_t> CompactGraph;
+typedef BasicComplementView<uint32_t> ComplementView;
+
+#endif
@@ -0,0 +1,857 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "graphGen.h"
+#include "graph.h"
+#include "parallelUtils.h"
+#include "vertexIdTraits.h"
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+
+    // Row and column of the pIdx-th pair of the lower triangle, rows
+    // ascending: ( 1, 0 ), ( 2, 0 ), ( 2, 1 ), ( 3, 0 ) ...
+    void getTrianglePair( uint64_t pIdx, uint64_t& rRow, uint64_t& rRowStart )
+    {
+        uint64_t lRow = ( uint64_t )( ( 1.0 + sqrt( 1.0 + 8.0 * ( double )pIdx ) ) / 2.0 );
+
+        // the square root is off by one near the top of the range
+        while( lRow > 1 && lRow * ( lRow - 1 ) / 2 > pIdx )
+        {
+            --lRow;
+        }
+        while( ( lRow + 1 ) * lRow / 2 <= pIdx )
+        {
+            ++lRow;
+        }
+
+        rRow = lRow;
+        rRowStart = lRow * ( lRow - 1 ) / 2;
+    }
+
+    // smallest w with w^pDims >= pCount
+    uint64_t getGridWidth( uint64_t pCount, unsigned int pDims )
+    {
+        uint64_t lWidth = ( uint64_t )pow( ( double )pCount, 1.0 / pDims );
+        for( ;; )
+        {
+            uint64_t lPower = 1;
+            for( unsigned int lDim = 0; lDim < pDims; ++lDim )
+            {
+                lPower *= lWidth;
+            }
+            if( lPower >= pCount )
+            {
+                break;
+            }
+            ++lWidth;
+        }
+        while( lWidth > 1 )
+        {
+            uint64_t lPower = 1;
+            for( unsigned int lDim = 0; lDim < pDims; ++lDim )
+            {
+                lPower *= lWidth - 1;
+            }
+            if( lPower < pCount )
+            {
+                break;
+            }
+            --lWidth;
+        }
+        return lWidth;
+    }
+
+    template< typename VertexId >
+    inline void addEdge( uint64_t pFirst, uint64_t pSecond, std::vector< std::pair<VertexId, VertexId> >& rEdges )
+    {
+        rEdges.push_back( std::pair<VertexId, VertexId>( ( VertexId )pFirst, ( VertexId )pSecond ) );
+    }
+
+    // Cell of every vertex of the geometric model, drawn like getPoint()
+    struct PlacePoints
+    {
+        PlacePoints( uint64_t pSeed, uint64_t pCellsPerSide, uint64_t* pCells )
+            : mSeed( pSeed ), mCellsPerSide( pCellsPerSide ), mCells( pCells )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lVertex = pBegin; lVertex < pEnd; ++lVertex )
+            {
+                CounterRng lRng( mSeed, lVertex );
+                uint64_t lX = ( uint64_t )( lRng.nextDouble() * mCellsPerSide );
+                uint64_t lY = ( uint64_t )( lRng.nextDouble() * mCellsPerSide );
+                mCells[lVertex] = std::min( lY, mCellsPerSide - 1 ) * mCellsPerSide + std::min( lX, mCellsPerSide - 1 );
+            }
+        }
+
+        uint64_t mSeed;
+        uint64_t mCellsPerSide;
+        uint64_t* mCells;
+    };
+
+    template< typename VertexId >
+    struct GenerateBlocks
+    {
+        typedef std::vector< std::pair<VertexId, VertexId> > edgeVec_t;
+
+        GenerateBlocks( const GraphGen& rGen, size_t pFirstBlock, std::vector<edgeVec_t>& rBlocks )
+            : mGen( rGen ), mFirstBlock( pFirstBlock ), mBlocks( rBlocks )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                mGen.generateBlock( mFirstBlock + lIdx, mBlocks[lIdx] );
+            }
+        }
+
+        const GraphGen& mGen;
+        size_t mFirstBlock;
+        std::vector<edgeVec_t>& mBlocks;
+    };
+
+    template< typename VertexId >
+    struct CopyBlocks
+    {
+        typedef std::pair<VertexId, VertexId> idPair_t;
+
+        CopyBlocks( std::vector< std::vector<idPair_t> >& rBlocks, const std::vector<size_t>& rOffsets, idPair_t* pEdges )
+            : mBlocks( rBlocks ), mOffsets( rOffsets ), mEdges( pEdges )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                std::copy( mBlocks[lIdx].begin(), mBlocks[lIdx].end(), mEdges + mOffsets[lIdx] );
+                std::vector<idPair_t>().swap( mBlocks[lIdx] );
+            }
+        }
+
+        std::vector< std::vector<idPair_t> >& mBlocks;
+        const std::vector<size_t>& mOffsets;
+        idPair_t* mEdges;
+    };
+}
+
+bool parseGraphModel( const char* pName, GraphModel_t& rModel )
+{
+    static const GraphModel_t sModels[] = { GRAPH_MODEL_ERDOS_RENYI, GRAPH_MODEL_RMAT, GRAPH_MODEL_BARABASI_ALBERT,
+                                            GRAPH_MODEL_GEOMETRIC, GRAPH_MODEL_GRID_2D, GRAPH_MODEL_GRID_3D,
+                                            GRAPH_MODEL_PLANTED, GRAPH_MODEL_MYCIELSKI, GRAPH_MODEL_CROWN };
+
+    for( size_t lIdx = 0; lIdx < sizeof( sModels ) / sizeof( sModels[0] ); ++lIdx )
+    {
+        if( 0 == strcmp( pName, getGraphModelName( sModels[lIdx] ) ) )
+        {
+            rModel = sModels[lIdx];
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* getGraphModelName( GraphModel_t pModel )
+{
+    switch( pModel )
+    {
+    case GRAPH_MODEL_RMAT:
+        return "rmat";
+    case GRAPH_MODEL_BARABASI_ALBERT:
+        return "ba";
+    case GRAPH_MODEL_GEOMETRIC:
+        return "geo";
+    case GRAPH_MODEL_GRID_2D:
+        return "grid2d";
+    case GRAPH_MODEL_GRID_3D:
+        return "grid3d";
+    case GRAPH_MODEL_PLANTED:
+        return "planted";
+    case GRAPH_MODEL_MYCIELSKI:
+        return "mycielski";
+    case GRAPH_MODEL_CROWN:
+        return "crown";
+    default:
+        return "er";
+    }
+}
+
+GraphGen::GraphGen( size_t pNumVertices, float pCompleteness, uint64_t pSeed )
+    : mModel( GRAPH_MODEL_ERDOS_RENYI )
+    , mNumVertices( pNumVertices )
+    , mCompleteness( pCompleteness )
+    , mSeed( pSeed )
+    , mEdgeFactor( 16 )
+    , mNumColors( 3 )
+    , mRmatA( 0.57 )
+    , mRmatB( 0.19 )
+    , mRmatC( 0.19 )
+    , mPrepared( false )
+    , mNumBlocks( 0 )
+    , mBlockSize( 1 )
+    , mNumUnits( 0 )
+    , mPairProbability( 0 )
+    , mCliquePairs( 0 )
+    , mRmatScale( 0 )
+    , mRadius( 0 )
+    , mCellsPerSide( 0 )
+    , mGridWidth( 0 )
+    , mGridLayer( 0 )
+    , mMycielskiOrder( 0 )
+{
+}
+
+bool GraphGen::prepare()
+{
+    mPrepared = false;
+    mNumBlocks = 0;
+    mBlockSize = 1;
+    mNumUnits = 0;
+    mPairProbability = 0;
+    mCliquePairs = 0;
+    mMycielskiOrder = 0;
+    std::vector<uint64_t>().swap( mCellStarts );
+    std::vector<uint64_t>().swap( mCellVertices );
+    mMycielskiVertices.clear();
+    mMycielskiEdges.clear();
+
+    uint64_t lNumVertices = mNumVertices;
+    if( 0 == mEdgeFactor && ( GRAPH_MODEL_RMAT == mModel || GRAPH_MODEL_BARABASI_ALBERT == mModel ||
+                              GRAPH_MODEL_GEOMETRIC == mModel || GRAPH_MODEL_PLANTED == mModel ) )
+    {
+        return false;
+    }
+
+    switch( mModel )
+    {
+    case GRAPH_MODEL_ERDOS_RENYI:
+        if( mCompleteness < 0 || mCompleteness > 1 )
+        {
+            return false;
+        }
+        // pairs, so that a block expects about GRAPH_GEN_BLOCK_EDGES edges
+        mPairProbability = mCompleteness;
+        mNumUnits = ( mPairProbability > 0 && lNumVertices > 1 ) ? lNumVertices * ( lNumVertices - 1 ) / 2 : 0;
+        mBlockSize = ( mPairProbability > 0 ) ? ( uint64_t )std::max( 1.0, GRAPH_GEN_BLOCK_EDGES / mPairProbability ) : 1;
+        break;
+
+    case GRAPH_MODEL_PLANTED:
+    {
+        // the clique needs a vertex per class
+        if( mNumColors < 2 || lNumVertices < mNumColors )
+        {
+            return false;
+        }
+        // edge factor * n edges over the pairs across classes, about
+        // ( k - 1 ) / k of them
+        double lNumPairs = ( double )lNumVertices * ( lNumVertices - 1 ) / 2;
+        double lCrossPairs = lNumPairs * ( mNumColors - 1 ) / mNumColors;
+        mPairProbability = std::min( 1.0, ( double )mEdgeFactor * lNumVertices / lCrossPairs );
+        mCliquePairs = ( uint64_t )mNumColors * ( mNumColors - 1 ) / 2;
+        mNumUnits = lNumVertices * ( lNumVertices - 1 ) / 2;
+        mBlockSize = ( uint64_t )std::max( 1.0, GRAPH_GEN_BLOCK_EDGES / mPairProbability );
+        break;
+    }
+
+    case GRAPH_MODEL_MYCIELSKI:
+        // M_1 is a vertex, M_2 an edge, M_j+1 adds a twin of every vertex
+        // of M_j, adjacent to its neighbors, and one vertex adjacent to the
+        // twins
+        if( lNumVertices > 0 )
+        {
+            mMycielskiVertices.push_back( 1 );
+            mMycielskiEdges.push_back( 0 );
+            if( lNumVertices > 1 )
+            {
+                mMycielskiVertices.push_back( 2 );
+                mMycielskiEdges.push_back( 1 );
+            }
+            while( 2 * mMycielskiVertices.back() + 1 <= lNumVertices )
+            {
+                uint64_t lVertices = mMycielskiVertices.back();
+                uint64_t lEdges = mMycielskiEdges.back();
+                mMycielskiVertices.push_back( 2 * lVertices + 1 );
+                mMycielskiEdges.push_back( 3 * lEdges + lVertices );
+            }
+            mMycielskiOrder = ( unsigned int )mMycielskiVertices.size();
+            mNumUnits = mMycielskiEdges.back();
+        }
+        mBlockSize = GRAPH_GEN_BLOCK_EDGES;
+        break;
+
+    case GRAPH_MODEL_CROWN:
+    {
+        // one vertex of the first side a unit, with its n / 2 - 1 edges
+        uint64_t lSide = lNumVertices / 2;
+        mNumUnits = ( lSide > 1 ) ? lSide : 0;
+        mBlockSize = std::max( ( uint64_t )1, GRAPH_GEN_BLOCK_EDGES / std::max( lSide, ( uint64_t )2 ) );
+        break;
+    }
+
+    case GRAPH_MODEL_RMAT:
+        if( mRmatA < 0 || mRmatB < 0 || mRmatC < 0 || mRmatA + mRmatB + mRmatC > 1 )
+        {
+            return false;
+        }
+        mRmatScale = 0;
+        while( ( ( uint64_t )1 << mRmatScale ) < lNumVertices )
+        {
+            ++mRmatScale;
+        }
+        mNumUnits = ( lNumVertices > 1 ) ? lNumVertices * mEdgeFactor : 0;
+        mBlockSize = GRAPH_GEN_BLOCK_EDGES;
+        break;
+
+    case GRAPH_MODEL_BARABASI_ALBERT:
+        // one target slot per edge, vertex 0 starts the graph
+        mNumUnits = ( lNumVertices > 1 ) ? ( lNumVertices - 1 ) * mEdgeFactor : 0;
+        mBlockSize = GRAPH_GEN_BLOCK_EDGES;
+        break;
+
+    case GRAPH_MODEL_GEOMETRIC:
+        if( !prepareGeometric() )
+        {
+            return false;
+        }
+        break;
+
+    case GRAPH_MODEL_GRID_2D:
+    case GRAPH_MODEL_GRID_3D:
+    {
+        unsigned int lDims = ( GRAPH_MODEL_GRID_2D == mModel ) ? 2 : 3;
+        mGridWidth = getGridWidth( lNumVertices, lDims );
+        mGridLayer = mGridWidth * mGridWidth;
+        mNumUnits = lNumVertices;
+        mBlockSize = GRAPH_GEN_BLOCK_EDGES / lDims;
+        break;
+    }
+    }
+
+    mNumBlocks = ( size_t )( ( mNumUnits + mBlockSize - 1 ) / mBlockSize );
+    mPrepared = true;
+    return true;
+}
+
+bool GraphGen::prepareGeometric()
+{
+    uint64_t lNumVertices = mNumVertices;
+    if( lNumVertices < 2 )
+    {
+        return true;
+    }
+
+    // pi r^2 n neighbors on average, border aside
+    mRadius = std::min( 1.0, sqrt( 2.0 * mEdgeFactor / ( PI * lNumVertices ) ) );
+    mCellsPerSide = std::max( ( uint64_t )1, ( uint64_t )( 1.0 / mRadius ) );
+    uint64_t lNumCells = mCellsPerSide * mCellsPerSide;
+
+    // counting sort of the vertices by cell, ascending within a cell
+    std::vector<uint64_t> lCells( lNumVertices );
+    PlacePoints lPlacer( mSeed, mCellsPerSide, &lCells[0] );
+    parallelFor( 0, lNumVertices, lPlacer );
+
+    mCellStarts.assign( lNumCells + 1, 0 );
+    for( uint64_t lVertex = 0; lVertex < lNumVertices; ++lVertex )
+    {
+        ++mCellStarts[lCells[lVertex]];
+    }
+    parallelExclusiveScan( &mCellStarts[0], &mCellStarts[0], mCellStarts.size() );
+
+    mCellVertices.resize( lNumVertices );
+    std::vector<uint64_t> lFill( mCellStarts.begin(), mCellStarts.end() - 1 );
+    for( uint64_t lVertex = 0; lVertex < lNumVertices; ++lVertex )
+    {
+        mCellVertices[lFill[lCells[lVertex]]++] = lVertex;
+    }
+
+    // cells, so that a block expects about GRAPH_GEN_BLOCK_EDGES edges
+    double lEdgesPerCell = ( double )mEdgeFactor * lNumVertices / lNumCells;
+    mNumUnits = lNumCells;
+    mBlockSize = ( uint64_t )std::max( 1.0, GRAPH_GEN_BLOCK_EDGES / std::max( lEdgesPerCell, 1e-9 ) );
+    return true;
+}
+
+uint64_t GraphGen::getPlantedColor( uint64_t pVertex ) const
+{
+    if( pVertex < mNumColors )
+    {
+        return pVertex;
+    }
+    // a stream apart from the blocks' and the points'
+    CounterRng lRng( ~mSeed, pVertex );
+    return lRng.nextBelow( mNumColors );
+}
+
+// Walks down from M_k to the level that adds the edge, noting the twin
+// copies on the way, then applies them on the way back up. The edges of
+// M_j+1 are those of M_j, then two per edge of M_j joining each end to the
+// other's twin, then the twins to the new vertex.
+void GraphGen::getMycielskiEdge( uint64_t pIdx, uint64_t& rFirst, uint64_t& rSecond ) const
+{
+    uint64_t lTwinOffsets[64];
+    bool lSwapped[64];
+    size_t lNumTwins = 0;
+
+    size_t lLevel = mMycielskiOrder - 1;
+    for( ;; )
+    {
+        // M_2 is the edge ( 0, 1 )
+        if( lLevel == 1 )
+        {
+            rFirst = 0;
+            rSecond = 1;
+            break;
+        }
+
+        uint64_t lInner = mMycielskiEdges[lLevel - 1];
+        uint64_t lInnerVertices = mMycielskiVertices[lLevel - 1];
+        if( pIdx >= 3 * lInner )
+        {
+            rFirst = lInnerVertices + ( pIdx - 3 * lInner );
+            rSecond = 2 * lInnerVertices;
+            break;
+        }
+        if( pIdx >= lInner )
+        {
+            lTwinOffsets[lNumTwins] = lInnerVertices;
+            lSwapped[lNumTwins] = ( 0 != ( ( pIdx - lInner ) & 1 ) );
+            ++lNumTwins;
+            pIdx = ( pIdx - lInner ) >> 1;
+        }
+        --lLevel;
+    }
+
+    while( lNumTwins )
+    {
+        --lNumTwins;
+        uint64_t lFirst = rFirst;
+        uint64_t lSecond = rSecond;
+        if( lSwapped[lNumTwins] )
+        {
+            std::swap( lFirst, lSecond );
+        }
+        rFirst = lFirst;
+        rSecond = lTwinOffsets[lNumTwins] + lSecond;
+    }
+}
+
+bool GraphGen::getChromaticBounds( uint64_t& rLower, uint64_t& rUpper ) const
+{
+    if( !mPrepared )
+    {
+        return false;
+    }
+
+    uint64_t lChromatic = 0;
+    switch( mModel )
+    {
+    case GRAPH_MODEL_PLANTED:
+        lChromatic = mNumColors;
+        break;
+    case GRAPH_MODEL_MYCIELSKI:
+        lChromatic = ( mNumVertices > 0 ) ? mMycielskiOrder : 0;
+        break;
+    case GRAPH_MODEL_CROWN:
+    case GRAPH_MODEL_GRID_2D:
+    case GRAPH_MODEL_GRID_3D:
+        // bipartite, an edge needs both colors
+        lChromatic = ( mNumUnits > 0 && mNumVertices > 1 ) ? 2 : std::min( mNumVertices, ( size_t )1 );
+        break;
+    default:
+        return false;
+    }
+
+    rLower = lChromatic;
+    rUpper = lChromatic;
+    return true;
+}
+
+void GraphGen::getPoint( uint64_t pVertex, double& rX, double& rY ) const
+{
+    CounterRng lRng( mSeed, pVertex );
+    rX = lRng.nextDouble();
+    rY = lRng.nextDouble();
+}
+
+template< typename VertexId >
+void GraphGen::generateBlock( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const
+{
+    rEdges.clear();
+    if( !mPrepared || pBlock >= mNumBlocks )
+    {
+        return;
+    }
+
+    switch( mModel )
+    {
+    case GRAPH_MODEL_ERDOS_RENYI:
+    case GRAPH_MODEL_PLANTED:
+        generateErdosRenyi( pBlock, rEdges );
+        break;
+    case GRAPH_MODEL_RMAT:
+        generateRmat( pBlock, rEdges );
+        break;
+    case GRAPH_MODEL_BARABASI_ALBERT:
+        generateBarabasiAlbert( pBlock, rEdges );
+        break;
+    case GRAPH_MODEL_GEOMETRIC:
+        generateGeometric( pBlock, rEdges );
+        break;
+    case GRAPH_MODEL_GRID_2D:
+    case GRAPH_MODEL_GRID_3D:
+        generateGrid( pBlock, rEdges );
+        break;
+    case GRAPH_MODEL_MYCIELSKI:
+        generateMycielski( pBlock, rEdges );
+        break;
+    case GRAPH_MODEL_CROWN:
+        generateCrown( pBlock, rEdges );
+        break;
+    }
+}
+
+// Every pair of the block's range of the lower triangle is an edge with
+// probability p. The gap to the next edge is geometric, drawn in one step,
+// so the cost follows the edges rather than the pairs. The planted model
+// takes the clique pairs first and drops the pairs within a class.
+template< typename VertexId >
+void GraphGen::generateErdosRenyi( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const
+{
+    uint64_t lBegin = pBlock * mBlockSize;
+    uint64_t lEnd = std::min( lBegin + mBlockSize, mNumUnits );
+    rEdges.reserve( ( size_t )( ( lEnd - lBegin ) * mPairProbability * 1.05 ) + 16 );
+
+    CounterRng lRng( mSeed, pBlock );
+    double lLogMiss = ( mPairProbability < 1 ) ? log( 1.0 - mPairProbability ) : 0;
+    const bool lPlanted = ( GRAPH_MODEL_PLANTED == mModel );
+
+    uint64_t lRow = 0;
+    uint64_t lRowStart = 0;
+    getTrianglePair( lBegin, lRow, lRowStart );
+
+    uint64_t lIdx = lBegin;
+    for( ; lIdx < std::min( lEnd, mCliquePairs ); ++lIdx )
+    {
+        if( lIdx - lRowStart >= lRow )
+        {
+            getTrianglePair( lIdx, lRow, lRowStart );
+        }
+        addEdge( lIdx - lRowStart, lRow, rEdges );
+    }
+
+    for( ;; )
+    {
+        if( mPairProbability < 1 )
+        {
+            // 1 - u in ( 0, 1 ]
+            double lSkip = floor( log( 1.0 - lRng.nextDouble() ) / lLogMiss );
+            if( lSkip >= ( double )( lEnd - lIdx ) )
+            {
+                break;
+            }
+            lIdx += ( uint64_t )lSkip;
+        }
+        if( lIdx >= lEnd )
+        {
+            break;
+        }
+
+        if( lIdx - lRowStart >= lRow )
+        {
+            getTrianglePair( lIdx, lRow, lRowStart );
+        }
+        if( !lPlanted || getPlantedColor( lIdx - lRowStart ) != getPlantedColor( lRow ) )
+        {
+            addEdge( lIdx - lRowStart, lRow, rEdges );
+        }
+        ++lIdx;
+    }
+}
+
+// Every edge descends the adjacency matrix quadrant by quadrant, picking
+// one with the a, b, c, d probabilities; 16 bits of a draw per level. Ids
+// past n and self loops are drawn again.
+template< typename VertexId >
+void GraphGen::generateRmat( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const
+{
+    uint64_t lBegin = pBlock * mBlockSize;
+    uint64_t lEnd = std::min( lBegin + mBlockSize, mNumUnits );
+    rEdges.reserve( ( size_t )( lEnd - lBegin ) );
+
+    const uint32_t lA = ( uint32_t )( mRmatA * 65536 );
+    const uint32_t lAB = ( uint32_t )( ( mRmatA + mRmatB ) * 65536 );
+    const uint32_t lABC = ( uint32_t )( ( mRmatA + mRmatB + mRmatC ) * 65536 );
+    const uint64_t lNumVertices = mNumVertices;
+
+    CounterRng lRng( mSeed, pBlock );
+    for( uint64_t lEdge = lBegin; lEdge < lEnd; ++lEdge )
+    {
+        uint64_t lRow = 0;
+        uint64_t lCol = 0;
+        do
+        {
+            lRow = 0;
+            lCol = 0;
+            uint64_t lBits = 0;
+            for( unsigned int lLevel = 0; lLevel < mRmatScale; ++lLevel )
+            {
+                if( 0 == ( lLevel & 3 ) )
+                {
+                    lBits = lRng.next();
+                }
+                uint32_t lDraw = ( uint32_t )( lBits & 0xFFFF );
+                lBits >>= 16;
+
+                // a: ( 0, 0 ), b: ( 0, 1 ), c: ( 1, 0 ), d: ( 1, 1 ), without
+                // branches the draws would mispredict
+                lRow = ( lRow << 1 ) | ( uint64_t )( lDraw >= lAB );
+                lCol = ( lCol << 1 ) | ( uint64_t )( ( lDraw >= lA ) & ( lDraw < lAB ) ) | ( uint64_t )( lDraw >= lABC );
+            }
+        }
+        while( lRow >= lNumVertices || lCol >= lNumVertices || lRow == lCol );
+
+        addEdge( lRow, lCol, rEdges );
+    }
+}
+
+// The edge list is an array of slots, source then target, where edge i
+// joins vertex i / m + 1 to the vertex in a uniform earlier slot. A target
+// slot is resolved by following its own draw back until a source slot, and
+// every draw hangs off the slot index, so any edge is found independently
+// (Sanders and Schulz). Edges onto their own source are dropped.
+template< typename VertexId >
+void GraphGen::generateBarabasiAlbert( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const
+{
+    uint64_t lBegin = pBlock * mBlockSize;
+    uint64_t lEnd = std::min( lBegin + mBlockSize, mNumUnits );
+    rEdges.reserve( ( size_t )( lEnd - lBegin ) );
+
+    const uint64_t lEdgesPerVertex = mEdgeFactor;
+    for( uint64_t lEdge = lBegin; lEdge < lEnd; ++lEdge )
+    {
+        uint64_t lSource = lEdge / lEdgesPerVertex + 1;
+
+        uint64_t lTarget = 0;
+        uint64_t lSlotEdge = lEdge;
+        while( lSlotEdge > 0 )
+        {
+            CounterRng lRng( mSeed, lSlotEdge );
+            uint64_t lSlot = lRng.nextBelow( 2 * lSlotEdge );
+            if( 0 == ( lSlot & 1 ) )
+            {
+                lTarget = ( lSlot / 2 ) / lEdgesPerVertex + 1;
+                break;
+            }
+            lSlotEdge = lSlot / 2;
+        }
+
+        if( lTarget != lSource )
+        {
+            addEdge( lTarget, lSource, rEdges );
+        }
+    }
+}
+
+// Points of a cell against the later points of the cell and the points of
+// the four cells ahead (right, and the three below), which finds every pair
+// closer than the radius once
+template< typename VertexId >
+void GraphGen::generateGeometric( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const
+{
+    static const int sAhead[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+
+    uint64_t lBegin = pBlock * mBlockSize;
+    uint64_t lEnd = std::min( lBegin + mBlockSize, mNumUnits );
+    const double lRadius2 = mRadius * mRadius;
+    const int64_t lSide = ( int64_t )mCellsPerSide;
+
+    for( uint64_t lCell = lBegin; lCell < lEnd; ++lCell )
+    {
+        int64_t lCellX = ( int64_t )( lCell % mCellsPerSide );
+        int64_t lCellY = ( int64_t )( lCell / mCellsPerSide );
+
+        for( uint64_t lPos = mCellStarts[lCell]; lPos < mCellStarts[lCell + 1]; ++lPos )
+        {
+            uint64_t lVertex = mCellVertices[lPos];
+            double lX = 0;
+            double lY = 0;
+            getPoint( lVertex, lX, lY );
+
+            for( int lNeighbor = -1; lNeighbor < 4; ++lNeighbor )
+            {
+                uint64_t lFirst = lPos + 1;
+                uint64_t lLast = mCellStarts[lCell + 1];
+                if( lNeighbor >= 0 )
+                {
+                    int64_t lX2 = lCellX + sAhead[lNeighbor][0];
+                    int64_t lY2 = lCellY + sAhead[lNeighbor][1];
+                    if( lX2 < 0 || lX2 >= lSide || lY2 >= lSide )
+                    {
+                        continue;
+                    }
+                    uint64_t lOther = ( uint64_t )( lY2 * lSide + lX2 );
+                    lFirst = mCellStarts[lOther];
+                    lLast = mCellStarts[lOther + 1];
+                }
+
+                for( uint64_t lOtherPos = lFirst; lOtherPos < lLast; ++lOtherPos )
+                {
+                    uint64_t lOtherVertex = mCellVertices[lOtherPos];
+                    double lOtherX = 0;
+                    double lOtherY = 0;
+                    getPoint( lOtherVertex, lOtherX, lOtherY );
+
+                    double lDx = lX - lOtherX;
+                    double lDy = lY - lOtherY;
+                    if( lDx * lDx + lDy * lDy < lRadius2 )
+                    {
+                        addEdge( std::min( lVertex, lOtherVertex ), std::max( lVertex, lOtherVertex ), rEdges );
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Every vertex links to the next one along each axis, rows cut short by n
+template< typename VertexId >
+void GraphGen::generateGrid( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const
+{
+    uint64_t lBegin = pBlock * mBlockSize;
+    uint64_t lEnd = std::min( lBegin + mBlockSize, mNumUnits );
+    const uint64_t lNumVertices = mNumVertices;
+    const bool lDeep = ( GRAPH_MODEL_GRID_3D == mModel );
+    rEdges.reserve( ( size_t )( lEnd - lBegin ) * ( lDeep ? 3 : 2 ) );
+
+    for( uint64_t lVertex = lBegin; lVertex < lEnd; ++lVertex )
+    {
+        uint64_t lX = lVertex % mGridWidth;
+        uint64_t lY = ( lVertex / mGridWidth ) % mGridWidth;
+
+        if( lX + 1 < mGridWidth && lVertex + 1 < lNumVertices )
+        {
+            addEdge( lVertex, lVertex + 1, rEdges );
+        }
+        if( ( lDeep ? lY + 1 < mGridWidth : true ) && lVertex + mGridWidth < lNumVertices )
+        {
+            addEdge( lVertex, lVertex + mGridWidth, rEdges );
+        }
+        if( lDeep && lVertex + mGridLayer < lNumVertices )
+        {
+            addEdge( lVertex, lVertex + mGridLayer, rEdges );
+        }
+    }
+}
+
+template< typename VertexId >
+void GraphGen::generateMycielski( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const
+{
+    uint64_t lBegin = pBlock * mBlockSize;
+    uint64_t lEnd = std::min( lBegin + mBlockSize, mNumUnits );
+    rEdges.reserve( ( size_t )( lEnd - lBegin ) );
+
+    for( uint64_t lIdx = lBegin; lIdx < lEnd; ++lIdx )
+    {
+        uint64_t lFirst = 0;
+        uint64_t lSecond = 0;
+        getMycielskiEdge( lIdx, lFirst, lSecond );
+        addEdge( lFirst, lSecond, rEdges );
+    }
+}
+
+// Vertex 2 i of the first side is adjacent to every 2 j + 1 of the second
+// but 2 i + 1
+template< typename VertexId >
+void GraphGen::generateCrown( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const
+{
+    uint64_t lBegin = pBlock * mBlockSize;
+    uint64_t lEnd = std::min( lBegin + mBlockSize, mNumUnits );
+    const uint64_t lSide = mNumUnits;
+    rEdges.reserve( ( size_t )( ( lEnd - lBegin ) * ( lSide - 1 ) ) );
+
+    for( uint64_t lFirst = lBegin; lFirst < lEnd; ++lFirst )
+    {
+        for( uint64_t lSecond = 0; lSecond < lSide; ++lSecond )
+        {
+            if( lSecond != lFirst )
+            {
+                addEdge( 2 * lFirst, 2 * lSecond + 1, rEdges );
+            }
+        }
+    }
+}
+
+template< typename VertexId >
+void GraphGen::generateBlocks( size_t pFirstBlock, size_t pNumBlocks, std::vector< std::vector< std::pair<VertexId, VertexId> > >& rBlocks ) const
+{
+    rBlocks.resize( pNumBlocks );
+    GenerateBlocks<VertexId> lGenerator( *this, pFirstBlock, rBlocks );
+    parallelFor( 0, pNumBlocks, lGenerator, 1 );
+}
+
+template< typename VertexId >
+bool GraphGen::generateEdges( std::vector< std::pair<VertexId, VertexId> >& rEdges )
+{
+    typedef std::pair<VertexId, VertexId> idPair_t;
+
+    rEdges.clear();
+    if( !fitsVertexId<VertexId>( mNumVertices ) || !prepare() )
+    {
+        return false;
+    }
+
+    // a batch of blocks at a time bounds the memory next to rEdges
+    size_t lBatchSize = 4 * ThreadPool::instance().getNumThreads();
+    std::vector< std::vector<idPair_t> > lBlocks;
+    std::vector<size_t> lOffsets;
+
+    for( size_t lFirst = 0; lFirst < mNumBlocks; lFirst += lBatchSize )
+    {
+        size_t lCount = std::min( lBatchSize, mNumBlocks - lFirst );
+        generateBlocks( lFirst, lCount, lBlocks );
+
+        lOffsets.resize( lCount );
+        for( size_t lIdx = 0; lIdx < lCount; ++lIdx )
+        {
+            lOffsets[lIdx] = lBlocks[lIdx].size();
+        }
+        size_t lStart = rEdges.size();
+        size_t lAdded = parallelExclusiveScan( &lOffsets[0], &lOffsets[0], lCount );
+        for( size_t lIdx = 0; lIdx < lCount; ++lIdx )
+        {
+            lOffsets[lIdx] += lStart;
+        }
+
+        rEdges.resize( lStart + lAdded );
+        if( lAdded )
+        {
+            CopyBlocks<VertexId> lCopier( lBlocks, lOffsets, &rEdges[0] );
+            parallelFor( 0, lCount, lCopier, 1 );
+        }
+    }
+    return true;
+}
+
+bool GraphGen::generate( Graph& rGraph )
+{
+    std::vector<Graph::idPair_t> lEdges;
+    return generateEdges( lEdges ) &&
+           rGraph.addNumberedVertices( mNumVertices, 0 ) &&
+           ( lEdges.empty() || rGraph.addEdges( &lEdges[0], lEdges.size() ) );
+}
+
+#define INSTANTIATE_GRAPH_GEN( VertexId ) \
+    template void GraphGen::generateBlock<VertexId>( size_t, std::vector< std::pair<VertexId, VertexId> >& ) const; \
+    template void GraphGen::generateBlocks<VertexId>( size_t, size_t, std::vector< std::vector< std::pair<VertexId, VertexId> > >& ) const; \
+    template bool GraphGen::generateEdges<VertexId>( std::vector< std::pair<VertexId, VertexId> >& );
+
+INSTANTIATE_GRAPH_GEN( uint16_t )
+INSTANTIATE_GRAPH_GEN( uint32_t )
+INSTANTIATE_GRAPH_GEN( uint64_t )
+
+// end of file
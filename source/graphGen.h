@@ -1,83 +1,234 @@
-#include "graph.h"
-#include <cmath>
-#include <ctime>
-#include <string>
-#include <sstream>
+#ifndef _GRAPH_GEN_H_
+#define _GRAPH_GEN_H_
 
-class GraphGen
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+#include "graphFwd.h"
+
+// Edges a generator block aims at. Blocks are the unit of parallel work and
+// of seeding; their layout depends on the model parameters only.
+#define GRAPH_GEN_BLOCK_EDGES ( 1 << 20 )
+
+enum GraphModel_t
+{
+    GRAPH_MODEL_ERDOS_RENYI,        // G(n, p), p the completeness
+    GRAPH_MODEL_RMAT,               // R-MAT / Kronecker, edge factor * n edges
+    GRAPH_MODEL_BARABASI_ALBERT,    // preferential attachment, edge factor edges per new vertex
+    GRAPH_MODEL_GEOMETRIC,          // unit square, radius for an average degree of 2 * edge factor
+    GRAPH_MODEL_GRID_2D,            // row major, ceil( sqrt( n ) ) vertices wide
+    GRAPH_MODEL_GRID_3D,            // row major, ceil( cbrt( n ) ) vertices wide and deep
+    GRAPH_MODEL_PLANTED,            // k random color classes, edge factor * n edges across them
+    GRAPH_MODEL_MYCIELSKI,          // the largest Mycielski graph on at most n vertices
+    GRAPH_MODEL_CROWN               // K( n / 2, n / 2 ) minus a perfect matching
+};
+
+bool parseGraphModel( const char* pName, GraphModel_t& rModel );
+
+const char* getGraphModelName( GraphModel_t pModel );
+
+// Counter based random numbers: every value is a hash (the SplitMix64
+// finalizer) of the seed, a stream number and a counter, so any piece of a
+// graph draws the same numbers whichever thread generates it and when.
+class CounterRng
 {
 public:
-    GraphGen( size_t pNumVertices, float pCompleteness = 0.5 ) 
-            : mNumVertices( pNumVertices )
-            , mCompleteness( pCompleteness )
-            , mNumEdges( 0 )
+    CounterRng( uint64_t pSeed, uint64_t pStream )
+        : mKey( mix( pSeed ^ mix( pStream + GOLDEN_GAMMA ) ) )
+        , mCounter( 0 )
+    {}
+
+    uint64_t next()
     {
-        time_t lNow = time( NULL );
-        ::srand( lNow );
+        return mix( mKey + ( ++mCounter ) * GOLDEN_GAMMA );
     }
 
-    bool generate( Graph& rGraph )
+    // Uniform in [0, 1)
+    double nextDouble()
     {
-        mNumEdges = mNumVertices * ( mNumVertices - 1 );
-        mNumEdges = mNumEdges >> 1;
-        mNumEdges *= mCompleteness;
-
-        for( size_t j = 0; j < mNumVertices; ++j )
-        {
-            std::stringstream lStrStream;
-            lStrStream << j;
-            Graph::vertexId_t lVertex;
-            rGraph.addVertex( lStrStream.str(), lVertex );
-        }
-
-        for( size_t i = 0; i < mNumEdges; ++i )
-        {
-            generateEdge( rGraph );
-        }
-
-        return true;
+        return ( next() >> 11 ) * ( 1.0 / 9007199254740992.0 );
     }
 
-private:
-    void getRandomVertexPair( Graph::idPair_t& rVertexPair )
+    // Uniform in [0, pBound), pBound > 0
+    uint64_t nextBelow( uint64_t pBound )
     {
-        Graph::vertexId_t lVertex1 = 0;
-        Graph::vertexId_t lVertex2 = 0;
+        return next() % pBound;
+    }
 
-        lVertex1 = getRandom();
-        lVertex2 = getRandom();
+    static uint64_t mix( uint64_t pValue )
+    {
+        pValue = ( pValue ^ ( pValue >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+        pValue = ( pValue ^ ( pValue >> 27 ) ) * 0x94D049BB133111EBull;
+        return pValue ^ ( pValue >> 31 );
+    }
+
+private:
+    static const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+    uint64_t mKey;
+    uint64_t mCounter;
+};
+
+// Generates random graphs on the vertices 0 .. n - 1. The edges come in
+// blocks, each a fixed piece of the graph drawing from its own random
+// streams, which run in parallel on the thread pool and are put together
+// in block order: the same seed gives the same graph for any number of
+// threads. Self loops are dropped; R-MAT and Barabasi-Albert may repeat an
+// edge, which a Graph keeps once.
+//
+// The planted, Mycielski and crown models, and the grids, come with a
+// known chromatic number, see getChromaticBounds(), so that the colors a
+// coloring uses can be compared with the optimum:
+//   planted   - every vertex gets one of k classes at random and the pairs
+//               across classes are edges with the same probability, a
+//               "quiet" planting as long as the average degree stays below
+//               about ( k - 1 )^2. Vertices 0 .. k - 1 take a class each
+//               and form a clique, so k colors are needed too.
+//   mycielski - triangle free with chromatic number k, k as large as the
+//               vertices allow; the vertices past it are isolated. The
+//               edges grow as about n^1.58.
+//   crown     - bipartite, but ids alternate between the sides so that
+//               first fit in id order needs n / 2 colors. An odd last
+//               vertex is isolated.
+class GraphGen
+{
+public:
+    GraphGen( size_t pNumVertices, float pCompleteness = 0.5, uint64_t pSeed = 0 );
+
+    void setModel( GraphModel_t pModel )
+    {
+        mModel = pModel;
+        mPrepared = false;
+    }
 
-        while( lVertex1 == lVertex2 )
-        {
-            lVertex2 = getRandom();
-        }
+    void setSeed( uint64_t pSeed )
+    {
+        mSeed = pSeed;
+        mPrepared = false;
+    }
 
-        rVertexPair = Graph::idPair_t( lVertex1, lVertex2 );
+    // Edges per vertex of R-MAT, Barabasi-Albert and the geometric model
+    void setEdgeFactor( size_t pEdgeFactor )
+    {
+        mEdgeFactor = pEdgeFactor;
+        mPrepared = false;
     }
 
-    bool generateEdge( Graph& rGraph )
+    // Color classes of the planted model
+    void setNumColors( size_t pNumColors )
     {
-        Graph::idPair_t vertexPair( 0, 0 );
-        getRandomVertexPair( vertexPair );
+        mNumColors = pNumColors;
+        mPrepared = false;
+    }
 
-        while( rGraph.isEdge( vertexPair.first, vertexPair.second ) )
-        {
-            getRandomVertexPair( vertexPair );
-        }
+    // Quadrant probabilities of R-MAT, the fourth is 1 - a - b - c
+    void setRmatProbabilities( double pA, double pB, double pC )
+    {
+        mRmatA = pA;
+        mRmatB = pB;
+        mRmatC = pC;
+        mPrepared = false;
+    }
 
-        rGraph.addEdge( vertexPair.first, vertexPair.second );
-        return true;
+    size_t getNumVertices() const
+    {
+        return mNumVertices;
     }
 
-private:
-    unsigned int getRandom()
+    // Lays the blocks out, and places the points of the geometric model.
+    // False for parameters the model cannot use.
+    bool prepare();
+
+    size_t getNumBlocks() const
     {
-        return ::rand() % mNumVertices;
+        return mNumBlocks;
     }
 
+    // Bounds on the chromatic number the model guarantees, equal when it is
+    // known, after prepare(). False for the random models without one.
+    bool getChromaticBounds( uint64_t& rLower, uint64_t& rUpper ) const;
+
+    // Replaces rEdges with the edges of block pBlock, after prepare()
+    template< typename VertexId >
+    void generateBlock( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const;
+
+    // Generates pNumBlocks blocks from pFirstBlock in parallel, one vector
+    // each, after prepare()
+    template< typename VertexId >
+    void generateBlocks( size_t pFirstBlock, size_t pNumBlocks, std::vector< std::vector< std::pair<VertexId, VertexId> > >& rBlocks ) const;
+
+    // Every edge, in block order. False if the ids do not fit VertexId.
+    template< typename VertexId >
+    bool generateEdges( std::vector< std::pair<VertexId, VertexId> >& rEdges );
+
+    // Numbered vertices and every edge in one addEdges batch
+    bool generate( Graph& rGraph );
+
+private:
+    template< typename VertexId >
+    void generateErdosRenyi( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const;
+    template< typename VertexId >
+    void generateRmat( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const;
+    template< typename VertexId >
+    void generateBarabasiAlbert( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const;
+    template< typename VertexId >
+    void generateGeometric( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const;
+    template< typename VertexId >
+    void generateGrid( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const;
+    template< typename VertexId >
+    void generateMycielski( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const;
+    template< typename VertexId >
+    void generateCrown( size_t pBlock, std::vector< std::pair<VertexId, VertexId> >& rEdges ) const;
+
+    bool prepareGeometric();
+    void getPoint( uint64_t pVertex, double& rX, double& rY ) const;
+    uint64_t getPlantedColor( uint64_t pVertex ) const;
+    void getMycielskiEdge( uint64_t pIdx, uint64_t& rFirst, uint64_t& rSecond ) const;
+
+    GraphModel_t mModel;
     size_t mNumVertices;
     float mCompleteness;
-    size_t mNumEdges;
+    uint64_t mSeed;
+    size_t mEdgeFactor;
+    size_t mNumColors;
+    double mRmatA;
+    double mRmatB;
+    double mRmatC;
+
+    bool mPrepared;
+    size_t mNumBlocks;
+
+    // what a block covers: pairs, edges, cells or vertices, by model
+    uint64_t mBlockSize;
+    uint64_t mNumUnits;
+
+    // Erdos-Renyi and planted: probability of an edge per pair
+    double mPairProbability;
+
+    // planted: the clique of one vertex per class, vertices 0 .. k - 1,
+    // takes the first pairs
+    uint64_t mCliquePairs;
+
+    // R-MAT: levels of the recursion
+    unsigned int mRmatScale;
+
+    // geometric: cells of the side of the radius or more, and the vertices
+    // of every cell
+    double mRadius;
+    uint64_t mCellsPerSide;
+    std::vector<uint64_t> mCellStarts;
+    std::vector<uint64_t> mCellVertices;
+
+    // grids: row width and layer size
+    uint64_t mGridWidth;
+    uint64_t mGridLayer;
+
+    // Mycielski: vertices and edges of M_1 .. M_k, k the order generated
+    unsigned int mMycielskiOrder;
+    std::vector<uint64_t> mMycielskiVertices;
+    std::vector<uint64_t> mMycielskiEdges;
 };
 
-// end of file
+#endif
@@ -1,23 +1,113 @@
-#include "graph.h"
 #include "graphGen.h"
+#include "graphGenWriter.h"
+#include "chromaticBounds.h"
+#include "parallelUtils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
-#include <string>
-#include <sstream>
+
+void usage( const char* pProgramName )
+{
+    std::cout << "usage : "
+              << pProgramName
+              << " [options] <number of vertices> [completeness factor (default 0.5)]"
+              << std::endl
+              << "options:" << std::endl
+              << "  --model <er|rmat|ba|geo|grid2d|grid3d|planted|mycielski|crown>" << std::endl
+              << "                    random model (default: er, G(n, p) with p the completeness)" << std::endl
+              << "                    planted: k random color classes, edges only across them" << std::endl
+              << "                    mycielski: the largest Mycielski graph on at most n vertices" << std::endl
+              << "                    crown: two sides minus a matching, ids alternating sides" << std::endl
+              << "  --edge-factor <k> edges per vertex of rmat, ba, geo and planted (default 16)" << std::endl
+              << "  --colors <k>      color classes of planted (default 3)" << std::endl
+              << "  --chromatic <file>" << std::endl
+              << "                    write the chromatic number of planted, mycielski, crown" << std::endl
+              << "                    and grid graphs to file, for graphColor --chromatic" << std::endl
+              << "  --seed <n>        seed, the same seed gives the same graph on any number of" << std::endl
+              << "                    threads (default: the time, printed to stderr)" << std::endl
+              << "  --threads <n>     generator threads (default: all hardware threads)" << std::endl
+              << "  --binary <file>   write a binary graph file instead of the edge list on stdout" << std::endl
+              << "  --memory <MB>     neighbor bytes a --binary write holds at once, less takes more" << std::endl
+              << "                    passes (default 1024)" << std::endl
+              << "  --id-bytes <0|2|4|8>" << std::endl
+              << "                    id width of a --binary file; 4, the default, is mapped in" << std::endl
+              << "                    place by graphColor svis, jp and spec, 0 picks the narrowest," << std::endl
+              << "                    mapped by vis --implicit" << std::endl
+              << "the edge list is streamed as generated, so rmat and ba may repeat an edge" << std::endl;
+}
 
 int main( int argc, char* argv[] )
 {
+    const char* lProgramName = argv[0];
+    GraphModel_t lModel = GRAPH_MODEL_ERDOS_RENYI;
+    size_t lEdgeFactor = 16;
+    size_t lNumColors = 3;
+    const char* lChromaticFile = NULL;
+    uint64_t lSeed = ( uint64_t )time( NULL );
+    bool lSeedGiven = false;
+    const char* lBinaryFile = NULL;
+    size_t lMemoryBytes = GRAPH_GEN_WRITER_MEMORY;
+    size_t lIdBytes = GRAPH_GEN_WRITER_ID_BYTES;
+
+    // options come before the positional arguments
+    while( argc > 1 && 0 == strncmp( argv[1], "--", 2 ) )
+    {
+        if( 0 == strcmp( argv[1], "--model" ) && argc > 2 && parseGraphModel( argv[2], lModel ) )
+        {
+        }
+        else if( 0 == strcmp( argv[1], "--edge-factor" ) && argc > 2 && atoi( argv[2] ) > 0 )
+        {
+            lEdgeFactor = atoi( argv[2] );
+        }
+        else if( 0 == strcmp( argv[1], "--colors" ) && argc > 2 && atoi( argv[2] ) > 0 )
+        {
+            lNumColors = atoi( argv[2] );
+        }
+        else if( 0 == strcmp( argv[1], "--chromatic" ) && argc > 2 )
+        {
+            lChromaticFile = argv[2];
+        }
+        else if( 0 == strcmp( argv[1], "--seed" ) && argc > 2 )
+        {
+            lSeed = strtoull( argv[2], NULL, 10 );
+            lSeedGiven = true;
+        }
+        else if( 0 == strcmp( argv[1], "--threads" ) && argc > 2 && atoi( argv[2] ) > 0 )
+        {
+            ThreadPool::setDefaultNumThreads( atoi( argv[2] ) );
+        }
+        else if( 0 == strcmp( argv[1], "--binary" ) && argc > 2 )
+        {
+            lBinaryFile = argv[2];
+        }
+        else if( 0 == strcmp( argv[1], "--memory" ) && argc > 2 && atoi( argv[2] ) > 0 )
+        {
+            lMemoryBytes = ( size_t )atoi( argv[2] ) * 1024 * 1024;
+        }
+        else if( 0 == strcmp( argv[1], "--id-bytes" ) && argc > 2 )
+        {
+            lIdBytes = ( size_t )atoi( argv[2] );
+        }
+        else
+        {
+            usage( lProgramName );
+            return 1;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+
     if( argc < 2 )
     {
-        std::cout << "usage : " 
-                  << argv[0] 
-                  << " <number of vertices> [completeness factor (default 0.5)]" 
-                  << std::endl;
+        usage( lProgramName );
         return 1;
     }
 
     bool lCompletenessProvided = ( argc == 3 );
 
-    size_t lNumVertices = atoi( argv[1] );
+    size_t lNumVertices = ( size_t )strtoull( argv[1], NULL, 10 );
 
     float lCompleteness = 0.5;
     if( lCompletenessProvided )
@@ -25,18 +115,55 @@ int main( int argc, char* argv[] )
         lCompleteness = atof( argv[2] );
     }
 
-    GraphGen lGenerator( lNumVertices, lCompleteness );
+    if( !lSeedGiven )
+    {
+        std::cerr << "seed " << lSeed << std::endl;
+    }
+
+    GraphGen lGenerator( lNumVertices, lCompleteness, lSeed );
+    lGenerator.setModel( lModel );
+    lGenerator.setEdgeFactor( lEdgeFactor );
+    lGenerator.setNumColors( lNumColors );
 
-    Graph lGraph;
-    lGenerator.generate( lGraph );
+    // refused before anything is generated
+    ChromaticBounds lBounds;
+    if( lChromaticFile )
+    {
+        uint64_t lLower = 0;
+        uint64_t lUpper = 0;
+        if( !lGenerator.prepare() || !lGenerator.getChromaticBounds( lLower, lUpper ) )
+        {
+            std::cerr << "The chromatic number of " << getGraphModelName( lModel ) << " graphs with these parameters is not known" << std::endl;
+            return 3;
+        }
+        lBounds = ChromaticBounds( lLower, lUpper );
+    }
 
-    std::stringstream lStrStream;
+    GraphGenWriter lWriter( lGenerator );
+    bool lWritten = lBinaryFile ? lWriter.writeBinary( lBinaryFile, lMemoryBytes, lIdBytes ) : lWriter.writeEdgeList( stdout );
+    if( !lWritten )
+    {
+        std::cerr << "Unable to generate a " << getGraphModelName( lModel ) << " graph with these parameters";
+        if( lBinaryFile )
+        {
+            std::cerr << " into " << lBinaryFile;
+        }
+        std::cerr << std::endl;
+        return 2;
+    }
 
-    lGraph.print( lStrStream );
+    if( lBinaryFile )
+    {
+        std::cerr << "Wrote " << lWriter.getNumBytes() << " neighbor bytes of "
+                  << lWriter.getNumEdges() << " generated edges in " << lWriter.getNumPasses() << " passes, "
+                  << lWriter.getElapsedMs() << " ms" << std::endl;
+    }
 
-    std::cout << lStrStream.str();
+    if( lChromaticFile && !lBounds.write( lChromaticFile, getGraphModelName( lModel ), lNumVertices, lSeed ) )
+    {
+        std::cerr << "Unable to write " << lChromaticFile << std::endl;
+        return 3;
+    }
 
     return 0;
 }
-
-
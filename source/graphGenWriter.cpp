@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <utility>
+
+#include "graphGenWriter.h"
+#include "graphGen.h"
+#include "binaryGraph.h"
+#include "parallelUtils.h"
+#include "vertexIdTraits.h"
+
+namespace
+{
+    // Widest "a, b\n" line: two 20 digit ids
+    const size_t MAX_LINE_BYTES = 2 * 20 + 3;
+
+    char* appendId( uint64_t pId, char* pOut )
+    {
+        char lDigits[20];
+        size_t lNumDigits = 0;
+        do
+        {
+            lDigits[lNumDigits++] = ( char )( '0' + pId % 10 );
+            pId /= 10;
+        }
+        while( pId );
+
+        while( lNumDigits )
+        {
+            *pOut++ = lDigits[--lNumDigits];
+        }
+        return pOut;
+    }
+
+    // Formats every block of a batch into its own text buffer
+    template< typename VertexId >
+    struct FormatBlocks
+    {
+        typedef std::vector< std::pair<VertexId, VertexId> > edgeVec_t;
+
+        FormatBlocks( const std::vector<edgeVec_t>& rBlocks, std::vector< std::vector<char> >& rTexts )
+            : mBlocks( rBlocks ), mTexts( rTexts )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                const edgeVec_t& rEdges = mBlocks[lIdx];
+                std::vector<char>& rText = mTexts[lIdx];
+
+                rText.resize( rEdges.size() * MAX_LINE_BYTES + 1 );
+                char* lOut = &rText[0];
+                for( size_t lEdge = 0; lEdge < rEdges.size(); ++lEdge )
+                {
+                    lOut = appendId( rEdges[lEdge].first, lOut );
+                    *lOut++ = ',';
+                    *lOut++ = ' ';
+                    lOut = appendId( rEdges[lEdge].second, lOut );
+                    *lOut++ = '\n';
+                }
+                rText.resize( lOut - &rText[0] );
+            }
+        }
+
+        const std::vector<edgeVec_t>& mBlocks;
+        std::vector< std::vector<char> >& mTexts;
+    };
+
+    // Sorts the rows of a slice, drops the repeats and leaves every row's
+    // new degree in pDegrees. Row pRow spans the pDegrees[pRow] ids before
+    // pRowEnds[pRow].
+    template< typename VertexId >
+    struct SortRows
+    {
+        SortRows( VertexId* pNeighbors, const uint64_t* pRowEnds, uint64_t* pDegrees )
+            : mNeighbors( pNeighbors ), mRowEnds( pRowEnds ), mDegrees( pDegrees )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lRow = pBegin; lRow < pEnd; ++lRow )
+            {
+                VertexId* lEnd = mNeighbors + mRowEnds[lRow];
+                VertexId* lBegin = lEnd - mDegrees[lRow];
+                std::sort( lBegin, lEnd );
+                mDegrees[lRow] = std::unique( lBegin, lEnd ) - lBegin;
+            }
+        }
+
+        VertexId* mNeighbors;
+        const uint64_t* mRowEnds;
+        uint64_t* mDegrees;
+    };
+
+    struct WriteEdgeListAs
+    {
+        WriteEdgeListAs( GraphGenWriter& rWriter, FILE* pFile )
+            : mWriter( rWriter ), mFile( pFile )
+        {}
+
+        template< typename VertexId >
+        bool run()
+        {
+            return mWriter.writeEdgeListAs<VertexId>( mFile );
+        }
+
+        GraphGenWriter& mWriter;
+        FILE* mFile;
+    };
+
+    struct WriteBinaryAs
+    {
+        WriteBinaryAs( GraphGenWriter& rWriter, const char* pFilename, size_t pMemoryBytes )
+            : mWriter( rWriter ), mFilename( pFilename ), mMemoryBytes( pMemoryBytes )
+        {}
+
+        template< typename VertexId >
+        bool run()
+        {
+            return mWriter.writeBinaryAs<VertexId>( mFilename, mMemoryBytes );
+        }
+
+        GraphGenWriter& mWriter;
+        const char* mFilename;
+        size_t mMemoryBytes;
+    };
+}
+
+GraphGenWriter::GraphGenWriter( GraphGen& rGenerator )
+    : mGenerator( rGenerator )
+    , mNumEdges( 0 )
+    , mNumPasses( 0 )
+    , mNumBytes( 0 )
+    , mElapsedMs( 0 )
+{
+}
+
+bool GraphGenWriter::writeEdgeList( FILE* pFile )
+{
+    WriteEdgeListAs lWrite( *this, pFile );
+    return dispatchOnVertexCount( mGenerator.getNumVertices(), lWrite );
+}
+
+template< typename VertexId >
+bool GraphGenWriter::writeEdgeListAs( FILE* pFile )
+{
+    typedef std::pair<VertexId, VertexId> idPair_t;
+
+    WallTimer lTimer;
+    mNumEdges = 0;
+    mNumPasses = 0;
+    mNumBytes = 0;
+    if( !fitsVertexId<VertexId>( mGenerator.getNumVertices() ) || !mGenerator.prepare() )
+    {
+        return false;
+    }
+
+    // the blocks of a batch are formatted in parallel, then written in
+    // block order while nothing else is held
+    const size_t lNumBlocks = mGenerator.getNumBlocks();
+    const size_t lBatchSize = 4 * ThreadPool::instance().getNumThreads();
+    std::vector< std::vector<idPair_t> > lBlocks;
+    std::vector< std::vector<char> > lTexts( lBatchSize );
+
+    for( size_t lFirst = 0; lFirst < lNumBlocks; lFirst += lBatchSize )
+    {
+        size_t lCount = std::min( lBatchSize, lNumBlocks - lFirst );
+        mGenerator.generateBlocks( lFirst, lCount, lBlocks );
+
+        FormatBlocks<VertexId> lFormatter( lBlocks, lTexts );
+        parallelFor( 0, lCount, lFormatter, 1 );
+
+        for( size_t lIdx = 0; lIdx < lCount; ++lIdx )
+        {
+            const std::vector<char>& rText = lTexts[lIdx];
+            if( !rText.empty() && fwrite( &rText[0], 1, rText.size(), pFile ) != rText.size() )
+            {
+                return false;
+            }
+            mNumEdges += lBlocks[lIdx].size();
+            mNumBytes += rText.size();
+        }
+    }
+    mNumPasses = 1;
+    mElapsedMs = lTimer.getElapsedMs();
+
+    return ( 0 == fflush( pFile ) );
+}
+
+bool GraphGenWriter::writeBinary( const char* pFilename, size_t pMemoryBytes, size_t pIdBytes )
+{
+    WriteBinaryAs lWrite( *this, pFilename, pMemoryBytes );
+    return dispatchOnIdBytes( pIdBytes, mGenerator.getNumVertices(), lWrite );
+}
+
+template< typename VertexId >
+bool GraphGenWriter::writeBinaryAs( const char* pFilename, size_t pMemoryBytes )
+{
+    typedef std::pair<VertexId, VertexId> idPair_t;
+
+    WallTimer lTimer;
+    mNumEdges = 0;
+    mNumPasses = 0;
+    mNumBytes = 0;
+    const size_t lNumVertices = mGenerator.getNumVertices();
+    if( !fitsVertexId<VertexId>( lNumVertices ) || !mGenerator.prepare() )
+    {
+        return false;
+    }
+
+    const size_t lNumBlocks = mGenerator.getNumBlocks();
+    const size_t lBatchSize = 4 * ThreadPool::instance().getNumThreads();
+    std::vector< std::vector<idPair_t> > lBlocks;
+
+    // counting pass: the degrees, repeats included, which bound the rows;
+    // they become the degrees without repeats and then the offsets
+    std::vector<uint64_t> lOffsets( lNumVertices + 1, 0 );
+    for( size_t lFirst = 0; lFirst < lNumBlocks; lFirst += lBatchSize )
+    {
+        size_t lCount = std::min( lBatchSize, lNumBlocks - lFirst );
+        mGenerator.generateBlocks( lFirst, lCount, lBlocks );
+        for( size_t lIdx = 0; lIdx < lCount; ++lIdx )
+        {
+            const std::vector<idPair_t>& rEdges = lBlocks[lIdx];
+            for( size_t lEdge = 0; lEdge < rEdges.size(); ++lEdge )
+            {
+                ++lOffsets[rEdges[lEdge].first];
+                ++lOffsets[rEdges[lEdge].second];
+            }
+            mNumEdges += rEdges.size();
+        }
+    }
+    mNumPasses = 1;
+
+    BinaryGraphWriter lWriter;
+    if( !lWriter.open( pFilename, lNumVertices, sizeof( VertexId ) ) )
+    {
+        return false;
+    }
+
+    const uint64_t lBudget = std::max<uint64_t>( pMemoryBytes / sizeof( VertexId ), 1 );
+    std::vector<VertexId> lNeighbors;
+    std::vector<uint64_t> lCursors;
+    size_t lMaxDegree = 0;
+
+    // one pass per slice of rows, a slice holding at least one row
+    for( size_t lBegin = 0; lBegin < lNumVertices; )
+    {
+        size_t lEnd = lBegin;
+        uint64_t lSliceIds = 0;
+        do
+        {
+            lSliceIds += lOffsets[lEnd++];
+        }
+        while( lEnd < lNumVertices && lSliceIds + lOffsets[lEnd] <= lBudget );
+
+        // the cursors start at the row starts and end at the row ends
+        lCursors.resize( lEnd - lBegin );
+        uint64_t lStart = 0;
+        for( size_t lRow = 0; lRow < lCursors.size(); ++lRow )
+        {
+            lCursors[lRow] = lStart;
+            lStart += lOffsets[lBegin + lRow];
+        }
+        lNeighbors.resize( ( size_t )lSliceIds );
+
+        for( size_t lFirst = 0; lFirst < lNumBlocks; lFirst += lBatchSize )
+        {
+            size_t lCount = std::min( lBatchSize, lNumBlocks - lFirst );
+            mGenerator.generateBlocks( lFirst, lCount, lBlocks );
+            for( size_t lIdx = 0; lIdx < lCount; ++lIdx )
+            {
+                const std::vector<idPair_t>& rEdges = lBlocks[lIdx];
+                for( size_t lEdge = 0; lEdge < rEdges.size(); ++lEdge )
+                {
+                    size_t lFrom = rEdges[lEdge].first;
+                    size_t lTo = rEdges[lEdge].second;
+                    if( lFrom >= lBegin && lFrom < lEnd )
+                    {
+                        lNeighbors[( size_t )lCursors[lFrom - lBegin]++] = ( VertexId )lTo;
+                    }
+                    if( lTo >= lBegin && lTo < lEnd )
+                    {
+                        lNeighbors[( size_t )lCursors[lTo - lBegin]++] = ( VertexId )lFrom;
+                    }
+                }
+            }
+        }
+        ++mNumPasses;
+
+        if( lSliceIds )
+        {
+            SortRows<VertexId> lSorter( &lNeighbors[0], &lCursors[0], &lOffsets[lBegin] );
+            parallelFor( 0, lEnd - lBegin, lSorter );
+
+            // close the gaps the repeats left
+            uint64_t lKept = 0;
+            for( size_t lRow = 0; lRow < lCursors.size(); ++lRow )
+            {
+                uint64_t lDegree = lOffsets[lBegin + lRow];
+                uint64_t lRowBegin = lRow ? lCursors[lRow - 1] : 0;
+                if( lRowBegin != lKept )
+                {
+                    memmove( &lNeighbors[( size_t )lKept], &lNeighbors[( size_t )lRowBegin], ( size_t )lDegree * sizeof( VertexId ) );
+                }
+                lKept += lDegree;
+                lMaxDegree = std::max( lMaxDegree, ( size_t )lDegree );
+            }
+
+            if( !lWriter.appendNeighbors( &lNeighbors[0], ( size_t )lKept ) )
+            {
+                return false;
+            }
+        }
+        lBegin = lEnd;
+    }
+
+    lOffsets[lNumVertices] = parallelExclusiveScan( &lOffsets[0], &lOffsets[0], lNumVertices );
+    mNumBytes = ( uint64_t )lWriter.getNumAdjacencies() * sizeof( VertexId );
+    bool lRet = lWriter.close( &lOffsets[0], lMaxDegree );
+    mElapsedMs = lTimer.getElapsedMs();
+
+    return lRet;
+}
+
+#define INSTANTIATE_GRAPH_GEN_WRITER( VertexId ) \
+    template bool GraphGenWriter::writeEdgeListAs<VertexId>( FILE* ); \
+    template bool GraphGenWriter::writeBinaryAs<VertexId>( const char*, size_t );
+
+INSTANTIATE_GRAPH_GEN_WRITER( uint16_t )
+INSTANTIATE_GRAPH_GEN_WRITER( uint32_t )
+INSTANTIATE_GRAPH_GEN_WRITER( uint64_t )
+
+// end of file
@@ -0,0 +1,78 @@
+#ifndef _GRAPH_GEN_WRITER_H_
+#define _GRAPH_GEN_WRITER_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <stdint.h>
+
+class GraphGen;
+
+// Neighbor bytes a binary write may hold at once unless told otherwise
+#define GRAPH_GEN_WRITER_MEMORY ( ( size_t )1024 * 1024 * 1024 )
+
+// Id bytes of a binary write unless told otherwise: the width whose CSR
+// the host coloring engines map in place
+#define GRAPH_GEN_WRITER_ID_BYTES 4
+
+// Writes what a GraphGen generates straight to a file, without a Graph in
+// between: no vertex names, no adjacency sets, and never more than a
+// batch of blocks, and for the binary format a slice of the rows, in
+// memory. Graphs larger than the host memory can be written this way.
+class GraphGenWriter
+{
+public:
+    GraphGenWriter( GraphGen& rGenerator );
+
+    // "a, b" lines, in block order. R-MAT and Barabasi-Albert repeats are
+    // written as generated, the loaders keep them once.
+    bool writeEdgeList( FILE* pFile );
+
+    template< typename VertexId >
+    bool writeEdgeListAs( FILE* pFile );
+
+    // A binary graph file with pIdBytes wide ids, the narrowest that fit if
+    // 0. A counting pass sizes the rows; then every slice of rows whose
+    // neighbors fit in pMemoryBytes takes one more pass, which generates
+    // the graph again, keeps the edges ending in the slice, and writes the
+    // rows sorted and without repeats. The offsets, 8 bytes a vertex, stay
+    // in memory.
+    bool writeBinary( const char* pFilename,
+                      size_t pMemoryBytes = GRAPH_GEN_WRITER_MEMORY,
+                      size_t pIdBytes = GRAPH_GEN_WRITER_ID_BYTES );
+
+    template< typename VertexId >
+    bool writeBinaryAs( const char* pFilename, size_t pMemoryBytes );
+
+    uint64_t getNumEdges() const
+    {
+        return mNumEdges;
+    }
+
+    // Passes over the generator the last write took
+    size_t getNumPasses() const
+    {
+        return mNumPasses;
+    }
+
+    uint64_t getNumBytes() const
+    {
+        return mNumBytes;
+    }
+
+    double getElapsedMs() const
+    {
+        return mElapsedMs;
+    }
+
+private:
+    GraphGen& mGenerator;
+
+    // edges generated, repeats included, adjacencies written for the
+    // binary format
+    uint64_t mNumEdges;
+    size_t mNumPasses;
+    uint64_t mNumBytes;
+    double mElapsedMs;
+};
+
+#endif
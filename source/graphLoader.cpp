@@ -1,85 +1,341 @@
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <deque>
+#include <vector>
 #include <algorithm>
-#include <iostream>
-#include <fstream>
-#include <functional>
 
 #include "graphLoader.h"
 #include "graph.h"
+#include "mappedFile.h"
+#include "parallelUtils.h"
+#include "textChunks.h"
+#include "decompressStream.h"
 
-#define MAX_LINE_SIZE 256
-
-bool GraphLoader::loadInput( const char* pFilename, Graph& rGraph )
+namespace
 {
-    bool lRet = false;
+    enum TokenKind_t
+    {
+        TOKEN_VERTEX,
+        TOKEN_EDGE_FIRST,
+        TOKEN_EDGE_SECOND
+    };
+
+    // A vertex name found by the scanner, hashed on the parser thread
+    struct NameToken
+    {
+        const char* mName;
+        uint32_t mLength;
+        NameInterner::hash_t mHash;
+        unsigned char mKind;
+    };
+
+    struct ParsedChunk
+    {
+        std::vector<NameToken> mTokens;
+
+        // names that had spaces inside, stored without them
+        std::deque<std::string> mCleanNames;
+
+        void clear()
+        {
+            mTokens.clear();
+            mCleanNames.clear();
+        }
+    };
 
-    std::ifstream lInput;
-    lInput.open( pFilename );
-    if( lInput.is_open() )
+    // characters the line syntax drops wherever they are
+    inline bool isIgnored( char pChar )
     {
-        char lLine[MAX_LINE_SIZE] = { 0 };
+        return ( ' ' == pChar ) || ( '\r' == pChar );
+    }
 
-        while( lInput.getline( lLine, MAX_LINE_SIZE ) )
+    // Returns false for a field that is empty once the ignored characters
+    // are dropped
+    bool scanName( const char* pBegin, const char* pEnd, unsigned char pKind, ParsedChunk& rChunk )
+    {
+        while( pBegin < pEnd && isIgnored( *pBegin ) )
+        {
+            ++pBegin;
+        }
+        while( pEnd > pBegin && isIgnored( pEnd[-1] ) )
+        {
+            --pEnd;
+        }
+        if( pBegin == pEnd )
+        {
+            return false;
+        }
+
+        NameToken lToken;
+        lToken.mName = pBegin;
+        lToken.mKind = pKind;
+
+        // the common name has nothing to drop and is used in place
+        const char* lIter = pBegin;
+        while( lIter < pEnd && !isIgnored( *lIter ) )
+        {
+            ++lIter;
+        }
+        if( lIter != pEnd )
         {
-            // remove newline at end
-            std::string lStr = lLine;
-            lStr.erase( std::remove_if( lStr.begin(), 
-                                        lStr.end(), 
-                                        std::bind2nd( std::equal_to<char>(), '\n' ) ),
-                        lStr.end() );
-
-            lStr.erase( std::remove_if( lStr.begin(), 
-                                        lStr.end(), 
-                                        std::bind2nd( std::equal_to<char>(), ' ' ) ),
-                        lStr.end() );
-
-            if( lStr.empty() )
+            rChunk.mCleanNames.push_back( std::string() );
+            std::string& rClean = rChunk.mCleanNames.back();
+            for( lIter = pBegin; lIter < pEnd; ++lIter )
             {
-                continue;
+                if( !isIgnored( *lIter ) )
+                {
+                    rClean.push_back( *lIter );
+                }
             }
+            lToken.mName = rClean.data();
+            pEnd = lToken.mName + rClean.size();
+        }
 
-            if( Graph::COMMENT_CHAR == lStr[0] )
-            {
-                continue;
-            }                
-            
-            std::string lVertex1;
-            std::string lVertex2;
-            Graph::vertexId_t lId1;
-            Graph::vertexId_t lId2;
+        lToken.mLength = ( uint32_t )( pEnd - lToken.mName );
+        lToken.mHash = NameInterner::hash( lToken.mName, lToken.mLength );
+        rChunk.mTokens.push_back( lToken );
+        return true;
+    }
 
-            std::string::size_type lCommaPos = lStr.find( ',' );
+    // Parses the lines of chunk pChunkIdx, chunk boundaries always follow
+    // a newline
+    struct ParseChunks
+    {
+        ParseChunks( const char* pData, const std::vector<size_t>& rBounds, size_t pFirstChunk, std::vector<ParsedChunk>& rChunks )
+            : mData( pData ), mBounds( rBounds ), mFirstChunk( pFirstChunk ), mChunks( rChunks )
+        {}
 
-            if( lCommaPos != std::string::npos )
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
             {
-                lVertex1 = std::string( lStr, 0, lCommaPos );
-                lVertex2 = std::string( lStr, lCommaPos + 1 );
+                parse( mData + mBounds[mFirstChunk + lIdx], mData + mBounds[mFirstChunk + lIdx + 1], mChunks[lIdx] );
             }
-            else
+        }
+
+        static void parse( const char* pBegin, const char* pEnd, ParsedChunk& rChunk )
+        {
+            rChunk.clear();
+
+            while( pBegin < pEnd )
             {
-                lVertex1 = lStr;
+                const char* lLineEnd = findLineEnd( pBegin, pEnd );
+
+                const char* lFirst = pBegin;
+                while( lFirst < lLineEnd && isIgnored( *lFirst ) )
+                {
+                    ++lFirst;
+                }
+
+                if( lFirst < lLineEnd && Graph::COMMENT_CHAR != *lFirst )
+                {
+                    // first comma splits the line, the rest is the second name
+                    const char* lComma = ( const char* )memchr( lFirst, ',', lLineEnd - lFirst );
+                    if( !lComma )
+                    {
+                        scanName( lFirst, lLineEnd, TOKEN_VERTEX, rChunk );
+                    }
+                    else
+                    {
+                        size_t lNumTokens = rChunk.mTokens.size();
+                        bool lHasFirst = scanName( lFirst, lComma, TOKEN_EDGE_FIRST, rChunk );
+                        bool lHasSecond = scanName( lComma + 1, lLineEnd, TOKEN_EDGE_SECOND, rChunk );
+
+                        // a lone name on either side is a vertex only
+                        if( lHasFirst != lHasSecond )
+                        {
+                            rChunk.mTokens[lNumTokens].mKind = TOKEN_VERTEX;
+                        }
+                    }
+                }
+
+                pBegin = lLineEnd + 1;
             }
+        }
+
+        const char* mData;
+        const std::vector<size_t>& mBounds;
+        size_t mFirstChunk;
+        std::vector<ParsedChunk>& mChunks;
+    };
+
+    // Parses the chunks of pData in batches of rChunks.size() and interns
+    // the names. Returns false if no name was found.
+    template< typename VertexId >
+    bool parseText( const char* pData,
+                    const std::vector<size_t>& rBounds,
+                    std::vector<ParsedChunk>& rChunks,
+                    BasicGraph<VertexId>& rGraph,
+                    std::vector< std::pair<VertexId, VertexId> >& rEdges )
+    {
+        typedef std::pair<VertexId, VertexId> idPair_t;
+
+        bool lRet = false;
+        size_t lNumChunks = rBounds.size() - 1;
+        size_t lBatchSize = rChunks.size();
+
+        for( size_t lFirstChunk = 0; lFirstChunk < lNumChunks; lFirstChunk += lBatchSize )
+        {
+            size_t lBatchChunks = std::min( lBatchSize, lNumChunks - lFirstChunk );
+
+            ParseChunks lParser( pData, rBounds, lFirstChunk, rChunks );
+            parallelFor( 0, lBatchChunks, lParser, 1 );
 
-            if( !lVertex1.empty() )
+            // interning stays serial and in file order, ids follow first sight
+            VertexId lFirstId = 0;
+            for( size_t lIdx = 0; lIdx < lBatchChunks; ++lIdx )
             {
-                rGraph.addVertex( lVertex1, lId1 );
-                lRet = true;
+                const std::vector<NameToken>& rTokens = rChunks[lIdx].mTokens;
+                for( size_t lToken = 0; lToken < rTokens.size(); ++lToken )
+                {
+                    const NameToken& rToken = rTokens[lToken];
+
+                    VertexId lId = 0;
+                    rGraph.addVertex( rToken.mName, rToken.mLength, rToken.mHash, lId );
+                    lRet = true;
+
+                    if( TOKEN_EDGE_FIRST == rToken.mKind )
+                    {
+                        lFirstId = lId;
+                    }
+                    else if( TOKEN_EDGE_SECOND == rToken.mKind )
+                    {
+                        rEdges.push_back( idPair_t( lFirstId, lId ) );
+                    }
+                }
             }
+        }
+        return lRet;
+    }
+}
+
+GraphLoader::GraphLoader()
+    : mNumBytes( 0 )
+    , mNumCompressedBytes( 0 )
+    , mNumVertices( 0 )
+    , mNumEdges( 0 )
+    , mElapsedMs( 0 )
+{
+}
+
+template< typename VertexId >
+bool GraphLoader::loadInput( const char* pFilename, BasicGraph<VertexId>& rGraph )
+{
+    typedef typename BasicGraph<VertexId>::idPair_t idPair_t;
+
+    WallTimer lTimer;
+    bool lRet = false;
+
+    mNumBytes = 0;
+    mNumCompressedBytes = 0;
+    mNumVertices = 0;
+    mNumEdges = 0;
+    mElapsedMs = 0;
+
+    size_t lBatchSize = TEXT_CHUNKS_PER_THREAD * ThreadPool::instance().getNumThreads();
+    std::vector<ParsedChunk> lChunks( lBatchSize );
+    std::vector<idPair_t> lEdges;
+    std::vector<size_t> lBounds;
+    size_t lSize = 0;
 
-            if( !lVertex2.empty() )
+    if( DecompressStream::isCompressed( pFilename ) )
+    {
+        DecompressStream lStream;
+        if( !lStream.open( pFilename ) )
+        {
+            return false;
+        }
+
+        // A block is parsed up to its last newline while the next one is
+        // inflated, the partial line left is carried ahead of the next
+        // block. One batch covers a block.
+        size_t lChunkBytes = std::max( ( size_t )DECOMPRESS_BLOCK_BYTES / lBatchSize, ( size_t )64 * 1024 );
+        std::vector<char> lBlock;
+        std::vector<char> lText;
+        size_t lCarry = 0;
+        bool lMore = true;
+
+        while( lMore )
+        {
+            lMore = lStream.read( lBlock );
+            lText.resize( lCarry );
+            lText.insert( lText.end(), lBlock.begin(), lBlock.end() );
+            lSize += lBlock.size();
+            if( lText.empty() )
             {
-                rGraph.addVertex( lVertex2, lId2 );
-                lRet = true;
+                break;
             }
 
-            if( !lVertex1.empty() && !lVertex2.empty() )
+            size_t lEnd = lText.size();
+            if( lMore )
             {
-                rGraph.addEdge( lId1, lId2 );
+                while( lEnd && '\n' != lText[lEnd - 1] )
+                {
+                    --lEnd;
+                }
             }
+
+            splitTextChunks( &lText[0], 0, lEnd, lChunkBytes, lBounds );
+            lRet = parseText( &lText[0], lBounds, lChunks, rGraph, lEdges ) || lRet;
+
+            lCarry = lText.size() - lEnd;
+            memmove( &lText[0], &lText[lEnd], lCarry );
         }
 
-        lInput.close();
+        if( lStream.hasFailed() )
+        {
+            return false;
+        }
+        mNumCompressedBytes = lStream.getCompressedBytes();
     }
+    else
+    {
+        MappedFile lFile;
+        if( !lFile.open( pFilename ) )
+        {
+            return false;
+        }
+
+        lSize = lFile.getSize();
+        splitTextChunks( lFile.getData(), 0, lSize, TEXT_CHUNK_BYTES, lBounds );
+        lRet = parseText( lFile.getData(), lBounds, lChunks, rGraph, lEdges );
+    }
+
+    if( !lEdges.empty() && !rGraph.addEdges( &lEdges[0], lEdges.size() ) )
+    {
+        lRet = false;
+    }
+
+    mNumBytes = lSize;
+    mNumVertices = rGraph.size();
+    mNumEdges = lEdges.size();
+    mElapsedMs = lTimer.getElapsedMs();
 
     return lRet;
 }
+
+void GraphLoader::printStats() const
+{
+    double lSeconds = mElapsedMs / 1000.0;
+    double lMegaBytes = mNumBytes / ( 1024.0 * 1024.0 );
+
+    printf( "Loaded %.2f MB", lMegaBytes );
+    if( mNumCompressedBytes )
+    {
+        printf( " (%.2f MB compressed)", mNumCompressedBytes / ( 1024.0 * 1024.0 ) );
+    }
+    printf( ", %lu vertices, %lu edge lines in %.2f ms",
+            ( unsigned long )mNumVertices, ( unsigned long )mNumEdges, mElapsedMs );
+    if( lSeconds > 0 )
+    {
+        printf( " (%.1f MB/s, %.2f M edges/s)", lMegaBytes / lSeconds, mNumEdges / lSeconds / 1e6 );
+    }
+    printf( "\n" );
+}
+
+template bool GraphLoader::loadInput<uint16_t>( const char*, BasicGraph<uint16_t>& );
+template bool GraphLoader::loadInput<uint32_t>( const char*, BasicGraph<uint32_t>& );
+template bool GraphLoader::loadInput<uint64_t>( const char*, BasicGraph<uint64_t>& );
+
+// end of file
@@ -1,12 +1,58 @@
 #ifndef _GRAPHLOADER_H_
 #define _GRAPHLOADER_H_
 
-class Graph;
+#include <cstddef>
 
+#include "graphFwd.h"
+
+// Loads "a,b" edge lists: one edge or one lone vertex per line, spaces
+// ignored anywhere, lines starting with '#' skipped. The file is memory
+// mapped and split at line boundaries across the thread pool; names are
+// interned in file order, so ids follow first appearance as before, and
+// the edges go to the graph in one addEdges batch.
+//
+// A gzip or zstd file is not mapped but inflated block by block on a
+// background thread, each block parsed while the next one is inflated, so
+// memory stays a few blocks whatever the size of the file.
 class GraphLoader
 {
 public:
-    bool loadInput( const char* pFilename, Graph& rGraph );
+    GraphLoader();
+
+    // Instantiated for every vertex id width
+    template< typename VertexId >
+    bool loadInput( const char* pFilename, BasicGraph<VertexId>& rGraph );
+
+    // Throughput of the last loadInput, in decompressed bytes
+    void printStats() const;
+
+    size_t getNumBytes() const
+    {
+        return mNumBytes;
+    }
+
+    // Size of a compressed input, 0 for plain text
+    size_t getNumCompressedBytes() const
+    {
+        return mNumCompressedBytes;
+    }
+
+    size_t getNumEdges() const
+    {
+        return mNumEdges;
+    }
+
+    double getElapsedMs() const
+    {
+        return mElapsedMs;
+    }
+
+private:
+    size_t mNumBytes;
+    size_t mNumCompressedBytes;
+    size_t mNumVertices;
+    size_t mNumEdges;
+    double mElapsedMs;
 };
 
 #endif
@@ -0,0 +1,297 @@
+#ifdef _MSC_VER
+
+// condition variables came with Vista
+#if !defined( _WIN32_WINNT ) || _WIN32_WINNT < 0x0600
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600
+#endif
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <process.h>
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+#endif
+
+#include "hostPlatform.h"
+
+namespace
+{
+    struct ThreadStart
+    {
+        Thread::entry_t mEntry;
+        void* mArg;
+    };
+}
+
+#ifdef _MSC_VER
+
+Mutex::Mutex()
+    : mHandle( new CRITICAL_SECTION )
+{
+    InitializeCriticalSection( ( CRITICAL_SECTION* )mHandle );
+}
+
+Mutex::~Mutex()
+{
+    DeleteCriticalSection( ( CRITICAL_SECTION* )mHandle );
+    delete ( CRITICAL_SECTION* )mHandle;
+}
+
+void Mutex::lock()
+{
+    EnterCriticalSection( ( CRITICAL_SECTION* )mHandle );
+}
+
+void Mutex::unlock()
+{
+    LeaveCriticalSection( ( CRITICAL_SECTION* )mHandle );
+}
+
+ConditionVariable::ConditionVariable()
+    : mHandle( new CONDITION_VARIABLE )
+{
+    InitializeConditionVariable( ( CONDITION_VARIABLE* )mHandle );
+}
+
+ConditionVariable::~ConditionVariable()
+{
+    delete ( CONDITION_VARIABLE* )mHandle;
+}
+
+void ConditionVariable::wait( ScopedLock& rLock )
+{
+    SleepConditionVariableCS( ( CONDITION_VARIABLE* )mHandle, ( CRITICAL_SECTION* )rLock.mMutex.mHandle, INFINITE );
+}
+
+void ConditionVariable::notifyOne()
+{
+    WakeConditionVariable( ( CONDITION_VARIABLE* )mHandle );
+}
+
+void ConditionVariable::notifyAll()
+{
+    WakeAllConditionVariable( ( CONDITION_VARIABLE* )mHandle );
+}
+
+// _beginthreadex rather than CreateThread, the thread uses the CRT
+static unsigned __stdcall threadMain( void* pStart )
+{
+    ThreadStart lStart = *( ThreadStart* )pStart;
+    delete ( ThreadStart* )pStart;
+    lStart.mEntry( lStart.mArg );
+    return 0;
+}
+
+bool Thread::start( entry_t pEntry, void* pArg )
+{
+    if( mHandle )
+    {
+        return false;
+    }
+
+    ThreadStart* lStart = new ThreadStart;
+    lStart->mEntry = pEntry;
+    lStart->mArg = pArg;
+
+    uintptr_t lHandle = _beginthreadex( NULL, 0, threadMain, lStart, 0, NULL );
+    if( 0 == lHandle )
+    {
+        delete lStart;
+        return false;
+    }
+    mHandle = ( void* )lHandle;
+    return true;
+}
+
+void Thread::join()
+{
+    if( mHandle )
+    {
+        WaitForSingleObject( ( HANDLE )mHandle, INFINITE );
+        CloseHandle( ( HANDLE )mHandle );
+        mHandle = NULL;
+    }
+}
+
+size_t Thread::getNumHardwareThreads()
+{
+    SYSTEM_INFO lInfo;
+    GetSystemInfo( &lInfo );
+    return lInfo.dwNumberOfProcessors;
+}
+
+ThreadLocalPointer::ThreadLocalPointer()
+    : mKey( new DWORD( TlsAlloc() ) )
+{
+}
+
+ThreadLocalPointer::~ThreadLocalPointer()
+{
+    TlsFree( *( DWORD* )mKey );
+    delete ( DWORD* )mKey;
+}
+
+void* ThreadLocalPointer::get() const
+{
+    return TlsGetValue( *( DWORD* )mKey );
+}
+
+void ThreadLocalPointer::set( void* pValue )
+{
+    TlsSetValue( *( DWORD* )mKey, pValue );
+}
+
+double getWallClockMs()
+{
+    LARGE_INTEGER lFrequency;
+    LARGE_INTEGER lCounter;
+    QueryPerformanceFrequency( &lFrequency );
+    QueryPerformanceCounter( &lCounter );
+    return ( double )lCounter.QuadPart * 1000.0 / ( double )lFrequency.QuadPart;
+}
+
+#else
+
+Mutex::Mutex()
+    : mHandle( new pthread_mutex_t )
+{
+    pthread_mutex_init( ( pthread_mutex_t* )mHandle, NULL );
+}
+
+Mutex::~Mutex()
+{
+    pthread_mutex_destroy( ( pthread_mutex_t* )mHandle );
+    delete ( pthread_mutex_t* )mHandle;
+}
+
+void Mutex::lock()
+{
+    pthread_mutex_lock( ( pthread_mutex_t* )mHandle );
+}
+
+void Mutex::unlock()
+{
+    pthread_mutex_unlock( ( pthread_mutex_t* )mHandle );
+}
+
+ConditionVariable::ConditionVariable()
+    : mHandle( new pthread_cond_t )
+{
+    pthread_cond_init( ( pthread_cond_t* )mHandle, NULL );
+}
+
+ConditionVariable::~ConditionVariable()
+{
+    pthread_cond_destroy( ( pthread_cond_t* )mHandle );
+    delete ( pthread_cond_t* )mHandle;
+}
+
+void ConditionVariable::wait( ScopedLock& rLock )
+{
+    pthread_cond_wait( ( pthread_cond_t* )mHandle, ( pthread_mutex_t* )rLock.mMutex.mHandle );
+}
+
+void ConditionVariable::notifyOne()
+{
+    pthread_cond_signal( ( pthread_cond_t* )mHandle );
+}
+
+void ConditionVariable::notifyAll()
+{
+    pthread_cond_broadcast( ( pthread_cond_t* )mHandle );
+}
+
+static void* threadMain( void* pStart )
+{
+    ThreadStart lStart = *( ThreadStart* )pStart;
+    delete ( ThreadStart* )pStart;
+    lStart.mEntry( lStart.mArg );
+    return NULL;
+}
+
+bool Thread::start( entry_t pEntry, void* pArg )
+{
+    if( mHandle )
+    {
+        return false;
+    }
+
+    ThreadStart* lStart = new ThreadStart;
+    lStart->mEntry = pEntry;
+    lStart->mArg = pArg;
+
+    pthread_t* lThread = new pthread_t;
+    if( 0 != pthread_create( lThread, NULL, threadMain, lStart ) )
+    {
+        delete lThread;
+        delete lStart;
+        return false;
+    }
+    mHandle = lThread;
+    return true;
+}
+
+void Thread::join()
+{
+    if( mHandle )
+    {
+        pthread_join( *( pthread_t* )mHandle, NULL );
+        delete ( pthread_t* )mHandle;
+        mHandle = NULL;
+    }
+}
+
+size_t Thread::getNumHardwareThreads()
+{
+    long lCount = sysconf( _SC_NPROCESSORS_ONLN );
+    return ( lCount > 0 ) ? ( size_t )lCount : 0;
+}
+
+ThreadLocalPointer::ThreadLocalPointer()
+    : mKey( new pthread_key_t )
+{
+    pthread_key_create( ( pthread_key_t* )mKey, NULL );
+}
+
+ThreadLocalPointer::~ThreadLocalPointer()
+{
+    pthread_key_delete( *( pthread_key_t* )mKey );
+    delete ( pthread_key_t* )mKey;
+}
+
+void* ThreadLocalPointer::get() const
+{
+    return pthread_getspecific( *( pthread_key_t* )mKey );
+}
+
+void ThreadLocalPointer::set( void* pValue )
+{
+    pthread_setspecific( *( pthread_key_t* )mKey, pValue );
+}
+
+double getWallClockMs()
+{
+    timespec lNow;
+    clock_gettime( CLOCK_MONOTONIC, &lNow );
+    return ( double )lNow.tv_sec * 1000.0 + ( double )lNow.tv_nsec / 1000000.0;
+}
+
+#endif
+
+Thread::Thread()
+    : mHandle( NULL )
+{
+}
+
+Thread::~Thread()
+{
+    join();
+}
+
+// end of file
@@ -0,0 +1,207 @@
+#ifndef _HOST_PLATFORM_H_
+#define _HOST_PLATFORM_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Threads, locks, thread local slots, the atomics the host engines share
+// and a wall clock, built on Win32 with _MSC_VER and on pthreads
+// elsewhere, so the host side needs no C++11 library support.
+
+class Mutex
+{
+public:
+    Mutex();
+    ~Mutex();
+
+    void lock();
+    void unlock();
+
+private:
+    Mutex( const Mutex& );
+    Mutex& operator= ( const Mutex& );
+
+    friend class ConditionVariable;
+
+    void* mHandle;
+};
+
+// Holds a Mutex for its scope. unlock() and lock() release it and take it
+// again before the scope ends.
+class ScopedLock
+{
+public:
+    explicit ScopedLock( Mutex& rMutex )
+        : mMutex( rMutex ), mLocked( true )
+    {
+        mMutex.lock();
+    }
+
+    ~ScopedLock()
+    {
+        if( mLocked )
+        {
+            mMutex.unlock();
+        }
+    }
+
+    void lock()
+    {
+        mMutex.lock();
+        mLocked = true;
+    }
+
+    void unlock()
+    {
+        mLocked = false;
+        mMutex.unlock();
+    }
+
+private:
+    ScopedLock( const ScopedLock& );
+    ScopedLock& operator= ( const ScopedLock& );
+
+    friend class ConditionVariable;
+
+    Mutex& mMutex;
+    bool mLocked;
+};
+
+class ConditionVariable
+{
+public:
+    ConditionVariable();
+    ~ConditionVariable();
+
+    // Releases the lock while waiting, may wake spuriously
+    void wait( ScopedLock& rLock );
+
+    void notifyOne();
+    void notifyAll();
+
+private:
+    ConditionVariable( const ConditionVariable& );
+    ConditionVariable& operator= ( const ConditionVariable& );
+
+    void* mHandle;
+};
+
+// A thread running pEntry( pArg ), joined by the destructor at the latest
+class Thread
+{
+public:
+    typedef void ( *entry_t )( void* pArg );
+
+    Thread();
+    ~Thread();
+
+    // False if the thread could not be created
+    bool start( entry_t pEntry, void* pArg );
+
+    bool isJoinable() const
+    {
+        return NULL != mHandle;
+    }
+
+    void join();
+
+    // 0 if the platform does not tell
+    static size_t getNumHardwareThreads();
+
+private:
+    Thread( const Thread& );
+    Thread& operator= ( const Thread& );
+
+    void* mHandle;
+};
+
+// Pointer slot holding its own value in every thread, NULL until set
+class ThreadLocalPointer
+{
+public:
+    ThreadLocalPointer();
+    ~ThreadLocalPointer();
+
+    void* get() const;
+    void set( void* pValue );
+
+private:
+    ThreadLocalPointer( const ThreadLocalPointer& );
+    ThreadLocalPointer& operator= ( const ThreadLocalPointer& );
+
+    void* mKey;
+};
+
+// Atomics on values the pool's tasks share. They order nothing but the
+// value itself; the start and the end of a pool run order the rest.
+#ifdef _MSC_VER
+
+inline size_t atomicFetchIncrement( volatile size_t& rValue )
+{
+#ifdef _WIN64
+    return ( size_t )_InterlockedIncrement64( ( volatile __int64* )&rValue ) - 1;
+#else
+    return ( size_t )_InterlockedIncrement( ( volatile long* )&rValue ) - 1;
+#endif
+}
+
+// Returns the decremented value
+inline uint32_t atomicDecrement( volatile uint32_t& rValue )
+{
+    return ( uint32_t )_InterlockedDecrement( ( volatile long* )&rValue );
+}
+
+// aligned 32 bit accesses are atomic on the targets MSVC builds for
+inline int atomicLoad( const volatile int& rValue )
+{
+    return rValue;
+}
+
+inline void atomicStore( volatile int& rValue, int pValue )
+{
+    rValue = pValue;
+}
+
+inline void atomicStore( volatile uint32_t& rValue, uint32_t pValue )
+{
+    rValue = pValue;
+}
+
+#else
+
+inline size_t atomicFetchIncrement( volatile size_t& rValue )
+{
+    return __atomic_fetch_add( &rValue, 1, __ATOMIC_RELAXED );
+}
+
+// Returns the decremented value
+inline uint32_t atomicDecrement( volatile uint32_t& rValue )
+{
+    return __atomic_sub_fetch( &rValue, 1, __ATOMIC_RELAXED );
+}
+
+inline int atomicLoad( const volatile int& rValue )
+{
+    return __atomic_load_n( &rValue, __ATOMIC_RELAXED );
+}
+
+inline void atomicStore( volatile int& rValue, int pValue )
+{
+    __atomic_store_n( &rValue, pValue, __ATOMIC_RELAXED );
+}
+
+inline void atomicStore( volatile uint32_t& rValue, uint32_t pValue )
+{
+    __atomic_store_n( &rValue, pValue, __ATOMIC_RELAXED );
+}
+
+#endif
+
+// Milliseconds on a monotonic clock from an arbitrary origin
+double getWallClockMs();
+
+#endif
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <vector>
+
+#include "graph.h"
+#include "compactGraph.h"
+#include "parallelUtils.h"
+#include "jonesPlassmannColor.h"
+
+namespace
+{
+    typedef CompactGraph::vertexId_t vertexId_t;
+
+    // SplitMix64 finalizer; the priorities are hashed where they are
+    // compared, which costs less than fetching them for every neighbor
+    inline uint64_t getPriority( uint64_t pSeed, vertexId_t pVertex )
+    {
+        uint64_t lValue = pSeed + ( ( uint64_t )pVertex + 1 ) * 0x9E3779B97F4A7C15ull;
+        lValue = ( lValue ^ ( lValue >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+        lValue = ( lValue ^ ( lValue >> 27 ) ) * 0x94D049BB133111EBull;
+        return lValue ^ ( lValue >> 31 );
+    }
+
+    // True if pFirst is colored before pSecond, ties going to the lower id
+    inline bool precedes( uint64_t pFirstPriority, vertexId_t pFirst, uint64_t pSecondPriority, vertexId_t pSecond )
+    {
+        return pFirstPriority > pSecondPriority || ( pFirstPriority == pSecondPriority && pFirst < pSecond );
+    }
+
+    // Counts the higher priority neighbors of every vertex; the vertices
+    // without any start the first round
+    struct CountPredecessors
+    {
+        CountPredecessors( const CompactGraph& rGraph, uint64_t pSeed, volatile uint32_t* pCounts,
+                           std::vector< std::vector<vertexId_t> >& rReady )
+            : mGraph( rGraph ), mSeed( pSeed ), mCounts( pCounts ), mReady( rReady )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t pThreadIdx )
+        {
+            std::vector<vertexId_t>& rReady = mReady[pThreadIdx];
+            for( size_t lVertex = pBegin; lVertex < pEnd; ++lVertex )
+            {
+                vertexId_t lId = ( vertexId_t )lVertex;
+                uint64_t lPriority = getPriority( mSeed, lId );
+                uint32_t lCount = 0;
+
+                CompactGraph::NeighborRange lNeighbors = mGraph.getNeighbors( lId );
+                for( CompactGraph::NeighborRange::const_iterator lIter = lNeighbors.begin(); lIter != lNeighbors.end(); ++lIter )
+                {
+                    lCount += precedes( getPriority( mSeed, *lIter ), *lIter, lPriority, lId ) ? 1 : 0;
+                }
+
+                atomicStore( mCounts[lVertex], lCount );
+                if( 0 == lCount )
+                {
+                    rReady.push_back( lId );
+                }
+            }
+        }
+
+        const CompactGraph& mGraph;
+        uint64_t mSeed;
+        volatile uint32_t* mCounts;
+        std::vector< std::vector<vertexId_t> >& mReady;
+    };
+
+    // Colors the vertices of a round, all of whose predecessors are
+    // colored, and hands every successor whose last predecessor this was
+    // to the next round. The colors written now are read only after the
+    // round, so they need no synchronization.
+    struct ColorRound
+    {
+        ColorRound( const CompactGraph& rGraph, uint64_t pSeed, volatile uint32_t* pCounts, int* pColors,
+                    const vertexId_t* pRound, std::vector< std::vector<vertexId_t> >& rReady,
+                    std::vector< std::vector<uint64_t> >& rForbidden )
+            : mGraph( rGraph ), mSeed( pSeed ), mCounts( pCounts ), mColors( pColors )
+            , mRound( pRound ), mReady( rReady ), mForbidden( rForbidden )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t pThreadIdx )
+        {
+            std::vector<vertexId_t>& rReady = mReady[pThreadIdx];
+            uint64_t* lForbidden = &mForbidden[pThreadIdx][0];
+
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                vertexId_t lId = mRound[lIdx];
+                uint64_t lPriority = getPriority( mSeed, lId );
+
+                // the slots are stamped with the vertex, never cleared
+                uint64_t lStamp = ( uint64_t )lId + 1;
+                CompactGraph::NeighborRange lNeighbors = mGraph.getNeighbors( lId );
+                for( CompactGraph::NeighborRange::const_iterator lIter = lNeighbors.begin(); lIter != lNeighbors.end(); ++lIter )
+                {
+                    vertexId_t lNeighbor = *lIter;
+                    if( precedes( getPriority( mSeed, lNeighbor ), lNeighbor, lPriority, lId ) )
+                    {
+                        lForbidden[mColors[lNeighbor]] = lStamp;
+                    }
+                    else if( 0 == atomicDecrement( mCounts[lNeighbor] ) )
+                    {
+                        rReady.push_back( lNeighbor );
+                    }
+                }
+
+                int lColor = 0;
+                while( lForbidden[lColor] == lStamp )
+                {
+                    ++lColor;
+                }
+                mColors[lId] = lColor;
+            }
+        }
+
+        const CompactGraph& mGraph;
+        uint64_t mSeed;
+        volatile uint32_t* mCounts;
+        int* mColors;
+        const vertexId_t* mRound;
+        std::vector< std::vector<vertexId_t> >& mReady;
+        std::vector< std::vector<uint64_t> >& mForbidden;
+    };
+}
+
+bool jonesPlassmannColor( const CompactGraph& rCompactGraph,
+                          std::vector<int>& rColors,
+                          uint64_t pSeed,
+                          size_t& rNumRounds )
+{
+    rNumRounds = 0;
+    size_t lNumVertices = rCompactGraph.size();
+    if( 0 == lNumVertices )
+    {
+        return false;
+    }
+
+    const size_t lNumThreads = ThreadPool::instance().getNumThreads();
+    std::vector< std::vector<vertexId_t> > lReady( lNumThreads );
+    std::vector<vertexId_t> lRound;
+
+    // a vertex has at most its degree of colors around it
+    std::vector< std::vector<uint64_t> > lForbidden( lNumThreads, std::vector<uint64_t>( rCompactGraph.getMaxDegree() + 1, 0 ) );
+
+    std::vector<uint32_t> lCounts( lNumVertices );
+    rColors.assign( lNumVertices, -1 );
+
+    CountPredecessors lCounter( rCompactGraph, pSeed, &lCounts[0], lReady );
+    parallelFor( 0, lNumVertices, lCounter );
+
+    while( parallelGather( lReady, lRound ) )
+    {
+        ColorRound lColorer( rCompactGraph, pSeed, &lCounts[0], &rColors[0], &lRound[0], lReady, lForbidden );
+        parallelFor( 0, lRound.size(), lColorer );
+        ++rNumRounds;
+    }
+
+    return true;
+}
+
+// end of file
@@ -0,0 +1,23 @@
+#ifndef _JONES_PLASSMANN_COLOR_H_
+#define _JONES_PLASSMANN_COLOR_H_
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+#include "graphFwd.h"
+
+// Host implementation of the Jones-Plassmann coloring, the full coloring
+// form of Luby's independent sets, on the shared thread pool. Every vertex
+// gets a random priority hashed from its id and pSeed; a vertex is colored,
+// with the smallest color none of its higher priority neighbors has, in
+// the round after the last of them is. rColors receives one color per
+// vertex and rNumRounds the rounds taken, about log n / log log n on
+// sparse random priorities. The colors depend on pSeed only, not on the
+// number of threads.
+bool jonesPlassmannColor( const CompactGraph& rCompactGraph,
+                          std::vector<int>& rColors,
+                          uint64_t pSeed,
+                          size_t& rNumRounds );
+
+#endif
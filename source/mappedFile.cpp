@@ -0,0 +1,145 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "mappedFile.h"
+
+MappedFile::MappedFile()
+    : mData( NULL )
+    , mSize( 0 )
+    , mIsOpen( false )
+#ifdef _WIN32
+    , mFile( INVALID_HANDLE_VALUE )
+    , mMapping( NULL )
+#else
+    , mFile( -1 )
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open( const char* pFilename )
+{
+    close();
+
+    mFile = ::CreateFileA( pFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    if( INVALID_HANDLE_VALUE == mFile )
+    {
+        return false;
+    }
+
+    LARGE_INTEGER lSize;
+    if( !::GetFileSizeEx( mFile, &lSize ) )
+    {
+        close();
+        return false;
+    }
+
+    mSize = ( size_t )lSize.QuadPart;
+    if( mSize )
+    {
+        mMapping = ::CreateFileMappingA( mFile, NULL, PAGE_READONLY, 0, 0, NULL );
+        mData = mMapping ? ( const char* )::MapViewOfFile( mMapping, FILE_MAP_READ, 0, 0, 0 ) : NULL;
+        if( !mData )
+        {
+            close();
+            return false;
+        }
+    }
+
+    mIsOpen = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if( mData )
+    {
+        ::UnmapViewOfFile( mData );
+    }
+    if( mMapping )
+    {
+        ::CloseHandle( mMapping );
+    }
+    if( INVALID_HANDLE_VALUE != mFile )
+    {
+        ::CloseHandle( mFile );
+    }
+
+    mData = NULL;
+    mSize = 0;
+    mIsOpen = false;
+    mFile = INVALID_HANDLE_VALUE;
+    mMapping = NULL;
+}
+
+#else
+
+bool MappedFile::open( const char* pFilename )
+{
+    close();
+
+    mFile = ::open( pFilename, O_RDONLY );
+    if( mFile < 0 )
+    {
+        return false;
+    }
+
+    struct stat lStat;
+    if( ::fstat( mFile, &lStat ) != 0 )
+    {
+        close();
+        return false;
+    }
+
+    mSize = ( size_t )lStat.st_size;
+    if( mSize )
+    {
+        void* lData = ::mmap( NULL, mSize, PROT_READ, MAP_PRIVATE, mFile, 0 );
+        if( MAP_FAILED == lData )
+        {
+            close();
+            return false;
+        }
+        mData = ( const char* )lData;
+
+        // the parsers read front to back
+        ::madvise( lData, mSize, MADV_SEQUENTIAL );
+    }
+
+    mIsOpen = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if( mData )
+    {
+        ::munmap( ( void* )mData, mSize );
+    }
+    if( mFile >= 0 )
+    {
+        ::close( mFile );
+    }
+
+    mData = NULL;
+    mSize = 0;
+    mIsOpen = false;
+    mFile = -1;
+}
+
+#endif
+
+// end of file
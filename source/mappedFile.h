@@ -0,0 +1,52 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+
+// Read only memory mapping of a whole file. The contents stay valid until
+// close() or destruction.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // False if the file cannot be opened or mapped. An empty file opens
+    // with no data.
+    bool open( const char* pFilename );
+
+    void close();
+
+    bool isOpen() const
+    {
+        return mIsOpen;
+    }
+
+    const char* getData() const
+    {
+        return mData;
+    }
+
+    size_t getSize() const
+    {
+        return mSize;
+    }
+
+private:
+    // not copyable
+    MappedFile( const MappedFile& );
+    MappedFile& operator= ( const MappedFile& );
+
+    const char* mData;
+    size_t mSize;
+    bool mIsOpen;
+
+#ifdef _WIN32
+    void* mFile;
+    void* mMapping;
+#else
+    int mFile;
+#endif
+};
+
+#endif
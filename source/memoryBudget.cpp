@@ -0,0 +1,169 @@
+#include <cstdio>
+
+#include "graph.h"
+#include "compactGraph.h"
+#include "complementView.h"
+#include "bitMatrix.h"
+#include "triangularBitMatrix.h"
+#include "sparseBitmap.h"
+#include "memoryBudget.h"
+
+// Sizes of the representations whose id width follows the graph size
+struct EstimateDeviceWidth
+{
+    EstimateDeviceWidth( const Graph& rGraph, MemoryEstimate& rEstimate )
+        : mGraph( rGraph ), mEstimate( rEstimate )
+    {}
+
+    template< typename VertexId >
+    bool run()
+    {
+        size_t lNumVertices = mGraph.size();
+        size_t lNumAdjacencies = mGraph.getNumAdjacencies();
+
+        mEstimate.mBytes[REPR_CSR] = BasicCompactGraph<VertexId>::requiredBytes( lNumVertices, lNumAdjacencies );
+        mEstimate.mBytes[REPR_COMPLEMENT_VIEW] = BasicComplementView<VertexId>::requiredBytes( lNumVertices, lNumAdjacencies );
+        mEstimate.mBytes[REPR_NON_ADJACENCY_STREAM] = mGraph.fitsNonAdjacencyStream<VertexId>() ?
+                                                      mGraph.getNonAdjacencyStreamBytes<VertexId>() :
+                                                      MEMORY_NOT_AVAILABLE;
+        return true;
+    }
+
+    const Graph& mGraph;
+    MemoryEstimate& mEstimate;
+};
+
+void estimateMemory( const Graph& rGraph, MemoryEstimate& rEstimate )
+{
+    size_t lNumVertices = rGraph.size();
+    size_t lNumAdjacencies = rGraph.getNumAdjacencies();
+
+    rEstimate.mBytes[REPR_ADJACENCY_SETS] = rGraph.getNumBytes();
+    rEstimate.mBytes[REPR_BIT_MATRIX] = Graph::requiredBitMatrixBytes( lNumVertices );
+    rEstimate.mBytes[REPR_TRIANGULAR_MATRIX] = TriangularBitMatrix::requiredBytes( lNumVertices );
+
+    EstimateDeviceWidth lDeviceWidth( rGraph, rEstimate );
+    dispatchOnVertexCount( lNumVertices, lDeviceWidth );
+
+    size_t lSparseBytes = lNumVertices * sizeof( SparseBitmap );
+    for( size_t lId = 0; lId < lNumVertices; ++lId )
+    {
+        lSparseBytes += SparseBitmap::estimateBytes( rGraph.getDegree( ( Graph::vertexId_t )lId ) );
+    }
+    rEstimate.mBytes[REPR_SPARSE_BITMAP] = lSparseBytes;
+
+    // the groups come back as bytes and are imported into a BitMatrix,
+    // next to one color per vertex
+    rEstimate.mBytes[REPR_VIS_GROUPS] = Graph::requiredBitMatrixBytes( lNumVertices ) +
+                                        BitMatrix::requiredBytes( lNumVertices, lNumVertices ) +
+                                        lNumVertices * sizeof( int );
+
+    // the list paths and svis freeze a 32 bit CSR on the host
+    size_t lHostCsrBytes = CompactGraph::requiredBytes( lNumVertices, lNumAdjacencies );
+    size_t lHostComplementBytes = ComplementView::requiredBytes( lNumVertices, lNumAdjacencies );
+    const size_t* lBytes = rEstimate.mBytes;
+
+    rEstimate.mPlanBytes[PLAN_VIS] = lBytes[REPR_ADJACENCY_SETS] + lBytes[REPR_BIT_MATRIX] +
+                                     lHostCsrBytes + lBytes[REPR_NON_ADJACENCY_STREAM] + lBytes[REPR_VIS_GROUPS];
+    rEstimate.mPlanBytes[PLAN_VIS_TRIANGULAR] = lBytes[REPR_ADJACENCY_SETS] + lBytes[REPR_TRIANGULAR_MATRIX] +
+                                                lHostCsrBytes + lBytes[REPR_NON_ADJACENCY_STREAM] + lBytes[REPR_VIS_GROUPS];
+
+    // past 2^32 - 1 entries the stream offsets of 32 bit ids would wrap
+    if( MEMORY_NOT_AVAILABLE == lBytes[REPR_NON_ADJACENCY_STREAM] )
+    {
+        rEstimate.mPlanBytes[PLAN_VIS] = MEMORY_NOT_AVAILABLE;
+        rEstimate.mPlanBytes[PLAN_VIS_TRIANGULAR] = MEMORY_NOT_AVAILABLE;
+    }
+    rEstimate.mPlanBytes[PLAN_VIS_IMPLICIT] = lBytes[REPR_ADJACENCY_SETS] + lBytes[REPR_CSR] +
+                                              lBytes[REPR_COMPLEMENT_VIEW] + lBytes[REPR_VIS_GROUPS];
+    rEstimate.mPlanBytes[PLAN_SPARSE_VIS] = lBytes[REPR_ADJACENCY_SETS] + lHostCsrBytes + lHostComplementBytes +
+                                            lBytes[REPR_SPARSE_BITMAP] + lNumVertices * sizeof( int );
+    rEstimate.mPlanBytes[PLAN_LUBY] = lBytes[REPR_ADJACENCY_SETS] + lBytes[REPR_BIT_MATRIX];
+
+    // jp: a color, a predecessor count and two round list slots per vertex
+    rEstimate.mPlanBytes[PLAN_JONES_PLASSMANN] = lBytes[REPR_ADJACENCY_SETS] + lHostCsrBytes +
+                                                 lNumVertices * ( sizeof( int ) + sizeof( uint32_t ) + 2 * sizeof( Graph::vertexId_t ) );
+
+    // spec: the shared colors, handed back as the result, and two worklist
+    // slots per vertex
+    rEstimate.mPlanBytes[PLAN_SPECULATIVE] = lBytes[REPR_ADJACENCY_SETS] + lHostCsrBytes +
+                                             lNumVertices * ( sizeof( int ) + 2 * sizeof( Graph::vertexId_t ) );
+}
+
+const char* getRepresentationName( Representation_t pRepresentation )
+{
+    static const char* sNames[NUM_REPRESENTATIONS] =
+    {
+        "adjacency sets (estimate)",
+        "CSR",
+        "complement view",
+        "adjacency bit matrix",
+        "triangular bit matrix",
+        "sparse bitmaps (upper bound)",
+        "non adjacency stream",
+        "vis groups"
+    };
+    return sNames[pRepresentation];
+}
+
+const char* getPlanName( ColoringPlan_t pPlan )
+{
+    static const char* sNames[NUM_PLANS] =
+    {
+        "vis",
+        "vis --triangular",
+        "vis --implicit",
+        "svis",
+        "luby",
+        "jp",
+        "spec"
+    };
+    return sNames[pPlan];
+}
+
+#define BYTES_TO_MB( bytes ) ( ( double )( bytes ) / ( 1024.0 * 1024.0 ) )
+
+void printMemoryReport( const MemoryEstimate& rEstimate )
+{
+    printf( "Host memory estimate:\n" );
+    for( int lIdx = 0; lIdx < NUM_REPRESENTATIONS; ++lIdx )
+    {
+        if( MEMORY_NOT_AVAILABLE == rEstimate.mBytes[lIdx] )
+        {
+            printf( "  %-30s %15s\n", getRepresentationName( ( Representation_t )lIdx ), "does not fit" );
+            continue;
+        }
+        printf( "  %-30s %12.2f MB\n",
+                getRepresentationName( ( Representation_t )lIdx ),
+                BYTES_TO_MB( rEstimate.mBytes[lIdx] ) );
+    }
+    for( int lIdx = 0; lIdx < NUM_PLANS; ++lIdx )
+    {
+        if( MEMORY_NOT_AVAILABLE == rEstimate.mPlanBytes[lIdx] )
+        {
+            printf( "  peak of %-22s %15s\n", getPlanName( ( ColoringPlan_t )lIdx ), "not available" );
+            continue;
+        }
+        printf( "  peak of %-22s %12.2f MB\n",
+                getPlanName( ( ColoringPlan_t )lIdx ),
+                BYTES_TO_MB( rEstimate.mPlanBytes[lIdx] ) );
+    }
+}
+
+bool selectVisPlan( const MemoryEstimate& rEstimate, size_t pBudget, ColoringPlan_t& rPlan )
+{
+    static const ColoringPlan_t sVisPlans[] = { PLAN_VIS, PLAN_VIS_TRIANGULAR, PLAN_VIS_IMPLICIT, PLAN_SPARSE_VIS };
+
+    for( size_t lIdx = 0; lIdx < sizeof( sVisPlans ) / sizeof( sVisPlans[0] ); ++lIdx )
+    {
+        if( MEMORY_NOT_AVAILABLE != rEstimate.mPlanBytes[sVisPlans[lIdx]] &&
+            rEstimate.mPlanBytes[sVisPlans[lIdx]] <= pBudget )
+        {
+            rPlan = sVisPlans[lIdx];
+            return true;
+        }
+    }
+    return false;
+}
+
+// end of file
@@ -0,0 +1,61 @@
+#ifndef _MEMORY_BUDGET_H_
+#define _MEMORY_BUDGET_H_
+
+#include <cstddef>
+
+#include "graphFwd.h"
+
+// Host memory accounting for the graph representations and for the
+// coloring paths built from them, computed from the vertex count and the
+// degrees before anything is allocated.
+enum Representation_t
+{
+    REPR_ADJACENCY_SETS,        // the loaded Graph, estimated
+    REPR_CSR,                   // CompactGraph at the device id width
+    REPR_COMPLEMENT_VIEW,       // ComplementView at the device id width
+    REPR_BIT_MATRIX,            // dense adjacency bit matrix
+    REPR_TRIANGULAR_MATRIX,     // upper triangular adjacency bit matrix
+    REPR_SPARSE_BITMAP,         // compressed bitmap rows, upper bound
+    REPR_NON_ADJACENCY_STREAM,  // non adjacency lists at the device id width
+    REPR_VIS_GROUPS,            // V x V group matrix read back from the device
+    NUM_REPRESENTATIONS
+};
+
+// Coloring paths, the vis ones listed densest first
+enum ColoringPlan_t
+{
+    PLAN_VIS,
+    PLAN_VIS_TRIANGULAR,
+    PLAN_VIS_IMPLICIT,
+    PLAN_SPARSE_VIS,
+    PLAN_LUBY,
+    PLAN_JONES_PLASSMANN,
+    PLAN_SPECULATIVE,
+    NUM_PLANS
+};
+
+// Byte count of a representation the graph cannot be given, and of the
+// plans built on it
+#define MEMORY_NOT_AVAILABLE ( ( size_t )-1 )
+
+struct MemoryEstimate
+{
+    size_t mBytes[NUM_REPRESENTATIONS];
+
+    // peak host bytes of every path, the loaded graph included
+    size_t mPlanBytes[NUM_PLANS];
+};
+
+void estimateMemory( const Graph& rGraph, MemoryEstimate& rEstimate );
+
+const char* getRepresentationName( Representation_t pRepresentation );
+
+const char* getPlanName( ColoringPlan_t pPlan );
+
+void printMemoryReport( const MemoryEstimate& rEstimate );
+
+// Picks the densest vis path whose peak fits in pBudget bytes, falling
+// back to the host svis engine. False if none fits.
+bool selectVisPlan( const MemoryEstimate& rEstimate, size_t pBudget, ColoringPlan_t& rPlan );
+
+#endif
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstring>
+
+#include "nameInterner.h"
+
+#define INITIAL_NUM_SLOTS 1024
+
+const NameInterner::nameId_t NameInterner::INVALID_ID = ~( NameInterner::nameId_t )0;
+
+NameInterner::NameInterner()
+    : mMask( 0 )
+{
+    clear();
+}
+
+void NameInterner::clear()
+{
+    mArena.clear();
+    mOffsets.assign( 1, 0 );
+    mHashes.clear();
+    mSlots.assign( INITIAL_NUM_SLOTS, INVALID_ID );
+    mMask = INITIAL_NUM_SLOTS - 1;
+}
+
+NameInterner::hash_t NameInterner::hash( const char* pName, size_t pLength )
+{
+    // FNV-1a
+    hash_t lHash = 2166136261u;
+    for( size_t lIdx = 0; lIdx < pLength; ++lIdx )
+    {
+        lHash ^= ( unsigned char )pName[lIdx];
+        lHash *= 16777619u;
+    }
+    return lHash;
+}
+
+bool NameInterner::equals( const nameId_t& rId, const char* pName, size_t pLength ) const
+{
+    size_t lLength = 0;
+    const char* lName = getName( rId, lLength );
+    return ( lLength == pLength ) && ( 0 == memcmp( lName, pName, pLength ) );
+}
+
+bool NameInterner::find( const char* pName, size_t pLength, nameId_t& rId ) const
+{
+    return find( pName, pLength, hash( pName, pLength ), rId );
+}
+
+bool NameInterner::find( const char* pName, size_t pLength, hash_t pHash, nameId_t& rId ) const
+{
+    for( size_t lSlot = pHash & mMask; ; lSlot = ( lSlot + 1 ) & mMask )
+    {
+        nameId_t lId = mSlots[lSlot];
+        if( INVALID_ID == lId )
+        {
+            return false;
+        }
+
+        if( mHashes[lId] == pHash && equals( lId, pName, pLength ) )
+        {
+            rId = lId;
+            return true;
+        }
+    }
+}
+
+bool NameInterner::intern( const char* pName, size_t pLength, nameId_t& rId )
+{
+    return intern( pName, pLength, hash( pName, pLength ), rId );
+}
+
+bool NameInterner::intern( const char* pName, size_t pLength, hash_t pHash, nameId_t& rId )
+{
+    size_t lSlot = pHash & mMask;
+    for( ; ; lSlot = ( lSlot + 1 ) & mMask )
+    {
+        nameId_t lId = mSlots[lSlot];
+        if( INVALID_ID == lId )
+        {
+            break;
+        }
+
+        if( mHashes[lId] == pHash && equals( lId, pName, pLength ) )
+        {
+            rId = lId;
+            return false;
+        }
+    }
+
+    rId = ( nameId_t )mHashes.size();
+    mSlots[lSlot] = rId;
+    mHashes.push_back( pHash );
+    mArena.insert( mArena.end(), pName, pName + pLength );
+    mOffsets.push_back( mArena.size() );
+
+    // keep the load factor at or below one half
+    if( mHashes.size() * 2 > mSlots.size() )
+    {
+        grow( mSlots.size() * 2 );
+    }
+
+    return true;
+}
+
+void NameInterner::reserve( size_t pNumNames, size_t pNumChars )
+{
+    mArena.reserve( pNumChars );
+    mOffsets.reserve( pNumNames + 1 );
+    mHashes.reserve( pNumNames );
+
+    if( pNumNames * 2 > mSlots.size() )
+    {
+        grow( pNumNames * 2 );
+    }
+}
+
+void NameInterner::grow( size_t pMinSlots )
+{
+    size_t lNumSlots = mSlots.size();
+    while( lNumSlots < pMinSlots )
+    {
+        lNumSlots <<= 1;
+    }
+
+    mSlots.assign( lNumSlots, INVALID_ID );
+    mMask = lNumSlots - 1;
+
+    // rehash from the stored hashes, the names themselves are not touched
+    for( nameId_t lId = 0; lId < mHashes.size(); ++lId )
+    {
+        size_t lSlot = mHashes[lId] & mMask;
+        while( INVALID_ID != mSlots[lSlot] )
+        {
+            lSlot = ( lSlot + 1 ) & mMask;
+        }
+        mSlots[lSlot] = lId;
+    }
+}
+
+// end of file
@@ -0,0 +1,92 @@
+#ifndef _NAME_INTERNER_H_
+#define _NAME_INTERNER_H_
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdint.h>
+
+// Maps vertex names to dense ids in first-seen order.
+// All names live back to back in a single character arena; the id -> name
+// direction is an offset vector into that arena and the name -> id direction
+// is an open addressing (linear probing) hash table of ids.
+class NameInterner
+{
+public:
+    typedef unsigned int nameId_t;
+    typedef uint32_t hash_t;
+
+    static const nameId_t INVALID_ID;
+
+    NameInterner();
+
+    // Returns true if the name was not seen before. rId receives the id of
+    // the name in either case.
+    bool intern( const char* pName, size_t pLength, nameId_t& rId );
+
+    bool find( const char* pName, size_t pLength, nameId_t& rId ) const;
+
+    // Same as above with pHash = hash( pName, pLength ) computed by the
+    // caller, e.g. by parser threads ahead of a serial intern pass
+    bool intern( const char* pName, size_t pLength, hash_t pHash, nameId_t& rId );
+    bool find( const char* pName, size_t pLength, hash_t pHash, nameId_t& rId ) const;
+
+    // Returns a pointer into the arena, the name is not null terminated
+    const char* getName( const nameId_t& rId, size_t& rLength ) const
+    {
+        rLength = ( size_t )( mOffsets[rId + 1] - mOffsets[rId] );
+        return mArena.empty() ? "" : &mArena[0] + mOffsets[rId];
+    }
+
+    void getName( const nameId_t& rId, std::string& rName ) const
+    {
+        size_t lLength = 0;
+        const char* lName = getName( rId, lLength );
+        rName.assign( lName, lLength );
+    }
+
+    // Pre sizes the table and the arena to avoid rehashing while loading
+    void reserve( size_t pNumNames, size_t pNumChars );
+
+    void clear();
+
+    void swap( NameInterner& rOther )
+    {
+        mArena.swap( rOther.mArena );
+        mOffsets.swap( rOther.mOffsets );
+        mHashes.swap( rOther.mHashes );
+        mSlots.swap( rOther.mSlots );
+        std::swap( mMask, rOther.mMask );
+    }
+
+    size_t size() const
+    {
+        return mHashes.size();
+    }
+
+    bool empty() const
+    {
+        return mHashes.empty();
+    }
+
+    // Heap bytes held by the arena and the tables
+    size_t getNumBytes() const
+    {
+        return mArena.capacity() + mOffsets.capacity() * sizeof( uint64_t ) +
+               mHashes.capacity() * sizeof( hash_t ) + mSlots.capacity() * sizeof( nameId_t );
+    }
+
+    static hash_t hash( const char* pName, size_t pLength );
+
+private:
+    bool equals( const nameId_t& rId, const char* pName, size_t pLength ) const;
+    void grow( size_t pMinSlots );
+
+    std::vector<char> mArena;
+    std::vector<uint64_t> mOffsets;
+    std::vector<hash_t> mHashes;
+    std::vector<nameId_t> mSlots;
+    size_t mMask;
+};
+
+#endif
@@ -2,103 +2,41 @@
 #include <cstring>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 #include <list>
 #include <CL/cl.h>
 #include "utils.h"
 #include "defines.h"
 #include "graph.h"
-
-bool nonAdjacencyColor( const Graph& rGraph,
-                        cl_command_queue pCommandQueue,
-                        cl_context& rContext, 
-                        cl_kernel& rKernel,
-                        cl_program& rProgram,
-                        Graph::byte_t* pAdjBitMatrix,
-                        size_t pAdjSize,
-                        Graph::vertexId_t* pNonAdjArray,
-                        size_t pNonAdjNumElems,
-                        Graph::vertexId_t* pNonAdjOffsetArray,
-                        size_t pNumVertices )
+#include "compactGraph.h"
+#include "bitMatrix.h"
+#include "complementView.h"
+
+// Index of the groups argument, the same in every VIS kernel
+static const cl_uint VIS_GROUP_ARG = 5;
+
+// Runs the VIS kernel, whose inputs are already set as the arguments before
+// VIS_GROUP_ARG, then colors the vertices from the groups read back into
+// h_groups
+template< typename CompactGraphT >
+static bool runVisKernel( const Graph& rGraph,
+                          const CompactGraphT& rCompactGraph,
+                          cl_command_queue pCommandQueue,
+                          cl_kernel& rKernel,
+                          cl_mem d_groups,
+                          Graph::byte_t* h_groups,
+                          size_t groups_size,
+                          size_t pNumVertices )
 {
-    int allDone = pNumVertices;
     bool lRet = true;
 
-    size_t* work_item_counts = 0;
-    int* entry_counts = 0;
-
     int color_size = sizeof( int ) * pNumVertices;
     int* color = ( int* ) malloc( color_size );
     std::fill( color, color + pNumVertices, -1 );
 
-    Graph::byte_t *h_groups;
-    size_t num_group_elems = 0;
-    rGraph.createAdjacencyBitMatrix( h_groups, num_group_elems, pNumVertices );
-    size_t groups_size = ( size_t )std::ceil( ( ( double )num_group_elems ) / Graph::BYTE_SIZE );
-
-    unsigned int h_serial_coloring = 0;
-
-    printf("Created all the host array\n");
-
-    int num = pNumVertices;
-
-    // Create the input buffer on the device for adjacency matrix
-    cl_mem d_adj = clCreateBuffer( rContext, 
-                                   CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, 
-                                   ( pAdjSize * sizeof( Graph::byte_t ) ), 
-                                   pAdjBitMatrix, 
-                                   NULL );
-    if (!d_adj)
-    {
-        printf("Error: Failed to allocate input databuffer on device!\n");
-        lRet = false;
-    }
-
-    // Create the input buffer on the device for adjacency matrix
-    cl_mem d_non_adj = clCreateBuffer( rContext, 
-                                       CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, 
-                                       ( pNonAdjNumElems * sizeof( Graph::vertexId_t ) ), 
-                                       pNonAdjArray, 
-                                       NULL );
-    if (!d_non_adj)
-    {
-        printf("Error: Failed to allocate input databuffer on device!\n");
-        lRet = false;
-    }
-
-    // Create the input buffer on the device for adjacency matrix
-    cl_mem d_non_adj_offset_array = clCreateBuffer( rContext, 
-                                                    CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, 
-                                                    ( pNumVertices * sizeof( Graph::vertexId_t ) ), 
-                                                    pNonAdjOffsetArray, 
-                                                    NULL );
-    if (!d_non_adj)
-    {
-        printf("Error: Failed to allocate input databuffer on device!\n");
-        lRet = false;
-    }
-
-    cl_mem d_groups = clCreateBuffer( rContext, 
-                                      CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, 
-                                      groups_size, 
-                                      h_groups, 
-                                      NULL );
-    if ( !d_groups )
-    {
-        printf("Error: Failed to allocate input databuffer on device!\n");
-        lRet = false;
-    }
-
-    //cl_mem d_colors = clCreateBuffer( rContext, 
-    //                                  CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, 
-    //                                  color_size, 
-    //                                  color, 
-    //                                  NULL );
-    //if ( !d_colors )
-    //{
-    //    printf("Error: Failed to allocate input databuffer on device!\n");
-    //    lRet = false;
-    //}
+    BitMatrix lGroups;
+    size_t wordsPerRow = BitMatrix::wordsPerRow( pNumVertices );
 
     unsigned int div_factor = pNumVertices/500;
 
@@ -109,13 +47,7 @@ bool nonAdjacencyColor( const Graph& rGraph,
         START_PROFILING;
         cl_int err;
 
-        //Set the rKernel argument
-        err  = clSetKernelArg(rKernel, 0, sizeof(cl_mem), (void *) &d_adj );
-        err |= clSetKernelArg(rKernel, 1, sizeof(cl_mem), (void *) &d_non_adj );
-        err |= clSetKernelArg(rKernel, 2, sizeof(cl_mem), (void *) &d_non_adj_offset_array );
-        err |= clSetKernelArg(rKernel, 3, sizeof(unsigned int), &pNonAdjNumElems );
-        err |= clSetKernelArg(rKernel, 4, sizeof(unsigned int), &pNumVertices );
-        err |= clSetKernelArg(rKernel, 5, sizeof(cl_mem), (void *) &d_groups );
+        err = clSetKernelArg(rKernel, VIS_GROUP_ARG, sizeof(cl_mem), (void *) &d_groups );
         //err |= clSetKernelArg(rKernel, 6, sizeof(cl_mem), (void *) &d_colors );
 
         if( CL_SUCCESS == err )
@@ -197,26 +129,34 @@ bool nonAdjacencyColor( const Graph& rGraph,
                 }
 
                 PROFILE_EVENT( lEventReadBufferGroups, "GPU2HOSTRead Groups" );
+
+                // the host side scans below work a word at a time
+                lGroups.importByteMatrix( h_groups, pNumVertices, pNumVertices );
                 
                  //Printing the VIS of the vertices along with the color of the vertices
                 for (i = 0; i < div_factor; i++)
                 {
-                    unsigned int offset = i * pNumVertices;
+                    const BitMatrix::word_t* groupRow = lGroups.getRow( i );
                     printf( "VIS " );
                     PRINT_VERT(rGraph, i );
                     printf( ": " );
 
-                    for( size_t j = 0; j < pNumVertices; ++j )
+                    for( size_t j = BitMatrix::rowFindFirstSet( groupRow, wordsPerRow );
+                         j < pNumVertices;
+                         j = BitMatrix::rowFindFirstSet( groupRow, wordsPerRow, j + 1 ) )
                     {
-                        if( Graph::getBit( h_groups, offset + j ) )
-                        {
-                            PRINT_VERT(rGraph, j );
-                            
-                        }
+                        PRINT_VERT(rGraph, j );
                     }
                     printf( "\n" );
                 }//end for
             }//for loop for dividing data
+
+                if( lGroups.empty() )
+                {
+                    // nothing was read back, work on the initial groups
+                    lGroups.importByteMatrix( h_groups, pNumVertices, pNumVertices );
+                }
+
                 size_t i = 0;
                 std::list<int> listColor;
                 std::list <int>::iterator Iter;
@@ -242,37 +182,30 @@ bool nonAdjacencyColor( const Graph& rGraph,
                 bool isRemoved = false;
              
 
+                // one bit per vertex that already has a color
+                BitMatrix lColored( 1, pNumVertices );
+                BitMatrix::word_t* coloredRow = lColored.getRow( 0 );
+
                 while(!listColor.empty()) // looping for all the VIS
                 {
-
-                    unsigned int offset = listColor.front() * pNumVertices;
+                    const BitMatrix::word_t* groupRow = lGroups.getRow( listColor.front() );
 
                     isAssignColor = 0;
-                    duplicateNode = 0;
 
-                    for( size_t j = 0; j < pNumVertices; ++j )
-                    {
-                        if( Graph::getBit( h_groups, offset + j) )
-                        {
-                            if(color[j] != -1)
-                            {
-                                duplicateNode = 1;
-                                break;
-                            }
-                        }
-                    }
+                    // the VIS is impure if any of its members is already colored
+                    duplicateNode = BitMatrix::rowIntersects( groupRow, coloredRow, wordsPerRow ) ? 1 : 0;
 
                     if (duplicateNode == 0)
                     {
-                        for( size_t j = 0; j < pNumVertices; ++j )
+                        for( size_t j = BitMatrix::rowFindFirstSet( groupRow, wordsPerRow );
+                             j < pNumVertices;
+                             j = BitMatrix::rowFindFirstSet( groupRow, wordsPerRow, j + 1 ) )
                         {
-                            if(Graph::getBit( h_groups, offset + j) )
-                            {
-                                color[j] = assignColor;
-                                isAssignColor = 1;
-                                listColor.remove(j);
-                            }
+                            color[j] = assignColor;
+                            isAssignColor = 1;
+                            listColor.remove(j);
                         }
+                        BitMatrix::rowOr( coloredRow, coloredRow, groupRow, wordsPerRow );
                         ++assignColor;
                     }
 
@@ -283,17 +216,7 @@ bool nonAdjacencyColor( const Graph& rGraph,
                 }//end while
 
                 //Coloring the vertices that have a conflict colouring state as their VIS are impure
-                unsigned int maxDegree = 0;
-                size_t degree = 0;
-
-                for (unsigned int i = 0; i < pNumVertices; i++)
-                {
-                    if( rGraph.getDegree( i, degree ) )
-                    {
-                        if ( degree > maxDegree )
-                            maxDegree = degree;
-                    }
-                }
+                unsigned int maxDegree = rCompactGraph.getMaxDegree();
 
 #ifdef _DEBUG
                 printf("Max Degree is %d\n", maxDegree);
@@ -306,74 +229,283 @@ bool nonAdjacencyColor( const Graph& rGraph,
 #endif
                maxDegree = maxDegree + 1;
 
-                unsigned int* tempColorSlot = (unsigned int *) malloc (maxDegree * sizeof(unsigned int));
+                // forbidden colors of the current vertex, one bit per color
+                BitMatrix lColorSlots( 1, maxDegree );
+                BitMatrix::word_t* tempColorSlot = lColorSlots.getRow( 0 );
+                size_t slotWords = lColorSlots.getWordsPerRow();
 
                 for (unsigned int i = 0; i < pNumVertices; i++)
                 {   
                     if (color[i] == -1)
                     {
-                        for (unsigned int j = 0; j < maxDegree; j++)
-                        {
-                            tempColorSlot[j] = 0;
-                        }
+                        lColorSlots.clear();
 
                         printf("Working for vertex ");
                         PRINT_VERT( rGraph,i);
                         printf("\n");
 
-                        for (unsigned int j = 0; j < pNumVertices; j++)
+                        typename CompactGraphT::NeighborRange lNeighbors = rCompactGraph.getNeighbors( i );
+                        for( typename CompactGraphT::NeighborRange::const_iterator lIter = lNeighbors.begin();
+                             lIter != lNeighbors.end();
+                             ++lIter )
                         {
-                            if ((Graph::getBit( pAdjBitMatrix, (j + i * pNumVertices)) && (color[j] != -1)))
+                            unsigned int j = *lIter;
+                            if (color[j] != -1)
                             {
                                 //printf("vertexColor[%d] is %d\n", j, vertexColor[j]);                 
-                                tempColorSlot[color[j]] = 1;
+                                lColorSlots.set( 0, color[j] );
                                 //printf("%d color match with %d\n", i, j);
                             }
                         }
 
                         //The first unused color slot is used to assign color to i
-                        for (unsigned int j = 0; j < maxDegree; j++)
-                        {
-                            if (tempColorSlot[j] == 0)
-                            {
-                                color[i] = j;
-                                break;
-                            }
-                        }
+                        color[i] = BitMatrix::rowFindFirstClear( tempColorSlot, slotWords );
                     }//end if
                 }//end for
 
                 //Printing the VIS of the vertices along with the color of the vertices
                 for (i = 0; i < pNumVertices; i++)
                 {
-                    unsigned int offset = i * pNumVertices;
+                    const BitMatrix::word_t* groupRow = lGroups.getRow( i );
                     printf( "VIS " );
                     PRINT_VERT(rGraph, i );
                     printf(" -> %d", color[i]);
                     printf( ": " );
 
-                    for( size_t j = 0; j < pNumVertices; ++j )
+                    for( size_t j = BitMatrix::rowFindFirstSet( groupRow, wordsPerRow );
+                         j < pNumVertices;
+                         j = BitMatrix::rowFindFirstSet( groupRow, wordsPerRow, j + 1 ) )
                     {
-                        if( Graph::getBit( h_groups, offset + j ) )
-                        {
-                            PRINT_VERT(rGraph, j );
-                            //printf( "%d : %d", j, vertexColor[j] );
-                        }
+                        PRINT_VERT(rGraph, j );
+                        //printf( "%d : %d", j, vertexColor[j] );
                     }
                     printf( "\n" );
                 }//end for
         
         END_PROFILING;
+        }
+    }
+    }
+
+    free(color);
+
+    return lRet;
+}
+
+template< typename VertexId >
+bool nonAdjacencyColor( const Graph& rGraph,
+                        const CompactGraph& rCompactGraph,
+                        cl_command_queue pCommandQueue,
+                        cl_context& rContext, 
+                        cl_kernel& rKernel,
+                        cl_program& rProgram,
+                        Graph::byte_t* pAdjBitMatrix,
+                        size_t pAdjSize,
+                        const VertexId* pNonAdjArray,
+                        size_t pNonAdjNumElems,
+                        const typename VertexIdTraits<VertexId>::offset_t* pNonAdjOffsetArray,
+                        size_t pNumVertices )
+{
+    bool lRet = true;
+
+    Graph::byte_t *h_groups;
+    size_t num_group_elems = 0;
+    rGraph.createAdjacencyBitMatrix( h_groups, num_group_elems, pNumVertices );
+    size_t groups_size = ( size_t )std::ceil( ( ( double )num_group_elems ) / Graph::BYTE_SIZE );
+
+    printf("Created all the host array\n");
+
+
+    int num = pNumVertices;
+
+    // Create the input buffer on the device for adjacency matrix
+    cl_mem d_adj = clCreateBuffer( rContext, 
+                                   CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, 
+                                   ( pAdjSize * sizeof( Graph::byte_t ) ), 
+                                   pAdjBitMatrix, 
+                                   NULL );
+    if (!d_adj)
+    {
+        printf("Error: Failed to allocate input databuffer on device!\n");
+        lRet = false;
+    }
+
+    // Create the input buffer on the device for adjacency matrix
+    cl_mem d_non_adj = clCreateBuffer( rContext, 
+                                       CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, 
+                                       ( pNonAdjNumElems * sizeof( VertexId ) ), 
+                                       ( void* )pNonAdjArray, 
+                                       NULL );
+    if (!d_non_adj)
+    {
+        printf("Error: Failed to allocate input databuffer on device!\n");
+        lRet = false;
+    }
+
+    // Create the input buffer on the device for adjacency matrix
+    cl_mem d_non_adj_offset_array = clCreateBuffer( rContext, 
+                                                    CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, 
+                                                    ( pNumVertices * sizeof( *pNonAdjOffsetArray ) ), 
+                                                    ( void* )pNonAdjOffsetArray, 
+                                                    NULL );
+    if (!d_non_adj)
+    {
+        printf("Error: Failed to allocate input databuffer on device!\n");
+        lRet = false;
+    }
+
+    cl_mem d_groups = clCreateBuffer( rContext, 
+                                      CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, 
+                                      groups_size, 
+                                      h_groups, 
+                                      NULL );
+    if ( !d_groups )
+    {
+        printf("Error: Failed to allocate input databuffer on device!\n");
+        lRet = false;
+    }
+
+    //cl_mem d_colors = clCreateBuffer( rContext, 
+    //                                  CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, 
+    //                                  color_size, 
+    //                                  color, 
+    //                                  NULL );
+    //if ( !d_colors )
+    //{
+    //    printf("Error: Failed to allocate input databuffer on device!\n");
+    //    lRet = false;
+    //}
+
+    if( lRet )
+    {
+        cl_int err;
+
+        //Set the rKernel argument
+        err  = clSetKernelArg(rKernel, 0, sizeof(cl_mem), (void *) &d_adj );
+        err |= clSetKernelArg(rKernel, 1, sizeof(cl_mem), (void *) &d_non_adj );
+        err |= clSetKernelArg(rKernel, 2, sizeof(cl_mem), (void *) &d_non_adj_offset_array );
+        err |= clSetKernelArg(rKernel, 3, sizeof(unsigned int), &pNonAdjNumElems );
+        err |= clSetKernelArg(rKernel, 4, sizeof(unsigned int), &pNumVertices );
+
+        lRet = ( CL_SUCCESS == err ) && runVisKernel( rGraph,
+                                                      rCompactGraph,
+                                                      pCommandQueue,
+                                                      rKernel,
+                                                      d_groups,
+                                                      h_groups,
+                                                      groups_size,
+                                                      pNumVertices );
     }
 
-//end if
     clReleaseMemObject(d_adj);
     clReleaseMemObject(d_non_adj);
+    clReleaseMemObject(d_non_adj_offset_array);
     clReleaseMemObject(d_groups);
 
     free(h_groups);
 
     return lRet;
 }
+
+template< typename VertexId >
+bool nonAdjacencyColor( const Graph& rGraph,
+                        const BasicCompactGraph<VertexId>& rCompactGraph,
+                        const BasicComplementView<VertexId>& rComplement,
+                        cl_command_queue pCommandQueue,
+                        cl_context& rContext,
+                        cl_kernel& rKernel,
+                        cl_program& rProgram )
+{
+    bool lRet = true;
+    unsigned int lNumVertices = rCompactGraph.size();
+
+    // the groups are the only V x V data left, one bit per pair
+    Graph::byte_t *h_groups;
+    size_t num_group_elems = 0;
+    rGraph.createAdjacencyBitMatrix( h_groups, num_group_elems, lNumVertices );
+    size_t groups_size = ( size_t )std::ceil( ( ( double )num_group_elems ) / Graph::BYTE_SIZE );
+
+    // an edgeless graph has empty neighbor arrays, the kernel never reads them
+    size_t lNumAdjacencies = std::max( rCompactGraph.getNumAdjacencies(), ( size_t )1 );
+    VertexId lDummy = 0;
+
+    cl_mem d_offsets = clCreateBuffer( rContext,
+                                       CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                       ( lNumVertices + 1 ) * sizeof( typename BasicCompactGraph<VertexId>::offset_t ),
+                                       ( void* )rCompactGraph.getOffsetArray(),
+                                       NULL );
+
+    cl_mem d_neighbors = clCreateBuffer( rContext,
+                                         CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                         lNumAdjacencies * sizeof( VertexId ),
+                                         rCompactGraph.getNumAdjacencies() ? ( void* )rCompactGraph.getNeighborArray() : &lDummy,
+                                         NULL );
+
+    cl_mem d_order = clCreateBuffer( rContext,
+                                     CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                     lNumVertices * sizeof( VertexId ),
+                                     ( void* )rComplement.getOrderArray(),
+                                     NULL );
+
+    cl_mem d_ranks = clCreateBuffer( rContext,
+                                     CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                     lNumAdjacencies * sizeof( VertexId ),
+                                     rCompactGraph.getNumAdjacencies() ? ( void* )rComplement.getRankArray() : &lDummy,
+                                     NULL );
+
+    cl_mem d_groups = clCreateBuffer( rContext,
+                                      CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                                      groups_size,
+                                      h_groups,
+                                      NULL );
+
+    if( !d_offsets || !d_neighbors || !d_order || !d_ranks || !d_groups )
+    {
+        printf("Error: Failed to allocate input databuffer on device!\n");
+        lRet = false;
+    }
+
+    if( lRet )
+    {
+        cl_int err;
+
+        err  = clSetKernelArg(rKernel, 0, sizeof(cl_mem), (void *) &d_offsets );
+        err |= clSetKernelArg(rKernel, 1, sizeof(cl_mem), (void *) &d_neighbors );
+        err |= clSetKernelArg(rKernel, 2, sizeof(cl_mem), (void *) &d_order );
+        err |= clSetKernelArg(rKernel, 3, sizeof(cl_mem), (void *) &d_ranks );
+        err |= clSetKernelArg(rKernel, 4, sizeof(unsigned int), &lNumVertices );
+
+        lRet = ( CL_SUCCESS == err ) && runVisKernel( rGraph,
+                                                      rCompactGraph,
+                                                      pCommandQueue,
+                                                      rKernel,
+                                                      d_groups,
+                                                      h_groups,
+                                                      groups_size,
+                                                      lNumVertices );
+    }
+
+    if( d_offsets ) clReleaseMemObject(d_offsets);
+    if( d_neighbors ) clReleaseMemObject(d_neighbors);
+    if( d_order ) clReleaseMemObject(d_order);
+    if( d_ranks ) clReleaseMemObject(d_ranks);
+    if( d_groups ) clReleaseMemObject(d_groups);
+
+    free(h_groups);
+
+    return lRet;
 }
-}
\ No newline at end of file
+
+#define INSTANTIATE_NON_ADJACENCY_COLOR( VertexId ) \
+    template bool nonAdjacencyColor<VertexId>( const Graph&, const CompactGraph&, cl_command_queue, cl_context&, \
+                                               cl_kernel&, cl_program&, Graph::byte_t*, size_t, const VertexId*, size_t, \
+                                               const VertexIdTraits<VertexId>::offset_t*, size_t ); \
+    template bool nonAdjacencyColor<VertexId>( const Graph&, const BasicCompactGraph<VertexId>&, \
+                                               const BasicComplementView<VertexId>&, cl_command_queue, cl_context&, \
+                                               cl_kernel&, cl_program& );
+
+INSTANTIATE_NON_ADJACENCY_COLOR( uint16_t )
+INSTANTIATE_NON_ADJACENCY_COLOR( uint32_t )
+INSTANTIATE_NON_ADJACENCY_COLOR( uint64_t )
+
+// end of file
@@ -1,16 +1,35 @@
 #ifndef _NON_ADJACENCY_COLOR_H_
 #define _NON_ADJACENCY_COLOR_H_
 
+#include "graphFwd.h"
+#include "vertexIdTraits.h"
+
+// The non adjacency stream may use any id width, the kernel must be built
+// with the matching VERTEX_ID_T / OFFSET_T (see VertexIdTraits).
+template< typename VertexId >
 bool nonAdjacencyColor( const Graph& rGraph,
+                        const CompactGraph& rCompactGraph,
                         cl_command_queue commands,
                         cl_context& context, 
                         cl_kernel& kernel,
                         cl_program& program,
                         Graph::byte_t* adjacents,
                         size_t adj_size,
-                        Graph::vertexId_t* non_adjacents,
+                        const VertexId* non_adjacents,
                         size_t non_adj_size,
-                        Graph::vertexId_t* non_adj_offset_array,
+                        const typename VertexIdTraits<VertexId>::offset_t* non_adj_offset_array,
                         size_t num_vertices );
 
+// Same coloring, for individualSetImplicit.cl. The non adjacency lists are
+// walked on the device from the CSR graph and its complement view, so only
+// the groups are V x V.
+template< typename VertexId >
+bool nonAdjacencyColor( const Graph& rGraph,
+                        const BasicCompactGraph<VertexId>& rCompactGraph,
+                        const BasicComplementView<VertexId>& rComplement,
+                        cl_command_queue commands,
+                        cl_context& context,
+                        cl_kernel& kernel,
+                        cl_program& program );
+
 #endif
@@ -1,10 +0,0 @@
-#ifndef _NON_ADJACENCY_NODE_H_
-#define _NON_ADJACENCY_NODE_H_
-
-typedef struct NonAdjacencyNode
-{
-    size_t mNumElems;
-    unsigned int* mNodes;
-} NonAdjacencyNode_t;
-
-#endif
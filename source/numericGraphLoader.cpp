@@ -0,0 +1,848 @@
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "numericGraphLoader.h"
+#include "graph.h"
+#include "compactGraph.h"
+#include "parallelUtils.h"
+#include "textChunks.h"
+#include "decompressStream.h"
+
+namespace
+{
+    // chunk without a bad line
+    const size_t NO_BAD_LINE = ( size_t )-1;
+
+    inline bool isBlank( char pChar )
+    {
+        return ( ' ' == pChar ) || ( '\t' == pChar ) || ( '\r' == pChar );
+    }
+
+    inline const char* skipBlanks( const char* pPos, const char* pEnd )
+    {
+        while( pPos < pEnd && isBlank( *pPos ) )
+        {
+            ++pPos;
+        }
+        return pPos;
+    }
+
+    // Reads the next unsigned decimal of the line. False at the end of the
+    // line or in front of anything but a digit.
+    inline bool readNumber( const char*& rPos, const char* pEnd, uint64_t& rValue )
+    {
+        const char* lPos = skipBlanks( rPos, pEnd );
+        if( lPos == pEnd || *lPos < '0' || *lPos > '9' )
+        {
+            rPos = lPos;
+            return false;
+        }
+
+        uint64_t lValue = 0;
+        while( lPos < pEnd && *lPos >= '0' && *lPos <= '9' )
+        {
+            lValue = lValue * 10 + ( uint64_t )( *lPos - '0' );
+            ++lPos;
+        }
+
+        rPos = lPos;
+        rValue = lValue;
+        return true;
+    }
+
+    // Steps rPos over the next line of the header, false at the end of the
+    // file. rBegin starts at the first non blank character.
+    bool nextHeaderLine( const char* pData, size_t pSize, size_t& rPos, const char*& rBegin, const char*& rEnd )
+    {
+        if( rPos >= pSize )
+        {
+            return false;
+        }
+
+        rEnd = findLineEnd( pData + rPos, pData + pSize );
+        rBegin = skipBlanks( pData + rPos, rEnd );
+        rPos = ( size_t )( rEnd - pData ) + 1;
+        return true;
+    }
+
+    // Parses the body lines of every chunk into 0 based id pairs. A chunk
+    // that breaks the format or names a vertex past pNumVertices gets the
+    // file offset of its bad line in rBadLines, NO_BAD_LINE otherwise.
+    template< typename VertexId >
+    struct ParseEdgeChunks
+    {
+        typedef std::pair<VertexId, VertexId> idPair_t;
+
+        ParseEdgeChunks( const char* pData,
+                         const std::vector<size_t>& rBounds,
+                         GraphFormat_t pFormat,
+                         uint64_t pNumVertices,
+                         const std::vector<uint64_t>& rFirstRows,
+                         size_t pMetisSkipValues,
+                         bool pMetisEdgeWeights,
+                         std::vector< std::vector<idPair_t> >& rEdges,
+                         std::vector<size_t>& rBadLines )
+            : mData( pData ), mBounds( rBounds ), mFormat( pFormat ), mNumVertices( pNumVertices ),
+              mFirstRows( rFirstRows ), mMetisSkipValues( pMetisSkipValues ), mMetisEdgeWeights( pMetisEdgeWeights ),
+              mEdges( rEdges ), mBadLines( rBadLines )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                const char* lBadLine = NULL;
+                mEdges[lIdx].clear();
+                mBadLines[lIdx] = parse( mData + mBounds[lIdx], mData + mBounds[lIdx + 1],
+                                         mFirstRows.empty() ? 0 : mFirstRows[lIdx], mEdges[lIdx], lBadLine ) ?
+                                  NO_BAD_LINE : ( size_t )( lBadLine - mData );
+            }
+        }
+
+        // An edge given by two 1 based numbers
+        bool addEdge( uint64_t pFirst, uint64_t pSecond, std::vector<idPair_t>& rEdges ) const
+        {
+            if( 0 == pFirst || 0 == pSecond || pFirst > mNumVertices || pSecond > mNumVertices )
+            {
+                return false;
+            }
+            rEdges.push_back( idPair_t( ( VertexId )( pFirst - 1 ), ( VertexId )( pSecond - 1 ) ) );
+            return true;
+        }
+
+        // Leaves the start of the first line that breaks the format in
+        // rBadLine
+        bool parse( const char* pBegin, const char* pEnd, uint64_t pRow, std::vector<idPair_t>& rEdges, const char*& rBadLine ) const
+        {
+            while( pBegin < pEnd )
+            {
+                const char* lLineEnd = findLineEnd( pBegin, pEnd );
+                if( !parseLine( skipBlanks( pBegin, lLineEnd ), lLineEnd, pRow, rEdges ) )
+                {
+                    rBadLine = pBegin;
+                    return false;
+                }
+                pBegin = lLineEnd + 1;
+            }
+            return true;
+        }
+
+        bool parseLine( const char* pPos, const char* pLineEnd, uint64_t& rRow, std::vector<idPair_t>& rEdges ) const
+        {
+            uint64_t lFirst = 0;
+            uint64_t lSecond = 0;
+
+            switch( mFormat )
+            {
+            case GRAPH_FORMAT_DIMACS:
+                // comments, node descriptors and blank lines carry no edge
+                if( pPos < pLineEnd && 'e' == *pPos )
+                {
+                    ++pPos;
+                    return readNumber( pPos, pLineEnd, lFirst ) && readNumber( pPos, pLineEnd, lSecond ) &&
+                           addEdge( lFirst, lSecond, rEdges );
+                }
+                return !( pPos < pLineEnd && 'p' == *pPos );
+
+            case GRAPH_FORMAT_MATRIX_MARKET:
+                // the value, if any, is not needed
+                if( pPos < pLineEnd && '%' != *pPos )
+                {
+                    return readNumber( pPos, pLineEnd, lFirst ) && readNumber( pPos, pLineEnd, lSecond ) &&
+                           addEdge( lFirst, lSecond, rEdges );
+                }
+                return true;
+
+            case GRAPH_FORMAT_METIS:
+                if( pPos < pLineEnd && '%' == *pPos )
+                {
+                    return true;
+                }
+
+                // every other line is the row of the next vertex, blank
+                // rows past the last vertex are trailing empty lines
+                ++rRow;
+                if( rRow > mNumVertices )
+                {
+                    return skipBlanks( pPos, pLineEnd ) == pLineEnd;
+                }
+
+                for( size_t lSkip = 0; lSkip < mMetisSkipValues; ++lSkip )
+                {
+                    if( !readNumber( pPos, pLineEnd, lFirst ) )
+                    {
+                        return false;
+                    }
+                }
+                while( readNumber( pPos, pLineEnd, lSecond ) )
+                {
+                    if( !addEdge( rRow, lSecond, rEdges ) ||
+                        ( mMetisEdgeWeights && !readNumber( pPos, pLineEnd, lFirst ) ) )
+                    {
+                        return false;
+                    }
+                }
+                return pPos == pLineEnd;
+
+            default:
+                return false;
+            }
+        }
+
+        const char* mData;
+        const std::vector<size_t>& mBounds;
+        GraphFormat_t mFormat;
+        uint64_t mNumVertices;
+        const std::vector<uint64_t>& mFirstRows;
+        size_t mMetisSkipValues;
+        bool mMetisEdgeWeights;
+        std::vector< std::vector<idPair_t> >& mEdges;
+        std::vector<size_t>& mBadLines;
+    };
+
+    // METIS rows are numbered by position: counts the rows, i.e. the lines
+    // that are not comments, of every chunk
+    struct CountMetisRows
+    {
+        CountMetisRows( const char* pData, const std::vector<size_t>& rBounds, std::vector<uint64_t>& rCounts )
+            : mData( pData ), mBounds( rBounds ), mCounts( rCounts )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                const char* lPos = mData + mBounds[lIdx];
+                const char* lEnd = mData + mBounds[lIdx + 1];
+                uint64_t lCount = 0;
+                while( lPos < lEnd )
+                {
+                    const char* lLineEnd = findLineEnd( lPos, lEnd );
+                    const char* lFirst = skipBlanks( lPos, lLineEnd );
+                    if( lFirst == lLineEnd || '%' != *lFirst )
+                    {
+                        ++lCount;
+                    }
+                    lPos = lLineEnd + 1;
+                }
+                mCounts[lIdx] = lCount;
+            }
+        }
+
+        const char* mData;
+        const std::vector<size_t>& mBounds;
+        std::vector<uint64_t>& mCounts;
+    };
+
+    typedef std::pair<uint64_t, uint64_t> labelPair_t;
+
+    // characters the edge list syntax drops around a name
+    inline bool isIgnored( char pChar )
+    {
+        return ( ' ' == pChar ) || ( '\r' == pChar );
+    }
+
+    // A name of the id edge list: the digits of a number as getName would
+    // print it, so nothing that GraphLoader would read as another name.
+    // rPresent is false for an empty field.
+    bool readLabel( const char* pBegin, const char* pEnd, bool& rPresent, uint64_t& rLabel )
+    {
+        while( pBegin < pEnd && isIgnored( *pBegin ) )
+        {
+            ++pBegin;
+        }
+        while( pEnd > pBegin && isIgnored( pEnd[-1] ) )
+        {
+            --pEnd;
+        }
+
+        rPresent = ( pBegin != pEnd );
+        if( !rPresent )
+        {
+            return true;
+        }
+        if( pEnd - pBegin > 19 || ( '0' == *pBegin && pEnd - pBegin > 1 ) )
+        {
+            return false;
+        }
+
+        const char* lPos = pBegin;
+        return readNumber( lPos, pEnd, rLabel ) && lPos == pEnd;
+    }
+
+    // Parses "a,b" lines the way GraphLoader does, a lone name on a line or
+    // on either side of the comma being a vertex only
+    bool parseIdLines( const char* pBegin, const char* pEnd, std::vector<labelPair_t>& rEdges, std::vector<uint64_t>& rLone )
+    {
+        while( pBegin < pEnd )
+        {
+            const char* lLineEnd = findLineEnd( pBegin, pEnd );
+            const char* lFirst = pBegin;
+            pBegin = lLineEnd + 1;
+
+            while( lFirst < lLineEnd && isIgnored( *lFirst ) )
+            {
+                ++lFirst;
+            }
+            if( lFirst == lLineEnd || Graph::COMMENT_CHAR == *lFirst )
+            {
+                continue;
+            }
+
+            const char* lComma = ( const char* )memchr( lFirst, ',', lLineEnd - lFirst );
+            bool lHasFirst = false;
+            bool lHasSecond = false;
+            uint64_t lFirstLabel = 0;
+            uint64_t lSecondLabel = 0;
+            if( !readLabel( lFirst, lComma ? lComma : lLineEnd, lHasFirst, lFirstLabel ) ||
+                ( lComma && !readLabel( lComma + 1, lLineEnd, lHasSecond, lSecondLabel ) ) )
+            {
+                return false;
+            }
+
+            if( lHasFirst && lHasSecond )
+            {
+                rEdges.push_back( labelPair_t( lFirstLabel, lSecondLabel ) );
+            }
+            else if( lHasFirst || lHasSecond )
+            {
+                rLone.push_back( lHasFirst ? lFirstLabel : lSecondLabel );
+            }
+        }
+        return true;
+    }
+
+    struct ParseIdChunks
+    {
+        ParseIdChunks( const char* pData,
+                       const std::vector<size_t>& rBounds,
+                       std::vector< std::vector<labelPair_t> >& rEdges,
+                       std::vector< std::vector<uint64_t> >& rLone,
+                       std::vector<char>& rValid )
+            : mData( pData ), mBounds( rBounds ), mEdges( rEdges ), mLone( rLone ), mValid( rValid )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                mValid[lIdx] = parseIdLines( mData + mBounds[lIdx], mData + mBounds[lIdx + 1], mEdges[lIdx], mLone[lIdx] );
+            }
+        }
+
+        const char* mData;
+        const std::vector<size_t>& mBounds;
+        std::vector< std::vector<labelPair_t> >& mEdges;
+        std::vector< std::vector<uint64_t> >& mLone;
+        std::vector<char>& mValid;
+    };
+
+    // Turns label edges into dense id pairs: an offset when the labels run
+    // without gaps, a search of the sorted labels otherwise
+    template< typename VertexId >
+    struct MapLabelEdges
+    {
+        typedef std::pair<VertexId, VertexId> idPair_t;
+
+        MapLabelEdges( const labelPair_t* pLabelEdges, const std::vector<uint64_t>& rLabels, uint64_t pFirstLabel, idPair_t* pEdges )
+            : mLabelEdges( pLabelEdges ), mLabels( rLabels ), mFirstLabel( pFirstLabel ), mEdges( pEdges )
+        {}
+
+        VertexId map( uint64_t pLabel ) const
+        {
+            if( mLabels.empty() )
+            {
+                return ( VertexId )( pLabel - mFirstLabel );
+            }
+            return ( VertexId )( std::lower_bound( mLabels.begin(), mLabels.end(), pLabel ) - mLabels.begin() );
+        }
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                mEdges[lIdx] = idPair_t( map( mLabelEdges[lIdx].first ), map( mLabelEdges[lIdx].second ) );
+            }
+        }
+
+        const labelPair_t* mLabelEdges;
+        const std::vector<uint64_t>& mLabels;
+        uint64_t mFirstLabel;
+        idPair_t* mEdges;
+    };
+}
+
+bool parseGraphFormat( const char* pName, GraphFormat_t& rFormat )
+{
+    static const GraphFormat_t sFormats[] = { GRAPH_FORMAT_EDGE_LIST, GRAPH_FORMAT_ID_EDGE_LIST, GRAPH_FORMAT_DIMACS,
+                                              GRAPH_FORMAT_METIS, GRAPH_FORMAT_MATRIX_MARKET };
+
+    for( size_t lIdx = 0; lIdx < sizeof( sFormats ) / sizeof( sFormats[0] ); ++lIdx )
+    {
+        if( 0 == strcmp( pName, getGraphFormatName( sFormats[lIdx] ) ) )
+        {
+            rFormat = sFormats[lIdx];
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* getGraphFormatName( GraphFormat_t pFormat )
+{
+    switch( pFormat )
+    {
+    case GRAPH_FORMAT_ID_EDGE_LIST:
+        return "ids";
+    case GRAPH_FORMAT_DIMACS:
+        return "dimacs";
+    case GRAPH_FORMAT_METIS:
+        return "metis";
+    case GRAPH_FORMAT_MATRIX_MARKET:
+        return "mtx";
+    default:
+        return "edges";
+    }
+}
+
+GraphFormat_t detectGraphFormat( const char* pFilename )
+{
+    // only GraphLoader streams compressed input
+    if( DecompressStream::isCompressed( pFilename ) )
+    {
+        return GRAPH_FORMAT_EDGE_LIST;
+    }
+
+    const char* lExtension = strrchr( pFilename, '.' );
+    if( lExtension )
+    {
+        if( 0 == strcmp( lExtension, ".col" ) )
+        {
+            return GRAPH_FORMAT_DIMACS;
+        }
+        if( 0 == strcmp( lExtension, ".graph" ) || 0 == strcmp( lExtension, ".metis" ) )
+        {
+            return GRAPH_FORMAT_METIS;
+        }
+        if( 0 == strcmp( lExtension, ".mtx" ) )
+        {
+            return GRAPH_FORMAT_MATRIX_MARKET;
+        }
+    }
+
+    // the complete lines of the first block decide
+    static const size_t SNIFF_BYTES = 64 * 1024;
+    std::vector<char> lBuffer( SNIFF_BYTES );
+    size_t lSize = 0;
+    FILE* lFile = fopen( pFilename, "rb" );
+    if( lFile )
+    {
+        lSize = fread( &lBuffer[0], 1, SNIFF_BYTES, lFile );
+        fclose( lFile );
+    }
+    if( SNIFF_BYTES == lSize )
+    {
+        while( lSize && '\n' != lBuffer[lSize - 1] )
+        {
+            --lSize;
+        }
+    }
+
+    std::vector<labelPair_t> lEdges;
+    std::vector<uint64_t> lLone;
+    if( lSize && parseIdLines( &lBuffer[0], &lBuffer[0] + lSize, lEdges, lLone ) && ( !lEdges.empty() || !lLone.empty() ) )
+    {
+        return GRAPH_FORMAT_ID_EDGE_LIST;
+    }
+    return GRAPH_FORMAT_EDGE_LIST;
+}
+
+NumericGraphLoader::NumericGraphLoader()
+    : mFormat( GRAPH_FORMAT_DIMACS )
+    , mNumVertices( 0 )
+    , mBodyPos( 0 )
+    , mMetisSkipValues( 0 )
+    , mMetisEdgeWeights( false )
+    , mFirstLabel( 1 )
+    , mOpenMs( 0 )
+    , mNumEdges( 0 )
+    , mElapsedMs( 0 )
+{
+}
+
+void NumericGraphLoader::close()
+{
+    mFile.close();
+    mNumVertices = 0;
+    mBodyPos = 0;
+    mMetisSkipValues = 0;
+    mMetisEdgeWeights = false;
+    mFirstLabel = 1;
+    std::vector<uint64_t>().swap( mLabels );
+    std::vector<labelPair_t>().swap( mLabelEdges );
+    mOpenMs = 0;
+}
+
+bool NumericGraphLoader::open( const char* pFilename, GraphFormat_t pFormat )
+{
+    close();
+    mFormat = pFormat;
+
+    WallTimer lTimer;
+    if( !mFile.open( pFilename ) )
+    {
+        return false;
+    }
+
+    bool lRet = false;
+    switch( pFormat )
+    {
+    case GRAPH_FORMAT_ID_EDGE_LIST:
+        lRet = readIdEdgeList();
+        break;
+    case GRAPH_FORMAT_DIMACS:
+        lRet = readDimacsHeader();
+        break;
+    case GRAPH_FORMAT_METIS:
+        lRet = readMetisHeader();
+        break;
+    case GRAPH_FORMAT_MATRIX_MARKET:
+        lRet = readMatrixMarketHeader();
+        break;
+    default:
+        break;
+    }
+
+    if( !lRet || 0 == mNumVertices )
+    {
+        printf( "Invalid %s input in %s\n", getGraphFormatName( pFormat ), pFilename );
+        close();
+        return false;
+    }
+
+    mOpenMs = lTimer.getElapsedMs();
+    return true;
+}
+
+bool NumericGraphLoader::readIdEdgeList()
+{
+    const char* lData = mFile.getData();
+    std::vector<size_t> lBounds;
+    splitTextChunks( lData, 0, mFile.getSize(), TEXT_CHUNK_BYTES, lBounds );
+    size_t lNumChunks = lBounds.size() - 1;
+
+    std::vector< std::vector<labelPair_t> > lChunkEdges( lNumChunks );
+    std::vector< std::vector<uint64_t> > lChunkLone( lNumChunks );
+    std::vector<char> lValid( lNumChunks, 0 );
+    ParseIdChunks lParser( lData, lBounds, lChunkEdges, lChunkLone, lValid );
+    parallelFor( 0, lNumChunks, lParser, 1 );
+
+    size_t lNumEdges = 0;
+    size_t lNumLone = 0;
+    for( size_t lIdx = 0; lIdx < lNumChunks; ++lIdx )
+    {
+        if( !lValid[lIdx] )
+        {
+            return false;
+        }
+        lNumEdges += lChunkEdges[lIdx].size();
+        lNumLone += lChunkLone[lIdx].size();
+    }
+
+    // every label seen, sorted and made unique, numbers the vertices
+    std::vector<uint64_t> lLabels;
+    lLabels.reserve( 2 * lNumEdges + lNumLone );
+    mLabelEdges.reserve( lNumEdges );
+    for( size_t lIdx = 0; lIdx < lNumChunks; ++lIdx )
+    {
+        const std::vector<labelPair_t>& rEdges = lChunkEdges[lIdx];
+        for( size_t lEdge = 0; lEdge < rEdges.size(); ++lEdge )
+        {
+            lLabels.push_back( rEdges[lEdge].first );
+            lLabels.push_back( rEdges[lEdge].second );
+        }
+        lLabels.insert( lLabels.end(), lChunkLone[lIdx].begin(), lChunkLone[lIdx].end() );
+        mLabelEdges.insert( mLabelEdges.end(), rEdges.begin(), rEdges.end() );
+
+        std::vector<labelPair_t>().swap( lChunkEdges[lIdx] );
+        std::vector<uint64_t>().swap( lChunkLone[lIdx] );
+    }
+
+    parallelRadixSort( lLabels );
+    lLabels.erase( std::unique( lLabels.begin(), lLabels.end() ), lLabels.end() );
+    if( lLabels.empty() )
+    {
+        return false;
+    }
+
+    mNumVertices = lLabels.size();
+    mFirstLabel = lLabels[0];
+    if( lLabels.back() - lLabels[0] != lLabels.size() - 1 )
+    {
+        mLabels.swap( lLabels );
+    }
+    return true;
+}
+
+bool NumericGraphLoader::readDimacsHeader()
+{
+    const char* lBegin = NULL;
+    const char* lEnd = NULL;
+
+    // "p <format> <vertices> <edges>" after the comments
+    while( nextHeaderLine( mFile.getData(), mFile.getSize(), mBodyPos, lBegin, lEnd ) )
+    {
+        if( lBegin == lEnd || 'c' == *lBegin )
+        {
+            continue;
+        }
+        if( 'p' != *lBegin )
+        {
+            return false;
+        }
+
+        const char* lPos = skipBlanks( lBegin + 1, lEnd );
+        while( lPos < lEnd && !isBlank( *lPos ) )
+        {
+            ++lPos;
+        }
+
+        uint64_t lNumVertices = 0;
+        uint64_t lNumEdges = 0;
+        if( !readNumber( lPos, lEnd, lNumVertices ) || !readNumber( lPos, lEnd, lNumEdges ) )
+        {
+            return false;
+        }
+        mNumVertices = ( size_t )lNumVertices;
+        return true;
+    }
+    return false;
+}
+
+bool NumericGraphLoader::readMetisHeader()
+{
+    const char* lBegin = NULL;
+    const char* lEnd = NULL;
+
+    // "<vertices> <edges> [<fmt> [<ncon>]]" after the comments
+    while( nextHeaderLine( mFile.getData(), mFile.getSize(), mBodyPos, lBegin, lEnd ) )
+    {
+        if( lBegin < lEnd && '%' == *lBegin )
+        {
+            continue;
+        }
+
+        const char* lPos = lBegin;
+        uint64_t lNumVertices = 0;
+        uint64_t lNumEdges = 0;
+        if( !readNumber( lPos, lEnd, lNumVertices ) || !readNumber( lPos, lEnd, lNumEdges ) )
+        {
+            return false;
+        }
+
+        // fmt is up to three binary digits: vertex sizes, vertex weights,
+        // edge weights
+        std::string lFmt;
+        lPos = skipBlanks( lPos, lEnd );
+        while( lPos < lEnd && !isBlank( *lPos ) )
+        {
+            lFmt.push_back( *lPos++ );
+        }
+        if( lFmt.size() > 3 || lFmt.find_first_not_of( "01" ) != std::string::npos )
+        {
+            return false;
+        }
+        lFmt.insert( 0, 3 - lFmt.size(), '0' );
+
+        uint64_t lNumConstraints = 1;
+        if( readNumber( lPos, lEnd, lNumConstraints ) && 0 == lNumConstraints )
+        {
+            return false;
+        }
+
+        mNumVertices = ( size_t )lNumVertices;
+        mMetisSkipValues = ( '1' == lFmt[0] ? 1 : 0 ) + ( '1' == lFmt[1] ? ( size_t )lNumConstraints : 0 );
+        mMetisEdgeWeights = ( '1' == lFmt[2] );
+        return true;
+    }
+    return false;
+}
+
+bool NumericGraphLoader::readMatrixMarketHeader()
+{
+    const char* lBegin = NULL;
+    const char* lEnd = NULL;
+
+    // only sparse coordinate matrices describe a graph
+    if( !nextHeaderLine( mFile.getData(), mFile.getSize(), mBodyPos, lBegin, lEnd ) )
+    {
+        return false;
+    }
+    std::string lBanner( lBegin, lEnd );
+    std::transform( lBanner.begin(), lBanner.end(), lBanner.begin(), ::tolower );
+    if( 0 != lBanner.compare( 0, 14, "%%matrixmarket" ) || std::string::npos == lBanner.find( "coordinate" ) )
+    {
+        return false;
+    }
+
+    // "<rows> <columns> <entries>" after the comments
+    while( nextHeaderLine( mFile.getData(), mFile.getSize(), mBodyPos, lBegin, lEnd ) )
+    {
+        if( lBegin == lEnd || '%' == *lBegin )
+        {
+            continue;
+        }
+
+        const char* lPos = lBegin;
+        uint64_t lNumRows = 0;
+        uint64_t lNumColumns = 0;
+        uint64_t lNumEntries = 0;
+        if( !readNumber( lPos, lEnd, lNumRows ) || !readNumber( lPos, lEnd, lNumColumns ) ||
+            !readNumber( lPos, lEnd, lNumEntries ) )
+        {
+            return false;
+        }
+        mNumVertices = ( size_t )std::max( lNumRows, lNumColumns );
+        return true;
+    }
+    return false;
+}
+
+template< typename VertexId >
+bool NumericGraphLoader::parseEdges( std::vector< std::pair<VertexId, VertexId> >& rEdges )
+{
+    typedef std::pair<VertexId, VertexId> idPair_t;
+
+    rEdges.clear();
+    mNumEdges = 0;
+
+    if( !mFile.isOpen() || !fitsVertexId<VertexId>( mNumVertices ) )
+    {
+        return false;
+    }
+
+    // parsed on open already, only the ids are left to assign
+    if( GRAPH_FORMAT_ID_EDGE_LIST == mFormat )
+    {
+        rEdges.resize( mLabelEdges.size() );
+        if( !rEdges.empty() )
+        {
+            MapLabelEdges<VertexId> lMapper( &mLabelEdges[0], mLabels, mFirstLabel, &rEdges[0] );
+            parallelFor( 0, rEdges.size(), lMapper );
+        }
+        mNumEdges = rEdges.size();
+        return true;
+    }
+
+    const char* lData = mFile.getData();
+    std::vector<size_t> lBounds;
+    splitTextChunks( lData, std::min( mBodyPos, mFile.getSize() ), mFile.getSize(), TEXT_CHUNK_BYTES, lBounds );
+    size_t lNumChunks = lBounds.size() - 1;
+
+    // METIS rows need their number, counted ahead per chunk
+    std::vector<uint64_t> lFirstRows;
+    if( GRAPH_FORMAT_METIS == mFormat && lNumChunks )
+    {
+        lFirstRows.resize( lNumChunks + 1 );
+        CountMetisRows lCounter( lData, lBounds, lFirstRows );
+        parallelFor( 0, lNumChunks, lCounter, 1 );
+        parallelExclusiveScan( &lFirstRows[0], &lFirstRows[0], lNumChunks + 1 );
+    }
+
+    std::vector< std::vector<idPair_t> > lChunkEdges( lNumChunks );
+    std::vector<size_t> lBadLines( lNumChunks, NO_BAD_LINE );
+    ParseEdgeChunks<VertexId> lParser( lData, lBounds, mFormat, mNumVertices, lFirstRows,
+                                       mMetisSkipValues, mMetisEdgeWeights, lChunkEdges, lBadLines );
+    parallelFor( 0, lNumChunks, lParser, 1 );
+
+    size_t lNumEdges = 0;
+    for( size_t lIdx = 0; lIdx < lNumChunks; ++lIdx )
+    {
+        if( NO_BAD_LINE != lBadLines[lIdx] )
+        {
+            // the line number costs a pass up to the error, paid only here
+            size_t lOffset = lBadLines[lIdx];
+            size_t lLine = 1 + std::count( lData, lData + lOffset, '\n' );
+            printf( "Invalid %s line %lu at byte %lu\n", getGraphFormatName( mFormat ),
+                    ( unsigned long )lLine, ( unsigned long )lOffset );
+            return false;
+        }
+        lNumEdges += lChunkEdges[lIdx].size();
+    }
+
+    rEdges.reserve( lNumEdges );
+    for( size_t lIdx = 0; lIdx < lNumChunks; ++lIdx )
+    {
+        rEdges.insert( rEdges.end(), lChunkEdges[lIdx].begin(), lChunkEdges[lIdx].end() );
+        std::vector<idPair_t>().swap( lChunkEdges[lIdx] );
+    }
+
+    mNumEdges = lNumEdges;
+    return true;
+}
+
+template< typename VertexId >
+bool NumericGraphLoader::loadVertices( BasicGraph<VertexId>& rGraph ) const
+{
+    if( mLabels.empty() )
+    {
+        return rGraph.addNumberedVertices( mNumVertices, mFirstLabel );
+    }
+    return rGraph.addNumberedVertices( &mLabels[0], mNumVertices );
+}
+
+template< typename VertexId >
+bool NumericGraphLoader::loadInput( BasicGraph<VertexId>& rGraph )
+{
+    WallTimer lTimer;
+    std::vector< std::pair<VertexId, VertexId> > lEdges;
+
+    bool lRet = parseEdges( lEdges ) &&
+                loadVertices( rGraph ) &&
+                ( lEdges.empty() || rGraph.addEdges( &lEdges[0], lEdges.size() ) );
+
+    mElapsedMs = mOpenMs + lTimer.getElapsedMs();
+    return lRet;
+}
+
+template< typename VertexId >
+bool NumericGraphLoader::loadCsr( BasicCompactGraph<VertexId>& rGraph )
+{
+    WallTimer lTimer;
+    std::vector< std::pair<VertexId, VertexId> > lEdges;
+
+    bool lRet = parseEdges( lEdges ) &&
+                rGraph.build( mNumVertices, lEdges.empty() ? NULL : &lEdges[0], lEdges.size() );
+
+    mElapsedMs = mOpenMs + lTimer.getElapsedMs();
+    return lRet;
+}
+
+void NumericGraphLoader::printStats() const
+{
+    double lSeconds = mElapsedMs / 1000.0;
+    double lMegaBytes = getNumBytes() / ( 1024.0 * 1024.0 );
+
+    printf( "Loaded %.2f MB of %s, %lu vertices, %lu edge entries in %.2f ms",
+            lMegaBytes, getGraphFormatName( mFormat ), ( unsigned long )mNumVertices, ( unsigned long )mNumEdges, mElapsedMs );
+    if( lSeconds > 0 )
+    {
+        printf( " (%.1f MB/s, %.2f M edges/s)", lMegaBytes / lSeconds, mNumEdges / lSeconds / 1e6 );
+    }
+    printf( "\n" );
+}
+
+#define INSTANTIATE_NUMERIC_GRAPH_LOADER( VertexId ) \
+    template bool NumericGraphLoader::loadVertices<VertexId>( BasicGraph<VertexId>& ) const; \
+    template bool NumericGraphLoader::loadInput<VertexId>( BasicGraph<VertexId>& ); \
+    template bool NumericGraphLoader::loadCsr<VertexId>( BasicCompactGraph<VertexId>& );
+
+INSTANTIATE_NUMERIC_GRAPH_LOADER( uint16_t )
+INSTANTIATE_NUMERIC_GRAPH_LOADER( uint32_t )
+INSTANTIATE_NUMERIC_GRAPH_LOADER( uint64_t )
+
+// end of file
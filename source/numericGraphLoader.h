@@ -0,0 +1,126 @@
+#ifndef _NUMERIC_GRAPH_LOADER_H_
+#define _NUMERIC_GRAPH_LOADER_H_
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+#include "graphFwd.h"
+#include "mappedFile.h"
+
+// Input formats. The edge list is the "a,b" name format GraphLoader reads;
+// the others are read by NumericGraphLoader. The id edge list is the same
+// syntax with every name a plain decimal number (no sign, no leading
+// zero), which can have gaps; the rest number their vertices 1 .. n.
+enum GraphFormat_t
+{
+    GRAPH_FORMAT_EDGE_LIST,
+    GRAPH_FORMAT_ID_EDGE_LIST,      // "a,b" with numbers for names
+    GRAPH_FORMAT_DIMACS,            // DIMACS .col: "p edge n m", "e u v"
+    GRAPH_FORMAT_METIS,             // METIS: "n m [fmt [ncon]]", line i lists the neighbors of i
+    GRAPH_FORMAT_MATRIX_MARKET      // MatrixMarket coordinate: "rows cols nnz", "i j [value]"
+};
+
+bool parseGraphFormat( const char* pName, GraphFormat_t& rFormat );
+
+const char* getGraphFormatName( GraphFormat_t pFormat );
+
+// Picks the format from the file extension: .col, .graph / .metis and
+// .mtx; anything else is an edge list, an id edge list if its first lines
+// only hold numbers. Those may still be followed by names, so a failed id
+// load should fall back to GraphLoader. A gzip or zstd file is always an
+// edge list.
+GraphFormat_t detectGraphFormat( const char* pFilename );
+
+// Reads the numbered formats without touching a string: the header is read
+// on open(), the body is split at line boundaries and parsed into id pairs
+// on the thread pool, like GraphLoader does. The vertices go to a numbered
+// Graph, or the edges straight into a CSR.
+//
+// An id edge list has no header to give the vertex count, so open() parses
+// it whole: the labels are radix sorted and deduplicated into the dense id
+// space, vertex ids follow ascending labels.
+class NumericGraphLoader
+{
+public:
+    NumericGraphLoader();
+
+    // Maps the file and reads the header. False if the file cannot be read
+    // or the header is malformed.
+    bool open( const char* pFilename, GraphFormat_t pFormat );
+
+    void close();
+
+    size_t getNumVertices() const
+    {
+        return mNumVertices;
+    }
+
+    // Numbers the vertices of the empty rGraph with their labels
+    template< typename VertexId >
+    bool loadVertices( BasicGraph<VertexId>& rGraph ) const;
+
+    // Same as above, plus every edge in one addEdges batch
+    template< typename VertexId >
+    bool loadInput( BasicGraph<VertexId>& rGraph );
+
+    // Builds rGraph from the edges without going through a Graph
+    template< typename VertexId >
+    bool loadCsr( BasicCompactGraph<VertexId>& rGraph );
+
+    // Throughput of the last load
+    void printStats() const;
+
+    size_t getNumBytes() const
+    {
+        return mFile.getSize();
+    }
+
+    size_t getNumEdges() const
+    {
+        return mNumEdges;
+    }
+
+    double getElapsedMs() const
+    {
+        return mElapsedMs;
+    }
+
+private:
+    // not copyable, owns the mapping
+    NumericGraphLoader( const NumericGraphLoader& );
+    NumericGraphLoader& operator= ( const NumericGraphLoader& );
+
+    bool readDimacsHeader();
+    bool readMetisHeader();
+    bool readMatrixMarketHeader();
+    bool readIdEdgeList();
+
+    template< typename VertexId >
+    bool parseEdges( std::vector< std::pair<VertexId, VertexId> >& rEdges );
+
+    MappedFile mFile;
+    GraphFormat_t mFormat;
+    size_t mNumVertices;
+
+    // first byte past the header
+    size_t mBodyPos;
+
+    // METIS: values ahead of the neighbors on every line, and whether a
+    // weight follows every neighbor
+    size_t mMetisSkipValues;
+    bool mMetisEdgeWeights;
+
+    // id edge list: the labels in id order, empty if they run without gaps
+    // from mFirstLabel, and the edges as labels
+    uint64_t mFirstLabel;
+    std::vector<uint64_t> mLabels;
+    std::vector< std::pair<uint64_t, uint64_t> > mLabelEdges;
+    double mOpenMs;
+
+    size_t mNumEdges;
+    double mElapsedMs;
+};
+
+#endif
@@ -0,0 +1,193 @@
+#include <cstdlib>
+
+#include "parallelUtils.h"
+
+size_t ThreadPool::sDefaultNumThreads = 0;
+
+namespace
+{
+    // pool whose task the current thread is running, and its index there
+    struct PoolContext
+    {
+        const ThreadPool* mPool;
+        size_t mThreadIdx;
+    };
+}
+
+// points at the PoolContext of the drain or inline run on the stack of
+// the current thread
+static ThreadLocalPointer sCurrentContext;
+
+ThreadPool::ThreadPool( size_t pNumThreads )
+    : mTask( NULL )
+    , mNumTasks( 0 )
+    , mNextTask( 0 )
+    , mGeneration( 0 )
+    , mNumBusy( 0 )
+    , mRunning( false )
+    , mStop( false )
+{
+    for( size_t lIdx = 1; lIdx < pNumThreads; ++lIdx )
+    {
+        Worker* lWorker = new Worker;
+        lWorker->mPool = this;
+        lWorker->mThreadIdx = lIdx;
+        if( !lWorker->mThread.start( &ThreadPool::workerMain, lWorker ) )
+        {
+            delete lWorker;
+            break;
+        }
+        mWorkers.push_back( lWorker );
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        ScopedLock lLock( mMutex );
+        mStop = true;
+    }
+    mWake.notifyAll();
+
+    for( size_t lIdx = 0; lIdx < mWorkers.size(); ++lIdx )
+    {
+        mWorkers[lIdx]->mThread.join();
+        delete mWorkers[lIdx];
+    }
+}
+
+static ThreadPool* createDefaultPool( size_t pNumThreads )
+{
+    if( 0 == pNumThreads )
+    {
+        const char* lEnv = getenv( "GRAFCOLOR_NUM_THREADS" );
+        pNumThreads = lEnv ? ( size_t )atoi( lEnv ) : Thread::getNumHardwareThreads();
+    }
+    if( 0 == pNumThreads )
+    {
+        pNumThreads = 1;
+    }
+    return new ThreadPool( pNumThreads );
+}
+
+ThreadPool& ThreadPool::instance()
+{
+    // never destroyed, workers may still be parked at exit
+    static ThreadPool* sPool = createDefaultPool( sDefaultNumThreads );
+    return *sPool;
+}
+
+void ThreadPool::setDefaultNumThreads( size_t pNumThreads )
+{
+    sDefaultNumThreads = pNumThreads;
+}
+
+void ThreadPool::drain( size_t pThreadIdx )
+{
+    PoolContext lContext = { this, pThreadIdx };
+    sCurrentContext.set( &lContext );
+    for( size_t lTaskIdx = atomicFetchIncrement( mNextTask ); lTaskIdx < mNumTasks; lTaskIdx = atomicFetchIncrement( mNextTask ) )
+    {
+        ( *mTask )( lTaskIdx, pThreadIdx );
+    }
+    sCurrentContext.set( NULL );
+}
+
+void ThreadPool::runInline( Task& rTask, size_t pNumTasks, size_t pThreadIdx )
+{
+    void* lOuterContext = sCurrentContext.get();
+    PoolContext lContext = { this, pThreadIdx };
+    sCurrentContext.set( &lContext );
+    for( size_t lTaskIdx = 0; lTaskIdx < pNumTasks; ++lTaskIdx )
+    {
+        rTask( lTaskIdx, pThreadIdx );
+    }
+    sCurrentContext.set( lOuterContext );
+}
+
+void ThreadPool::workerMain( void* pWorker )
+{
+    Worker* lWorker = ( Worker* )pWorker;
+    lWorker->mPool->workerLoop( lWorker->mThreadIdx );
+}
+
+void ThreadPool::workerLoop( size_t pThreadIdx )
+{
+    size_t lSeenGeneration = 0;
+
+    for( ;; )
+    {
+        {
+            ScopedLock lLock( mMutex );
+            while( !mStop && lSeenGeneration == mGeneration )
+            {
+                mWake.wait( lLock );
+            }
+            if( mStop )
+            {
+                return;
+            }
+            lSeenGeneration = mGeneration;
+        }
+
+        drain( pThreadIdx );
+
+        {
+            ScopedLock lLock( mMutex );
+            if( 0 == --mNumBusy )
+            {
+                mDone.notifyOne();
+            }
+        }
+    }
+}
+
+void ThreadPool::run( Task& rTask, size_t pNumTasks )
+{
+    // nested run, the workers are taken by the outer one
+    const PoolContext* lContext = ( const PoolContext* )sCurrentContext.get();
+    if( lContext && this == lContext->mPool )
+    {
+        runInline( rTask, pNumTasks, lContext->mThreadIdx );
+        return;
+    }
+
+    ScopedLock lLock( mMutex );
+    while( mRunning )
+    {
+        mIdle.wait( lLock );
+    }
+    mRunning = true;
+
+    if( mWorkers.empty() || pNumTasks < 2 )
+    {
+        lLock.unlock();
+        runInline( rTask, pNumTasks, 0 );
+        lLock.lock();
+    }
+    else
+    {
+        mTask = &rTask;
+        mNumTasks = pNumTasks;
+        mNextTask = 0;
+        mNumBusy = mWorkers.size();
+        ++mGeneration;
+        lLock.unlock();
+
+        mWake.notifyAll();
+        drain( 0 );
+
+        lLock.lock();
+        while( mNumBusy )
+        {
+            mDone.wait( lLock );
+        }
+        mTask = NULL;
+    }
+
+    mRunning = false;
+    lLock.unlock();
+    mIdle.notifyOne();
+}
+
+// end of file
@@ -0,0 +1,467 @@
+#ifndef _PARALLEL_UTILS_H_
+#define _PARALLEL_UTILS_H_
+
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+#include "hostPlatform.h"
+
+// Persistent pool of worker threads for the host side builders. The calling
+// thread takes part in every run, so a pool of N threads starts N - 1
+// workers. Participants are numbered 0 .. getNumThreads() - 1, the caller
+// being 0, which lets callers keep one scratch buffer per participant.
+class ThreadPool
+{
+public:
+    // Unit of work handed to run(), called once per task index
+    class Task
+    {
+    public:
+        virtual ~Task() {}
+        virtual void operator() ( size_t pTaskIdx, size_t pThreadIdx ) = 0;
+    };
+
+    explicit ThreadPool( size_t pNumThreads );
+    ~ThreadPool();
+
+    // Process wide pool, created on first use
+    static ThreadPool& instance();
+
+    // Size of the pool instance() creates; 0 picks the number of hardware
+    // threads, or GRAFCOLOR_NUM_THREADS if set. Only has an effect before
+    // the first call to instance().
+    static void setDefaultNumThreads( size_t pNumThreads );
+
+    size_t getNumThreads() const
+    {
+        return mWorkers.size() + 1;
+    }
+
+    // Runs rTask for every index in [0, pNumTasks) and returns once all of
+    // them are done. The thread index a task gets is never shared with a
+    // task running at the same time, so per thread scratch may be keyed by
+    // it:
+    // - a run issued from another thread while the pool is busy waits for
+    //   the pool instead of running beside it;
+    // - a run issued from inside a task executes inline on the calling
+    //   thread with the caller's index, so a task must not hold scratch
+    //   keyed by its index across such a nested run.
+    void run( Task& rTask, size_t pNumTasks );
+
+private:
+    ThreadPool( const ThreadPool& );
+    ThreadPool& operator= ( const ThreadPool& );
+
+    static void workerMain( void* pWorker );
+    void workerLoop( size_t pThreadIdx );
+    void drain( size_t pThreadIdx );
+    void runInline( Task& rTask, size_t pNumTasks, size_t pThreadIdx );
+
+    // a worker thread and the index it starts with
+    struct Worker
+    {
+        ThreadPool* mPool;
+        size_t mThreadIdx;
+        Thread mThread;
+    };
+
+    std::vector<Worker*> mWorkers;
+
+    Mutex mMutex;
+    ConditionVariable mWake;
+    ConditionVariable mDone;
+    ConditionVariable mIdle;
+
+    Task* mTask;
+    size_t mNumTasks;
+    volatile size_t mNextTask;
+    size_t mGeneration;
+    size_t mNumBusy;
+    bool mRunning;
+    bool mStop;
+
+    static size_t sDefaultNumThreads;
+};
+
+// Splits [pBegin, pEnd) in chunks of pGrain indices and calls
+// rBody( lBegin, lEnd, lThreadIdx ) for each of them on the shared pool.
+// Chunk boundaries always fall on pBegin + k * pGrain.
+template< typename Body >
+class ParallelForTask : public ThreadPool::Task
+{
+public:
+    ParallelForTask( size_t pBegin, size_t pEnd, size_t pGrain, Body& rBody )
+        : mBegin( pBegin ), mEnd( pEnd ), mGrain( pGrain ), mBody( rBody )
+    {}
+
+    void operator() ( size_t pTaskIdx, size_t pThreadIdx )
+    {
+        size_t lBegin = mBegin + pTaskIdx * mGrain;
+        size_t lEnd = ( mEnd - lBegin > mGrain ) ? lBegin + mGrain : mEnd;
+        mBody( lBegin, lEnd, pThreadIdx );
+    }
+
+private:
+    size_t mBegin;
+    size_t mEnd;
+    size_t mGrain;
+    Body& mBody;
+};
+
+template< typename Body >
+void parallelFor( size_t pBegin, size_t pEnd, Body& rBody, size_t pGrain = 0 )
+{
+    if( pEnd <= pBegin )
+    {
+        return;
+    }
+
+    ThreadPool& rPool = ThreadPool::instance();
+    size_t lCount = pEnd - pBegin;
+
+    if( 0 == pGrain )
+    {
+        // a few chunks per thread evens out rows of different cost
+        pGrain = lCount / ( 8 * rPool.getNumThreads() ) + 1;
+    }
+
+    ParallelForTask<Body> lTask( pBegin, pEnd, pGrain, rBody );
+    rPool.run( lTask, ( lCount + pGrain - 1 ) / pGrain );
+}
+
+// Exclusive prefix sum of pInput into pOutput (which may alias pInput),
+// in blocks on the shared pool. Returns the total.
+template< typename T >
+class PrefixSumBody
+{
+public:
+    PrefixSumBody( const T* pInput, T* pOutput, std::vector<T>& rBlockSums, size_t pBlockSize, bool pApply )
+        : mInput( pInput ), mOutput( pOutput ), mBlockSums( rBlockSums ), mBlockSize( pBlockSize ), mApply( pApply )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        size_t lBlock = pBegin / mBlockSize;
+        if( mApply )
+        {
+            T lRunning = mBlockSums[lBlock];
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                T lValue = mInput[lIdx];
+                mOutput[lIdx] = lRunning;
+                lRunning += lValue;
+            }
+        }
+        else
+        {
+            T lSum = 0;
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                lSum += mInput[lIdx];
+            }
+            mBlockSums[lBlock] = lSum;
+        }
+    }
+
+private:
+    const T* mInput;
+    T* mOutput;
+    std::vector<T>& mBlockSums;
+    size_t mBlockSize;
+    bool mApply;
+};
+
+template< typename T >
+T parallelExclusiveScan( const T* pInput, T* pOutput, size_t pNumElems )
+{
+    size_t lBlockSize = pNumElems / ( 4 * ThreadPool::instance().getNumThreads() ) + 1;
+    if( lBlockSize < 4096 )
+    {
+        lBlockSize = 4096;
+    }
+    size_t lNumBlocks = ( pNumElems + lBlockSize - 1 ) / lBlockSize;
+
+    // pass 1: sum of every block, then a serial scan over the block sums
+    std::vector<T> lBlockSums( lNumBlocks + 1, 0 );
+    PrefixSumBody<T> lSumBody( pInput, pOutput, lBlockSums, lBlockSize, false );
+    parallelFor( 0, pNumElems, lSumBody, lBlockSize );
+
+    T lTotal = 0;
+    for( size_t lBlock = 0; lBlock < lNumBlocks; ++lBlock )
+    {
+        T lSum = lBlockSums[lBlock];
+        lBlockSums[lBlock] = lTotal;
+        lTotal += lSum;
+    }
+
+    // pass 2: every block scans itself starting from its offset
+    PrefixSumBody<T> lApplyBody( pInput, pOutput, lBlockSums, lBlockSize, true );
+    parallelFor( 0, pNumElems, lApplyBody, lBlockSize );
+
+    return lTotal;
+}
+
+// Sorts rData with operator <. Runs of equal length are sorted on the
+// shared pool, then merged pairwise in log2( threads ) rounds through one
+// scratch buffer of the same size.
+template< typename T >
+class SortRunBody
+{
+public:
+    explicit SortRunBody( T* pData )
+        : mData( pData )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        std::sort( mData + pBegin, mData + pEnd );
+    }
+
+private:
+    T* mData;
+};
+
+template< typename T >
+class MergeRunsBody
+{
+public:
+    MergeRunsBody( const T* pInput, T* pOutput, size_t pRunSize, size_t pNumElems )
+        : mInput( pInput ), mOutput( pOutput ), mRunSize( pRunSize ), mNumElems( pNumElems )
+    {}
+
+    // each index merges one pair of neighbouring runs
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        for( size_t lPair = pBegin; lPair < pEnd; ++lPair )
+        {
+            size_t lLow = lPair * 2 * mRunSize;
+            size_t lMid = std::min( lLow + mRunSize, mNumElems );
+            size_t lHigh = std::min( lMid + mRunSize, mNumElems );
+            std::merge( mInput + lLow, mInput + lMid, mInput + lMid, mInput + lHigh, mOutput + lLow );
+        }
+    }
+
+private:
+    const T* mInput;
+    T* mOutput;
+    size_t mRunSize;
+    size_t mNumElems;
+};
+
+template< typename T >
+void parallelSort( std::vector<T>& rData )
+{
+    const size_t lNumElems = rData.size();
+    const size_t lNumThreads = ThreadPool::instance().getNumThreads();
+
+    if( 1 == lNumThreads || lNumElems < 16384 )
+    {
+        std::sort( rData.begin(), rData.end() );
+        return;
+    }
+
+    size_t lRunSize = ( lNumElems + lNumThreads - 1 ) / lNumThreads;
+    SortRunBody<T> lSortBody( &rData[0] );
+    parallelFor( 0, lNumElems, lSortBody, lRunSize );
+
+    std::vector<T> lScratch( lNumElems );
+    T* lInput = &rData[0];
+    T* lOutput = &lScratch[0];
+
+    for( ; lRunSize < lNumElems; lRunSize *= 2 )
+    {
+        MergeRunsBody<T> lMergeBody( lInput, lOutput, lRunSize, lNumElems );
+        parallelFor( 0, ( lNumElems + 2 * lRunSize - 1 ) / ( 2 * lRunSize ), lMergeBody, 1 );
+        std::swap( lInput, lOutput );
+    }
+
+    if( lInput != &rData[0] )
+    {
+        rData.swap( lScratch );
+    }
+}
+
+// Sorts unsigned integer keys by their bytes, least significant first.
+// Every pass counts the digits of equal blocks on the shared pool, turns
+// the counts into per block offsets and scatters the blocks stably into a
+// scratch buffer. Passes over bytes that are zero in every key are
+// skipped, so small keys cost one or two passes.
+template< typename T >
+class RadixCountBody
+{
+public:
+    RadixCountBody( const T* pData, size_t pShift, size_t pBlockSize, std::vector<size_t>& rCounts )
+        : mData( pData ), mShift( pShift ), mBlockSize( pBlockSize ), mCounts( rCounts )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        size_t* lCounts = &mCounts[( pBegin / mBlockSize ) * 256];
+        for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+        {
+            ++lCounts[( mData[lIdx] >> mShift ) & 0xFF];
+        }
+    }
+
+private:
+    const T* mData;
+    size_t mShift;
+    size_t mBlockSize;
+    std::vector<size_t>& mCounts;
+};
+
+template< typename T >
+class RadixScatterBody
+{
+public:
+    RadixScatterBody( const T* pInput, T* pOutput, size_t pShift, size_t pBlockSize, std::vector<size_t>& rOffsets )
+        : mInput( pInput ), mOutput( pOutput ), mShift( pShift ), mBlockSize( pBlockSize ), mOffsets( rOffsets )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        size_t* lOffsets = &mOffsets[( pBegin / mBlockSize ) * 256];
+        for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+        {
+            mOutput[lOffsets[( mInput[lIdx] >> mShift ) & 0xFF]++] = mInput[lIdx];
+        }
+    }
+
+private:
+    const T* mInput;
+    T* mOutput;
+    size_t mShift;
+    size_t mBlockSize;
+    std::vector<size_t>& mOffsets;
+};
+
+template< typename T >
+void parallelRadixSort( std::vector<T>& rData )
+{
+    const size_t lNumElems = rData.size();
+    if( lNumElems < 2 )
+    {
+        return;
+    }
+
+    T lAllBits = 0;
+    for( size_t lIdx = 0; lIdx < lNumElems; ++lIdx )
+    {
+        lAllBits |= rData[lIdx];
+    }
+
+    size_t lBlockSize = lNumElems / ( 4 * ThreadPool::instance().getNumThreads() ) + 1;
+    if( lBlockSize < 65536 )
+    {
+        lBlockSize = 65536;
+    }
+    size_t lNumBlocks = ( lNumElems + lBlockSize - 1 ) / lBlockSize;
+
+    std::vector<T> lScratch( lNumElems );
+    std::vector<size_t> lCounts( lNumBlocks * 256 );
+    T* lInput = &rData[0];
+    T* lOutput = &lScratch[0];
+
+    for( size_t lShift = 0; lShift < 8 * sizeof( T ); lShift += 8 )
+    {
+        if( 0 == ( ( lAllBits >> lShift ) & 0xFF ) )
+        {
+            continue;
+        }
+
+        std::fill( lCounts.begin(), lCounts.end(), 0 );
+        RadixCountBody<T> lCountBody( lInput, lShift, lBlockSize, lCounts );
+        parallelFor( 0, lNumElems, lCountBody, lBlockSize );
+
+        // digit major, block minor, which keeps every pass stable
+        size_t lOffset = 0;
+        for( size_t lDigit = 0; lDigit < 256; ++lDigit )
+        {
+            for( size_t lBlock = 0; lBlock < lNumBlocks; ++lBlock )
+            {
+                size_t lCount = lCounts[lBlock * 256 + lDigit];
+                lCounts[lBlock * 256 + lDigit] = lOffset;
+                lOffset += lCount;
+            }
+        }
+
+        RadixScatterBody<T> lScatterBody( lInput, lOutput, lShift, lBlockSize, lCounts );
+        parallelFor( 0, lNumElems, lScatterBody, lBlockSize );
+        std::swap( lInput, lOutput );
+    }
+
+    if( lInput != &rData[0] )
+    {
+        rData.swap( lScratch );
+    }
+}
+
+// Concatenates rParts, typically one list per pool participant, into
+// rOutput in part order and empties them, copying on the shared pool.
+// Returns the number of elements gathered.
+template< typename T >
+class GatherPartsBody
+{
+public:
+    GatherPartsBody( std::vector< std::vector<T> >& rParts, const std::vector<size_t>& rOffsets, T* pOutput )
+        : mParts( rParts ), mOffsets( rOffsets ), mOutput( pOutput )
+    {}
+
+    void operator() ( size_t pBegin, size_t pEnd, size_t )
+    {
+        for( size_t lPart = pBegin; lPart < pEnd; ++lPart )
+        {
+            std::copy( mParts[lPart].begin(), mParts[lPart].end(), mOutput + mOffsets[lPart] );
+            mParts[lPart].clear();
+        }
+    }
+
+private:
+    std::vector< std::vector<T> >& mParts;
+    const std::vector<size_t>& mOffsets;
+    T* mOutput;
+};
+
+template< typename T >
+size_t parallelGather( std::vector< std::vector<T> >& rParts, std::vector<T>& rOutput )
+{
+    std::vector<size_t> lOffsets( rParts.size() + 1, 0 );
+    for( size_t lPart = 0; lPart < rParts.size(); ++lPart )
+    {
+        lOffsets[lPart] = rParts[lPart].size();
+    }
+    size_t lTotal = parallelExclusiveScan( &lOffsets[0], &lOffsets[0], lOffsets.size() );
+
+    rOutput.resize( lTotal );
+    if( lTotal )
+    {
+        GatherPartsBody<T> lGather( rParts, lOffsets, &rOutput[0] );
+        parallelFor( 0, rParts.size(), lGather, 1 );
+    }
+    return lTotal;
+}
+
+// Wall clock stopwatch for reporting host side stage timings
+class WallTimer
+{
+public:
+    WallTimer()
+        : mStart( getWallClockMs() )
+    {}
+
+    void restart()
+    {
+        mStart = getWallClockMs();
+    }
+
+    double getElapsedMs() const
+    {
+        return getWallClockMs() - mStart;
+    }
+
+private:
+    double mStart;
+};
+
+#endif
@@ -0,0 +1,411 @@
+#include <algorithm>
+
+#include "sparseBitmap.h"
+#include "bitMatrix.h"
+
+const size_t SparseBitmap::ARRAY_MAX;
+const size_t SparseBitmap::BITMAP_WORDS;
+
+struct LesserKey
+{
+    template< typename T >
+    bool operator() ( const T& rContainer, uint16_t pKey ) const
+    {
+        return rContainer.mKey < pKey;
+    }
+};
+
+static inline uint16_t highBits( SparseBitmap::value_t pValue )
+{
+    return ( uint16_t )( pValue >> 16 );
+}
+
+static inline uint16_t lowBits( SparseBitmap::value_t pValue )
+{
+    return ( uint16_t )( pValue & 0xFFFF );
+}
+
+bool SparseBitmap::Container::contains( uint16_t pLow ) const
+{
+    if( mIsBitmap )
+    {
+        return 0 != ( mBits[pLow / 64] & ( ( word_t )1 << ( pLow % 64 ) ) );
+    }
+    return std::binary_search( mArray.begin(), mArray.end(), pLow );
+}
+
+bool SparseBitmap::Container::add( uint16_t pLow )
+{
+    if( mIsBitmap )
+    {
+        word_t& rWord = mBits[pLow / 64];
+        word_t lMask = ( word_t )1 << ( pLow % 64 );
+        if( rWord & lMask )
+        {
+            return false;
+        }
+        rWord |= lMask;
+    }
+    else
+    {
+        std::vector<uint16_t>::iterator lIter = std::lower_bound( mArray.begin(), mArray.end(), pLow );
+        if( lIter != mArray.end() && *lIter == pLow )
+        {
+            return false;
+        }
+        mArray.insert( lIter, pLow );
+
+        if( mArray.size() > ARRAY_MAX )
+        {
+            toBitmap();
+        }
+    }
+    ++mCardinality;
+    return true;
+}
+
+void SparseBitmap::Container::toBitmap()
+{
+    mBits.assign( BITMAP_WORDS, 0 );
+    for( size_t lIdx = 0; lIdx < mArray.size(); ++lIdx )
+    {
+        uint16_t lLow = mArray[lIdx];
+        mBits[lLow / 64] |= ( ( word_t )1 << ( lLow % 64 ) );
+    }
+    std::vector<uint16_t>().swap( mArray );
+    mIsBitmap = true;
+}
+
+SparseBitmap::const_iterator::const_iterator( const containerVec_t* pContainers, size_t pContainerIdx )
+    : mContainers( pContainers )
+    , mContainerIdx( pContainerIdx )
+    , mPos( 0 )
+    , mValue( 0 )
+{
+    settle();
+}
+
+// Moves forward from ( mContainerIdx, mPos ) to the next set value
+void SparseBitmap::const_iterator::settle()
+{
+    while( mContainerIdx < mContainers->size() )
+    {
+        const Container& rContainer = ( *mContainers )[mContainerIdx];
+
+        if( rContainer.mIsBitmap )
+        {
+            size_t lPos = BitMatrix::rowFindFirstSet( &rContainer.mBits[0], BITMAP_WORDS, mPos );
+            if( lPos != BitMatrix::INVALID_POS )
+            {
+                mPos = lPos;
+                mValue = ( ( value_t )rContainer.mKey << 16 ) | ( value_t )lPos;
+                return;
+            }
+        }
+        else if( mPos < rContainer.mArray.size() )
+        {
+            mValue = ( ( value_t )rContainer.mKey << 16 ) | rContainer.mArray[mPos];
+            return;
+        }
+
+        ++mContainerIdx;
+        mPos = 0;
+    }
+
+    // end
+    mPos = 0;
+}
+
+SparseBitmap::const_iterator& SparseBitmap::const_iterator::operator++ ()
+{
+    ++mPos;
+    settle();
+    return *this;
+}
+
+SparseBitmap::SparseBitmap()
+    : mSize( 0 )
+{
+}
+
+void SparseBitmap::clear()
+{
+    mContainers.clear();
+    mSize = 0;
+}
+
+SparseBitmap::Container* SparseBitmap::findContainer( uint16_t pKey )
+{
+    containerVec_t::iterator lIter = std::lower_bound( mContainers.begin(), mContainers.end(), pKey, LesserKey() );
+    return ( lIter != mContainers.end() && lIter->mKey == pKey ) ? &*lIter : NULL;
+}
+
+const SparseBitmap::Container* SparseBitmap::findContainer( uint16_t pKey ) const
+{
+    containerVec_t::const_iterator lIter = std::lower_bound( mContainers.begin(), mContainers.end(), pKey, LesserKey() );
+    return ( lIter != mContainers.end() && lIter->mKey == pKey ) ? &*lIter : NULL;
+}
+
+bool SparseBitmap::add( value_t pValue )
+{
+    uint16_t lKey = highBits( pValue );
+
+    containerVec_t::iterator lIter = std::lower_bound( mContainers.begin(), mContainers.end(), lKey, LesserKey() );
+    if( lIter == mContainers.end() || lIter->mKey != lKey )
+    {
+        lIter = mContainers.insert( lIter, Container( lKey ) );
+    }
+
+    if( lIter->add( lowBits( pValue ) ) )
+    {
+        ++mSize;
+        return true;
+    }
+    return false;
+}
+
+void SparseBitmap::appendSorted( const value_t* pBegin, const value_t* pEnd )
+{
+    for( const value_t* lIter = pBegin; lIter != pEnd; ++lIter )
+    {
+        uint16_t lKey = highBits( *lIter );
+        if( mContainers.empty() || mContainers.back().mKey != lKey )
+        {
+            mContainers.push_back( Container( lKey ) );
+        }
+
+        Container& rContainer = mContainers.back();
+        if( rContainer.mIsBitmap )
+        {
+            rContainer.add( lowBits( *lIter ) );
+        }
+        else
+        {
+            // values arrive in order, no need to search
+            rContainer.mArray.push_back( lowBits( *lIter ) );
+            ++rContainer.mCardinality;
+            if( rContainer.mArray.size() > ARRAY_MAX )
+            {
+                rContainer.toBitmap();
+            }
+        }
+        ++mSize;
+    }
+}
+
+bool SparseBitmap::contains( value_t pValue ) const
+{
+    const Container* lContainer = findContainer( highBits( pValue ) );
+    return lContainer && lContainer->contains( lowBits( pValue ) );
+}
+
+size_t SparseBitmap::intersectContainers( const Container& rLhs,
+                                          const Container& rRhs,
+                                          bool pStopAtFirst,
+                                          Container* pResult )
+{
+    size_t lCount = 0;
+
+    if( rLhs.mIsBitmap && rRhs.mIsBitmap )
+    {
+        if( pStopAtFirst )
+        {
+            return BitMatrix::rowIntersects( &rLhs.mBits[0], &rRhs.mBits[0], BITMAP_WORDS ) ? 1 : 0;
+        }
+
+        std::vector<word_t> lBits( BITMAP_WORDS );
+        BitMatrix::rowAnd( &lBits[0], &rLhs.mBits[0], &rRhs.mBits[0], BITMAP_WORDS );
+        lCount = BitMatrix::rowPopcount( &lBits[0], BITMAP_WORDS );
+
+        if( pResult )
+        {
+            if( lCount > ARRAY_MAX )
+            {
+                pResult->mIsBitmap = true;
+                pResult->mBits.swap( lBits );
+            }
+            else
+            {
+                for( size_t lPos = BitMatrix::rowFindFirstSet( &lBits[0], BITMAP_WORDS );
+                     lPos != BitMatrix::INVALID_POS;
+                     lPos = BitMatrix::rowFindFirstSet( &lBits[0], BITMAP_WORDS, lPos + 1 ) )
+                {
+                    pResult->mArray.push_back( ( uint16_t )lPos );
+                }
+            }
+            pResult->mCardinality = lCount;
+        }
+        return lCount;
+    }
+
+    if( rLhs.mIsBitmap || rRhs.mIsBitmap )
+    {
+        // probe the bitmap with every value of the array
+        const Container& rArray = rLhs.mIsBitmap ? rRhs : rLhs;
+        const Container& rBitmap = rLhs.mIsBitmap ? rLhs : rRhs;
+
+        for( size_t lIdx = 0; lIdx < rArray.mArray.size(); ++lIdx )
+        {
+            uint16_t lLow = rArray.mArray[lIdx];
+            if( rBitmap.contains( lLow ) )
+            {
+                ++lCount;
+                if( pStopAtFirst )
+                {
+                    return lCount;
+                }
+                if( pResult )
+                {
+                    pResult->mArray.push_back( lLow );
+                }
+            }
+        }
+    }
+    else
+    {
+        // merge two sorted arrays
+        std::vector<uint16_t>::const_iterator lLeft = rLhs.mArray.begin();
+        std::vector<uint16_t>::const_iterator lRight = rRhs.mArray.begin();
+
+        while( lLeft != rLhs.mArray.end() && lRight != rRhs.mArray.end() )
+        {
+            if( *lLeft < *lRight )
+            {
+                ++lLeft;
+            }
+            else if( *lRight < *lLeft )
+            {
+                ++lRight;
+            }
+            else
+            {
+                ++lCount;
+                if( pStopAtFirst )
+                {
+                    return lCount;
+                }
+                if( pResult )
+                {
+                    pResult->mArray.push_back( *lLeft );
+                }
+                ++lLeft;
+                ++lRight;
+            }
+        }
+    }
+
+    if( pResult )
+    {
+        pResult->mCardinality = lCount;
+    }
+    return lCount;
+}
+
+bool SparseBitmap::intersects( const SparseBitmap& rOther ) const
+{
+    containerVec_t::const_iterator lLeft = mContainers.begin();
+    containerVec_t::const_iterator lRight = rOther.mContainers.begin();
+
+    while( lLeft != mContainers.end() && lRight != rOther.mContainers.end() )
+    {
+        if( lLeft->mKey < lRight->mKey )
+        {
+            ++lLeft;
+        }
+        else if( lRight->mKey < lLeft->mKey )
+        {
+            ++lRight;
+        }
+        else
+        {
+            if( intersectContainers( *lLeft, *lRight, true, NULL ) )
+            {
+                return true;
+            }
+            ++lLeft;
+            ++lRight;
+        }
+    }
+    return false;
+}
+
+size_t SparseBitmap::intersectionCount( const SparseBitmap& rOther ) const
+{
+    size_t lCount = 0;
+
+    containerVec_t::const_iterator lLeft = mContainers.begin();
+    containerVec_t::const_iterator lRight = rOther.mContainers.begin();
+
+    while( lLeft != mContainers.end() && lRight != rOther.mContainers.end() )
+    {
+        if( lLeft->mKey < lRight->mKey )
+        {
+            ++lLeft;
+        }
+        else if( lRight->mKey < lLeft->mKey )
+        {
+            ++lRight;
+        }
+        else
+        {
+            lCount += intersectContainers( *lLeft, *lRight, false, NULL );
+            ++lLeft;
+            ++lRight;
+        }
+    }
+    return lCount;
+}
+
+void SparseBitmap::intersect( const SparseBitmap& rOther, SparseBitmap& rResult ) const
+{
+    SparseBitmap lResult;
+
+    containerVec_t::const_iterator lLeft = mContainers.begin();
+    containerVec_t::const_iterator lRight = rOther.mContainers.begin();
+
+    while( lLeft != mContainers.end() && lRight != rOther.mContainers.end() )
+    {
+        if( lLeft->mKey < lRight->mKey )
+        {
+            ++lLeft;
+        }
+        else if( lRight->mKey < lLeft->mKey )
+        {
+            ++lRight;
+        }
+        else
+        {
+            Container lContainer( lLeft->mKey );
+            if( intersectContainers( *lLeft, *lRight, false, &lContainer ) )
+            {
+                lResult.mSize += lContainer.mCardinality;
+                lResult.mContainers.push_back( lContainer );
+            }
+            ++lLeft;
+            ++lRight;
+        }
+    }
+
+    // rResult may be one of the operands
+    rResult.mContainers.swap( lResult.mContainers );
+    rResult.mSize = lResult.mSize;
+}
+
+size_t SparseBitmap::getNumBytes() const
+{
+    size_t lBytes = mContainers.capacity() * sizeof( Container );
+    for( containerVec_t::const_iterator lIter = mContainers.begin(); lIter != mContainers.end(); ++lIter )
+    {
+        lBytes += lIter->mArray.capacity() * sizeof( uint16_t );
+        lBytes += lIter->mBits.capacity() * sizeof( word_t );
+    }
+    return lBytes;
+}
+
+size_t SparseBitmap::estimateBytes( size_t pNumValues )
+{
+    // worst case every value opens its own container
+    return pNumValues * ( sizeof( Container ) + sizeof( uint16_t ) );
+}
+
+// end of file
@@ -0,0 +1,142 @@
+#ifndef _SPARSE_BITMAP_H_
+#define _SPARSE_BITMAP_H_
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+#include <stdint.h>
+
+// Compressed bitmap over 32 bit values in the style of roaring bitmaps.
+// Values are grouped by their high 16 bits into containers; a container
+// holds its low 16 bits either as a sorted array (up to ARRAY_MAX values)
+// or as a 65536 bit bitmap, so memory follows the number of set bits
+// rather than the range of the values.
+class SparseBitmap
+{
+public:
+    typedef uint32_t value_t;
+    typedef uint64_t word_t;
+
+    static const size_t ARRAY_MAX = 4096;
+    static const size_t BITMAP_WORDS = 65536 / 64;
+
+private:
+    struct Container
+    {
+        Container( uint16_t pKey )
+            : mKey( pKey ), mIsBitmap( false ), mCardinality( 0 )
+        {}
+
+        bool contains( uint16_t pLow ) const;
+        bool add( uint16_t pLow );
+        void toBitmap();
+
+        uint16_t mKey;
+        bool mIsBitmap;
+        size_t mCardinality;
+        std::vector<uint16_t> mArray;
+        std::vector<word_t> mBits;
+    };
+
+    typedef std::vector<Container> containerVec_t;
+
+public:
+    // Forward iterator over the set values in ascending order
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef value_t value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const value_t* pointer;
+        typedef value_t reference;
+
+        const_iterator( const containerVec_t* pContainers, size_t pContainerIdx );
+
+        value_t operator* () const
+        {
+            return mValue;
+        }
+
+        const_iterator& operator++ ();
+
+        bool operator== ( const const_iterator& rOther ) const
+        {
+            return ( mContainerIdx == rOther.mContainerIdx ) && ( mPos == rOther.mPos );
+        }
+
+        bool operator!= ( const const_iterator& rOther ) const
+        {
+            return !( *this == rOther );
+        }
+
+    private:
+        void settle();
+
+        const containerVec_t* mContainers;
+        size_t mContainerIdx;
+        size_t mPos;
+        value_t mValue;
+    };
+
+    SparseBitmap();
+
+    // Returns true if the value was not set before
+    bool add( value_t pValue );
+
+    // Appends ascending values that are all greater than any value already
+    // set, without searching for the container of each value
+    void appendSorted( const value_t* pBegin, const value_t* pEnd );
+
+    bool contains( value_t pValue ) const;
+
+    void clear();
+
+    size_t size() const
+    {
+        return mSize;
+    }
+
+    bool empty() const
+    {
+        return ( 0 == mSize );
+    }
+
+    // True if the two sets share at least one value
+    bool intersects( const SparseBitmap& rOther ) const;
+
+    size_t intersectionCount( const SparseBitmap& rOther ) const;
+
+    // rResult = this & rOther
+    void intersect( const SparseBitmap& rOther, SparseBitmap& rResult ) const;
+
+    const_iterator begin() const
+    {
+        return const_iterator( &mContainers, 0 );
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator( &mContainers, mContainers.size() );
+    }
+
+    // Heap bytes held by the containers
+    size_t getNumBytes() const;
+
+    // Upper bound of getNumBytes() for a set of pNumValues values
+    static size_t estimateBytes( size_t pNumValues );
+
+private:
+    Container* findContainer( uint16_t pKey );
+    const Container* findContainer( uint16_t pKey ) const;
+
+    static size_t intersectContainers( const Container& rLhs,
+                                       const Container& rRhs,
+                                       bool pStopAtFirst,
+                                       Container* pResult );
+
+    containerVec_t mContainers;
+    size_t mSize;
+};
+
+#endif
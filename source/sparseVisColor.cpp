@@ -0,0 +1,118 @@
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+
+#include "graph.h"
+#include "compactGraph.h"
+#include "sparseBitmap.h"
+#include "bitMatrix.h"
+#include "complementView.h"
+#include "sparseVisColor.h"
+
+bool sparseVisColor( const CompactGraph& rCompactGraph,
+                     std::vector<int>& rColors,
+                     const ComplementView* pComplement )
+{
+    size_t lNumVertices = rCompactGraph.size();
+    if( 0 == lNumVertices )
+    {
+        return false;
+    }
+
+    // one compressed row per vertex, the CSR rows are already sorted
+    std::vector<SparseBitmap> lAdjacency( lNumVertices );
+    for( Graph::vertexId_t v = 0; v < lNumVertices; ++v )
+    {
+        CompactGraph::NeighborRange lNeighbors = rCompactGraph.getNeighbors( v );
+        lAdjacency[v].appendSorted( lNeighbors.begin(), lNeighbors.end() );
+    }
+
+    // non neighbors are visited in ascending degree order, as in the
+    // sorted non adjacency lists the device kernel walks
+    ComplementView lBuiltComplement;
+    if( !pComplement )
+    {
+        lBuiltComplement.build( rCompactGraph );
+        pComplement = &lBuiltComplement;
+    }
+    const ComplementView& rComplement = *pComplement;
+
+    rColors.assign( lNumVertices, -1 );
+    int lNextColor = 0;
+
+    // Only one group is alive at a time. A group that would take in an
+    // already colored vertex is impure and is dropped, so the build stops
+    // as soon as that happens.
+    SparseBitmap lGroup;
+    for( Graph::vertexId_t v = 0; v < lNumVertices; ++v )
+    {
+        if( rColors[v] != -1 )
+        {
+            continue;
+        }
+
+        lGroup.clear();
+        lGroup.add( v );
+        bool lIsImpure = false;
+
+        ComplementView::Range lNonNeighbors = rComplement.getNonNeighbors( v );
+        for( ComplementView::const_iterator lIter = lNonNeighbors.begin();
+             lIter != lNonNeighbors.end();
+             ++lIter )
+        {
+            Graph::vertexId_t lNonNeighbor = *lIter;
+
+            // conflicting if adjacent to any member of the group
+            if( lAdjacency[lNonNeighbor].intersects( lGroup ) )
+            {
+                continue;
+            }
+
+            if( rColors[lNonNeighbor] != -1 )
+            {
+                lIsImpure = true;
+                break;
+            }
+            lGroup.add( lNonNeighbor );
+        }
+
+        if( !lIsImpure )
+        {
+            for( SparseBitmap::const_iterator lIter = lGroup.begin(); lIter != lGroup.end(); ++lIter )
+            {
+                rColors[*lIter] = lNextColor;
+            }
+            ++lNextColor;
+        }
+    }
+
+    // vertices whose VIS was impure get the first color none of their neighbors has
+    BitMatrix lColorSlots( 1, rCompactGraph.getMaxDegree() + 1 );
+    BitMatrix::word_t* lSlots = lColorSlots.getRow( 0 );
+
+    for( Graph::vertexId_t v = 0; v < lNumVertices; ++v )
+    {
+        if( rColors[v] != -1 )
+        {
+            continue;
+        }
+
+        lColorSlots.clear();
+        CompactGraph::NeighborRange lNeighbors = rCompactGraph.getNeighbors( v );
+        for( CompactGraph::NeighborRange::const_iterator lIter = lNeighbors.begin();
+             lIter != lNeighbors.end();
+             ++lIter )
+        {
+            int lColor = rColors[*lIter];
+            if( lColor != -1 && ( size_t )lColor < lColorSlots.getNumCols() )
+            {
+                lColorSlots.set( 0, lColor );
+            }
+        }
+        rColors[v] = ( int )BitMatrix::rowFindFirstClear( lSlots, lColorSlots.getWordsPerRow() );
+    }
+
+    return true;
+}
+
+// end of file
@@ -0,0 +1,17 @@
+#ifndef _SPARSE_VIS_COLOR_H_
+#define _SPARSE_VIS_COLOR_H_
+
+#include <vector>
+
+#include "graphFwd.h"
+
+// Host implementation of the vertex independent set (VIS) coloring that
+// keeps adjacency rows and groups in compressed sparse bitmaps, so memory
+// grows with the number of edges instead of V * V. rColors receives one
+// color per vertex. pComplement is a ready degree order over
+// rCompactGraph, built here if NULL.
+bool sparseVisColor( const CompactGraph& rCompactGraph,
+                     std::vector<int>& rColors,
+                     const ComplementView* pComplement = NULL );
+
+#endif
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+
+#include "graph.h"
+#include "compactGraph.h"
+#include "parallelUtils.h"
+#include "speculativeColor.h"
+
+namespace
+{
+    typedef CompactGraph::vertexId_t vertexId_t;
+
+    // Gives every vertex of the worklist the smallest color none of its
+    // neighbors has right now. A neighbor colored concurrently may be read
+    // before or after it changes, which the conflict pass catches.
+    struct ColorWorklist
+    {
+        ColorWorklist( const CompactGraph& rGraph, volatile int* pColors, const vertexId_t* pWorklist,
+                       std::vector< std::vector<uint64_t> >& rForbidden, std::vector<uint64_t>& rStamps )
+            : mGraph( rGraph ), mColors( pColors ), mWorklist( pWorklist )
+            , mForbidden( rForbidden ), mStamps( rStamps )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t pThreadIdx )
+        {
+            uint64_t* lForbidden = &mForbidden[pThreadIdx][0];
+
+            // the slots are stamped, never cleared; a vertex may come
+            // back, so the stamps count up per thread instead of being ids
+            uint64_t lStamp = mStamps[pThreadIdx];
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                vertexId_t lId = mWorklist[lIdx];
+                ++lStamp;
+
+                CompactGraph::NeighborRange lNeighbors = mGraph.getNeighbors( lId );
+                for( CompactGraph::NeighborRange::const_iterator lIter = lNeighbors.begin(); lIter != lNeighbors.end(); ++lIter )
+                {
+                    int lColor = atomicLoad( mColors[*lIter] );
+                    if( lColor >= 0 )
+                    {
+                        lForbidden[lColor] = lStamp;
+                    }
+                }
+
+                int lColor = 0;
+                while( lForbidden[lColor] == lStamp )
+                {
+                    ++lColor;
+                }
+                atomicStore( mColors[lId], lColor );
+            }
+            mStamps[pThreadIdx] = lStamp;
+        }
+
+        const CompactGraph& mGraph;
+        volatile int* mColors;
+        const vertexId_t* mWorklist;
+        std::vector< std::vector<uint64_t> >& mForbidden;
+        std::vector<uint64_t>& mStamps;
+    };
+
+    // Keeps the vertices of the worklist that share their color with a
+    // higher id neighbor; the lower end of every conflict gives way, so the
+    // other keeps its color. No colors change during this pass.
+    struct FindConflicts
+    {
+        FindConflicts( const CompactGraph& rGraph, const volatile int* pColors, const vertexId_t* pWorklist,
+                       std::vector< std::vector<vertexId_t> >& rConflicts )
+            : mGraph( rGraph ), mColors( pColors ), mWorklist( pWorklist ), mConflicts( rConflicts )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t pThreadIdx )
+        {
+            std::vector<vertexId_t>& rConflicts = mConflicts[pThreadIdx];
+            for( size_t lIdx = pBegin; lIdx < pEnd; ++lIdx )
+            {
+                vertexId_t lId = mWorklist[lIdx];
+                int lColor = atomicLoad( mColors[lId] );
+
+                CompactGraph::NeighborRange lNeighbors = mGraph.getNeighbors( lId );
+                for( CompactGraph::NeighborRange::const_iterator lIter = lNeighbors.begin(); lIter != lNeighbors.end(); ++lIter )
+                {
+                    if( *lIter > lId && atomicLoad( mColors[*lIter] ) == lColor )
+                    {
+                        rConflicts.push_back( lId );
+                        break;
+                    }
+                }
+            }
+        }
+
+        const CompactGraph& mGraph;
+        const volatile int* mColors;
+        const vertexId_t* mWorklist;
+        std::vector< std::vector<vertexId_t> >& mConflicts;
+    };
+
+    struct FillIdentity
+    {
+        FillIdentity( vertexId_t* pOut )
+            : mOut( pOut )
+        {}
+
+        void operator() ( size_t pBegin, size_t pEnd, size_t )
+        {
+            for( size_t lVertex = pBegin; lVertex < pEnd; ++lVertex )
+            {
+                mOut[lVertex] = ( vertexId_t )lVertex;
+            }
+        }
+
+        vertexId_t* mOut;
+    };
+}
+
+bool speculativeColor( const CompactGraph& rCompactGraph,
+                       std::vector<int>& rColors,
+                       size_t& rNumIterations,
+                       size_t& rNumRecolored )
+{
+    rNumIterations = 0;
+    rNumRecolored = 0;
+    size_t lNumVertices = rCompactGraph.size();
+    if( 0 == lNumVertices )
+    {
+        return false;
+    }
+
+    const size_t lNumThreads = ThreadPool::instance().getNumThreads();
+    std::vector< std::vector<vertexId_t> > lConflicts( lNumThreads );
+    std::vector<vertexId_t> lWorklist( lNumVertices );
+
+    // a vertex has at most its degree of colors around it
+    std::vector< std::vector<uint64_t> > lForbidden( lNumThreads, std::vector<uint64_t>( rCompactGraph.getMaxDegree() + 1, 0 ) );
+    std::vector<uint64_t> lStamps( lNumThreads, 0 );
+
+    std::vector<int> lColors( lNumVertices, -1 );
+
+    FillIdentity lFill( &lWorklist[0] );
+    parallelFor( 0, lNumVertices, lFill );
+
+    do
+    {
+        ColorWorklist lColorer( rCompactGraph, &lColors[0], &lWorklist[0], lForbidden, lStamps );
+        parallelFor( 0, lWorklist.size(), lColorer );
+        if( rNumIterations )
+        {
+            rNumRecolored += lWorklist.size();
+        }
+        ++rNumIterations;
+
+        FindConflicts lFinder( rCompactGraph, &lColors[0], &lWorklist[0], lConflicts );
+        parallelFor( 0, lWorklist.size(), lFinder );
+    }
+    while( parallelGather( lConflicts, lWorklist ) );
+
+    rColors.swap( lColors );
+
+    return true;
+}
+
+// end of file
@@ -0,0 +1,25 @@
+#ifndef _SPECULATIVE_COLOR_H_
+#define _SPECULATIVE_COLOR_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "graphFwd.h"
+
+// Host implementation of the speculative greedy coloring of Gebremedhin
+// and Manne, with the conflict repair of Catalyurek et al., on the shared
+// thread pool. Every vertex of the worklist, at first all of them, takes
+// the smallest color its neighbors do not have, reading their colors
+// while other threads write them; then the worklist becomes the vertices
+// that ended with a higher id neighbor of the same color, and is colored
+// again, until it is empty. rColors receives one color per vertex,
+// rNumIterations the passes taken, a handful on sparse graphs, and
+// rNumRecolored the vertices colored after the first pass. The colors
+// depend on the thread schedule; with one thread the first pass is the
+// sequential first fit and leaves no conflicts.
+bool speculativeColor( const CompactGraph& rCompactGraph,
+                       std::vector<int>& rColors,
+                       size_t& rNumIterations,
+                       size_t& rNumRecolored );
+
+#endif
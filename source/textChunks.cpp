@@ -0,0 +1,22 @@
+#include "textChunks.h"
+
+void splitTextChunks( const char* pData, size_t pBegin, size_t pSize, size_t pChunkBytes, std::vector<size_t>& rBounds )
+{
+    rBounds.assign( 1, pBegin );
+    while( rBounds.back() < pSize )
+    {
+        size_t lBound = rBounds.back() + pChunkBytes;
+        if( lBound >= pSize )
+        {
+            lBound = pSize;
+        }
+        else
+        {
+            lBound = ( size_t )( findLineEnd( pData + lBound, pData + pSize ) - pData );
+            lBound = ( lBound < pSize ) ? lBound + 1 : pSize;
+        }
+        rBounds.push_back( lBound );
+    }
+}
+
+// end of file
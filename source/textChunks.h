@@ -0,0 +1,28 @@
+#ifndef _TEXT_CHUNKS_H_
+#define _TEXT_CHUNKS_H_
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Shared by the text loaders: a mapped file is cut at line boundaries into
+// chunks that parser tasks take on independently.
+
+// Bytes of text one parser task takes on; a batch is a few tasks per
+// thread, which bounds the memory held by parsed chunks between passes
+#define TEXT_CHUNK_BYTES ( 4 * 1024 * 1024 )
+#define TEXT_CHUNKS_PER_THREAD 4
+
+// Splits pData[pBegin, pSize) into chunks of about pChunkBytes, each bound
+// moved forward past the end of the line it falls in. rBounds receives
+// pBegin, the bound of every chunk and pSize last.
+void splitTextChunks( const char* pData, size_t pBegin, size_t pSize, size_t pChunkBytes, std::vector<size_t>& rBounds );
+
+// The newline ending the line that starts at pBegin, or pEnd
+inline const char* findLineEnd( const char* pBegin, const char* pEnd )
+{
+    const char* lLineEnd = ( const char* )memchr( pBegin, '\n', pEnd - pBegin );
+    return lLineEnd ? lLineEnd : pEnd;
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstring>
+
+#include "triangularBitMatrix.h"
+
+const size_t TriangularBitMatrix::WORD_BITS;
+
+// Reads 64 bits starting at an arbitrary bit position
+static inline TriangularBitMatrix::word_t readWord( const TriangularBitMatrix::word_t* pWords,
+                                                    size_t pNumWords,
+                                                    size_t pBitPos )
+{
+    size_t lIdx = pBitPos / TriangularBitMatrix::WORD_BITS;
+    size_t lShift = pBitPos % TriangularBitMatrix::WORD_BITS;
+
+    TriangularBitMatrix::word_t lWord = pWords[lIdx] >> lShift;
+    if( lShift && ( lIdx + 1 < pNumWords ) )
+    {
+        lWord |= pWords[lIdx + 1] << ( TriangularBitMatrix::WORD_BITS - lShift );
+    }
+    return lWord;
+}
+
+TriangularBitMatrix::TriangularBitMatrix()
+    : mWords( NULL )
+    , mNumVertices( 0 )
+    , mNumWords( 0 )
+{
+}
+
+TriangularBitMatrix::~TriangularBitMatrix()
+{
+    release();
+}
+
+void TriangularBitMatrix::release()
+{
+    if( mWords )
+    {
+        delete [] mWords;
+        mWords = NULL;
+    }
+    mNumVertices = 0;
+    mNumWords = 0;
+}
+
+size_t TriangularBitMatrix::requiredBytes( size_t pNumVertices )
+{
+    size_t lNumBits = pNumVertices ? pNumVertices * ( pNumVertices - 1 ) / 2 : 0;
+    return ( ( lNumBits + WORD_BITS - 1 ) / WORD_BITS ) * sizeof( word_t );
+}
+
+bool TriangularBitMatrix::resize( size_t pNumVertices )
+{
+    release();
+
+    size_t lNumWords = requiredBytes( pNumVertices ) / sizeof( word_t );
+    if( lNumWords )
+    {
+        mWords = new word_t[lNumWords];
+    }
+
+    mNumVertices = pNumVertices;
+    mNumWords = lNumWords;
+    clear();
+
+    return true;
+}
+
+void TriangularBitMatrix::clear()
+{
+    if( mWords )
+    {
+        memset( mWords, 0, getNumBytes() );
+    }
+}
+
+void TriangularBitMatrix::expandRow( size_t pRow, word_t* pDest ) const
+{
+    std::fill( pDest, pDest + BitMatrix::wordsPerRow( mNumVertices ), 0 );
+
+    // columns before the diagonal live in earlier rows, one bit per row
+    for( size_t lCol = 0; lCol < pRow; ++lCol )
+    {
+        if( isEdge( lCol, pRow ) )
+        {
+            pDest[lCol / WORD_BITS] |= ( ( word_t )1 << ( lCol % WORD_BITS ) );
+        }
+    }
+
+    // columns after the diagonal are contiguous, copy them a word at a time
+    size_t lStart = getRowStart( pRow );
+    size_t lLength = mNumVertices - pRow - 1;
+
+    for( size_t lDone = 0; lDone < lLength; lDone += WORD_BITS )
+    {
+        size_t lNumBits = std::min( WORD_BITS, lLength - lDone );
+        word_t lWord = readWord( mWords, mNumWords, lStart + lDone );
+        if( lNumBits < WORD_BITS )
+        {
+            lWord &= ( ( word_t )1 << lNumBits ) - 1;
+        }
+
+        size_t lDestPos = pRow + 1 + lDone;
+        size_t lDestIdx = lDestPos / WORD_BITS;
+        size_t lDestShift = lDestPos % WORD_BITS;
+
+        pDest[lDestIdx] |= lWord << lDestShift;
+        if( lDestShift && ( lNumBits > WORD_BITS - lDestShift ) )
+        {
+            pDest[lDestIdx + 1] |= lWord >> ( WORD_BITS - lDestShift );
+        }
+    }
+}
+
+size_t TriangularBitMatrix::getRowPopcount( size_t pRow ) const
+{
+    size_t lCount = 0;
+
+    for( size_t lCol = 0; lCol < pRow; ++lCol )
+    {
+        if( isEdge( lCol, pRow ) )
+        {
+            ++lCount;
+        }
+    }
+
+    size_t lStart = getRowStart( pRow );
+    size_t lLength = mNumVertices - pRow - 1;
+
+    for( size_t lDone = 0; lDone < lLength; lDone += WORD_BITS )
+    {
+        size_t lNumBits = std::min( WORD_BITS, lLength - lDone );
+        word_t lWord = readWord( mWords, mNumWords, lStart + lDone );
+        if( lNumBits < WORD_BITS )
+        {
+            lWord &= ( ( word_t )1 << lNumBits ) - 1;
+        }
+        lCount += BitMatrix::rowPopcount( &lWord, 1 );
+    }
+
+    return lCount;
+}
+
+// end of file
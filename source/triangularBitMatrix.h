@@ -0,0 +1,95 @@
+#ifndef _TRIANGULAR_BIT_MATRIX_H_
+#define _TRIANGULAR_BIT_MATRIX_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+#include "bitMatrix.h"
+
+// Symmetric bit matrix that only stores the strict upper triangle, i.e. the
+// V * ( V - 1 ) / 2 pairs ( i, j ) with i < j, packed row after row into 64
+// bit words (LSB first). The diagonal is not stored and always reads as 0.
+// Accessors take the pair in either order. The word array can be uploaded
+// to the device as is, see kernels/individualSetTriangular.cl.
+class TriangularBitMatrix
+{
+public:
+    typedef BitMatrix::word_t word_t;
+
+    static const size_t WORD_BITS = BitMatrix::WORD_BITS;
+
+    TriangularBitMatrix();
+    ~TriangularBitMatrix();
+
+    // Reallocates the matrix and clears every bit
+    bool resize( size_t pNumVertices );
+
+    void clear();
+
+    void release();
+
+    size_t size() const { return mNumVertices; }
+    size_t getNumWords() const { return mNumWords; }
+    size_t getNumBytes() const { return mNumWords * sizeof( word_t ); }
+    bool empty() const { return ( 0 == mNumVertices ); }
+
+    const word_t* getWords() const { return mWords; }
+
+    bool isEdge( size_t pFirst, size_t pSecond ) const
+    {
+        if( pFirst == pSecond )
+        {
+            return false;
+        }
+        size_t lBit = getBitIndex( pFirst, pSecond );
+        return 0 != ( mWords[lBit / WORD_BITS] & ( ( word_t )1 << ( lBit % WORD_BITS ) ) );
+    }
+
+    void setEdge( size_t pFirst, size_t pSecond )
+    {
+        if( pFirst != pSecond )
+        {
+            size_t lBit = getBitIndex( pFirst, pSecond );
+            mWords[lBit / WORD_BITS] |= ( ( word_t )1 << ( lBit % WORD_BITS ) );
+        }
+    }
+
+    // Expands row pRow into the full V bit row layout used by BitMatrix, so
+    // the BitMatrix row operations can be applied to it. pDest must hold at
+    // least BitMatrix::wordsPerRow( size() ) words.
+    void expandRow( size_t pRow, word_t* pDest ) const;
+
+    // Number of neighbors of pRow
+    size_t getRowPopcount( size_t pRow ) const;
+
+    // Exact number of bytes a matrix over pNumVertices vertices allocates
+    static size_t requiredBytes( size_t pNumVertices );
+
+private:
+    // not copyable
+    TriangularBitMatrix( const TriangularBitMatrix& );
+    TriangularBitMatrix& operator= ( const TriangularBitMatrix& );
+
+    // Bit offset of the first pair of row pRow, i.e. of ( pRow, pRow + 1 )
+    size_t getRowStart( size_t pRow ) const
+    {
+        return pRow * ( 2 * mNumVertices - pRow - 1 ) / 2;
+    }
+
+    size_t getBitIndex( size_t pFirst, size_t pSecond ) const
+    {
+        if( pFirst > pSecond )
+        {
+            size_t lTmp = pFirst;
+            pFirst = pSecond;
+            pSecond = lTmp;
+        }
+        return getRowStart( pFirst ) + ( pSecond - pFirst - 1 );
+    }
+
+    word_t* mWords;
+    size_t mNumVertices;
+    size_t mNumWords;
+};
+
+#endif
@@ -116,7 +116,8 @@ bool createKernelFromSource( const char* pSourceFile,
                              cl_program& program, 
                              cl_command_queue& commands, 
                              cl_kernel& kernel, 
-                             const char* kernelName )
+                             const char* kernelName,
+                             const char* buildOptions )
 {
     size_t lSrcLen = 0;
     char* lSource = loadProgSource( pSourceFile, &lSrcLen );
@@ -138,7 +139,7 @@ bool createKernelFromSource( const char* pSourceFile,
 
     printf( "Building OpenCL program from %s... ", pSourceFile );
 
-    err = clBuildProgram(program, 0, NULL, NULL, NULL, NULL);
+    err = clBuildProgram(program, 0, NULL, buildOptions, NULL, NULL);
     if (err != CL_SUCCESS)
     {
         size_t len;
@@ -15,7 +15,8 @@ bool createKernelFromSource( const char* pSourceFile,
                              cl_program& program, 
                              cl_command_queue& commands, 
                              cl_kernel& kernel, 
-                             const char* kernelName );
+                             const char* kernelName,
+                             const char* buildOptions = NULL );
 
 #ifdef _GRAFCOLOR_ENABLE_OCL_PROFILING_
 
@@ -42,8 +43,13 @@ bool createKernelFromSource( const char* pSourceFile,
 
 #define PRINT_VERT( graph, vertex ) \
     { \
+        uint64_t lVertexLabel = 0; \
         std::string lVertexName; \
-        if( graph.getName( vertex, lVertexName ) ) \
+        if( graph.getLabel( vertex, lVertexLabel ) ) \
+        { \
+            printf( "%llu ", ( unsigned long long )lVertexLabel ); \
+        } \
+        else if( graph.getName( vertex, lVertexName ) ) \
         { \
             printf( "%s ", lVertexName.c_str() ); \
         } \
@@ -0,0 +1,88 @@
+#ifndef _VERTEX_ID_TRAITS_H_
+#define _VERTEX_ID_TRAITS_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+// Properties of the vertex id widths the graph types are instantiated for.
+//   offset_t        - index into a stream of per vertex lists (non adjacency
+//                     stream offsets); wide enough for V * V entries of the
+//                     16 bit case, kept at 32 bits for 32 bit ids as the
+//                     device kernels always had it, which caps those streams
+//                     at 2^32 - 1 entries
+//   CL_TYPE_NAME    - OpenCL C spelling of the id type
+//   CL_OFFSET_NAME  - OpenCL C spelling of offset_t
+template< typename VertexId >
+struct VertexIdTraits;
+
+template<>
+struct VertexIdTraits<uint16_t>
+{
+    typedef uint32_t offset_t;
+    static const char* CL_TYPE_NAME() { return "ushort"; }
+    static const char* CL_OFFSET_NAME() { return "uint"; }
+};
+
+template<>
+struct VertexIdTraits<uint32_t>
+{
+    typedef uint32_t offset_t;
+    static const char* CL_TYPE_NAME() { return "uint"; }
+    static const char* CL_OFFSET_NAME() { return "uint"; }
+};
+
+template<>
+struct VertexIdTraits<uint64_t>
+{
+    typedef uint64_t offset_t;
+    static const char* CL_TYPE_NAME() { return "ulong"; }
+    static const char* CL_OFFSET_NAME() { return "ulong"; }
+};
+
+// True if every id of a graph with pNumVertices vertices fits in VertexId
+template< typename VertexId >
+bool fitsVertexId( size_t pNumVertices )
+{
+    return ( pNumVertices == 0 ) || ( ( uint64_t )( pNumVertices - 1 ) <= ( uint64_t )( VertexId )~( VertexId )0 );
+}
+
+// Calls rFunctor.template run<VertexId>() with the narrowest id type that
+// can number pNumVertices vertices: 16 bits below 65536 vertices, 64 bits
+// past 2^32, 32 bits otherwise. Every width is compiled in; only the
+// choice happens at run time.
+template< typename Functor >
+bool dispatchOnVertexCount( size_t pNumVertices, Functor& rFunctor )
+{
+    if( pNumVertices < 0x10000 )
+    {
+        return rFunctor.template run<uint16_t>();
+    }
+    if( ( uint64_t )pNumVertices <= 0xFFFFFFFFull )
+    {
+        return rFunctor.template run<uint32_t>();
+    }
+    return rFunctor.template run<uint64_t>();
+}
+
+// Calls rFunctor.template run<VertexId>() with the pIdBytes wide id type,
+// or the narrowest one as above if pIdBytes is 0. False for any other
+// width, or if pNumVertices vertices cannot be numbered in it.
+template< typename Functor >
+bool dispatchOnIdBytes( size_t pIdBytes, size_t pNumVertices, Functor& rFunctor )
+{
+    switch( pIdBytes )
+    {
+    case 0:
+        return dispatchOnVertexCount( pNumVertices, rFunctor );
+    case sizeof( uint16_t ):
+        return fitsVertexId<uint16_t>( pNumVertices ) && rFunctor.template run<uint16_t>();
+    case sizeof( uint32_t ):
+        return fitsVertexId<uint32_t>( pNumVertices ) && rFunctor.template run<uint32_t>();
+    case sizeof( uint64_t ):
+        return rFunctor.template run<uint64_t>();
+    default:
+        return false;
+    }
+}
+
+#endif
@@ -0,0 +1,320 @@
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "vertexOrdering.h"
+
+// Ascending degree, ties by id, so the orders are deterministic
+struct LesserDegreeId
+{
+    LesserDegreeId( const Graph& rGraph )
+        : mGraph( rGraph )
+    {}
+
+    bool operator() ( const Graph::vertexId_t& rLhs, const Graph::vertexId_t& rRhs ) const
+    {
+        size_t lLhsDegree = mGraph.getDegree( rLhs );
+        size_t lRhsDegree = mGraph.getDegree( rRhs );
+        return ( lLhsDegree < lRhsDegree ) || ( lLhsDegree == lRhsDegree && rLhs < rRhs );
+    }
+
+    const Graph& mGraph;
+};
+
+struct GreaterDegree
+{
+    GreaterDegree( const Graph& rGraph )
+        : mGraph( rGraph )
+    {}
+
+    bool operator() ( const Graph::vertexId_t& rLhs, const Graph::vertexId_t& rRhs ) const
+    {
+        return ( mGraph.getDegree( rLhs ) > mGraph.getDegree( rRhs ) );
+    }
+
+    const Graph& mGraph;
+};
+
+// Breadth first walk of the component of pRoot, appending it to rOrder.
+// Vertices whose rMarks entry equals pMark count as visited and every
+// vertex reached gets marked. With pByDegree the unvisited neighbors of a
+// vertex are queued in ascending degree, otherwise in ascending id.
+// Returns the number of levels; rLastLevel receives the position in rOrder
+// where the deepest level starts.
+static size_t levelWalk( const Graph& rGraph,
+                         Graph::vertexId_t pRoot,
+                         std::vector<size_t>& rMarks,
+                         size_t pMark,
+                         bool pByDegree,
+                         Graph::idVec_t& rOrder,
+                         size_t& rLastLevel )
+{
+    LesserDegreeId lLesserDegree( rGraph );
+    Graph::idVec_t lScratch;
+
+    size_t lLevelBegin = rOrder.size();
+    size_t lNumLevels = 0;
+
+    rMarks[pRoot] = pMark;
+    rOrder.push_back( pRoot );
+
+    while( lLevelBegin < rOrder.size() )
+    {
+        size_t lLevelEnd = rOrder.size();
+        rLastLevel = lLevelBegin;
+        ++lNumLevels;
+
+        for( size_t lPos = lLevelBegin; lPos < lLevelEnd; ++lPos )
+        {
+            Graph::NeighborRange lNeighbors = rGraph.getNeighbors( rOrder[lPos] );
+
+            lScratch.clear();
+            for( Graph::NeighborRange::const_iterator lIter = lNeighbors.begin();
+                 lIter != lNeighbors.end();
+                 ++lIter )
+            {
+                if( rMarks[*lIter] != pMark )
+                {
+                    rMarks[*lIter] = pMark;
+                    lScratch.push_back( *lIter );
+                }
+            }
+
+            if( pByDegree )
+            {
+                std::sort( lScratch.begin(), lScratch.end(), lLesserDegree );
+            }
+            rOrder.insert( rOrder.end(), lScratch.begin(), lScratch.end() );
+        }
+
+        lLevelBegin = lLevelEnd;
+    }
+
+    return lNumLevels;
+}
+
+// George - Liu search for a vertex of high eccentricity in the component of
+// pStart: keep moving to the lowest degree vertex of the deepest level
+// while that deepens the level structure
+static Graph::vertexId_t findPseudoPeripheral( const Graph& rGraph,
+                                               Graph::vertexId_t pStart,
+                                               std::vector<size_t>& rMarks,
+                                               size_t& rNextMark )
+{
+    LesserDegreeId lLesserDegree( rGraph );
+    Graph::idVec_t lOrder;
+    size_t lLastLevel = 0;
+
+    Graph::vertexId_t lRoot = pStart;
+    size_t lNumLevels = levelWalk( rGraph, lRoot, rMarks, rNextMark++, false, lOrder, lLastLevel );
+
+    for( ;; )
+    {
+        Graph::vertexId_t lCandidate = *std::min_element( lOrder.begin() + lLastLevel, lOrder.end(), lLesserDegree );
+
+        lOrder.clear();
+        size_t lCandidateLevels = levelWalk( rGraph, lCandidate, rMarks, rNextMark++, false, lOrder, lLastLevel );
+        if( lCandidateLevels <= lNumLevels )
+        {
+            break;
+        }
+
+        lRoot = lCandidate;
+        lNumLevels = lCandidateLevels;
+    }
+
+    return lRoot;
+}
+
+bool parseVertexOrder( const char* pName, VertexOrder_t& rOrder )
+{
+    static const VertexOrder_t sOrders[] = { VERTEX_ORDER_NONE, VERTEX_ORDER_RCM, VERTEX_ORDER_DEGREE, VERTEX_ORDER_BFS };
+
+    for( size_t lIdx = 0; lIdx < sizeof( sOrders ) / sizeof( sOrders[0] ); ++lIdx )
+    {
+        if( 0 == strcmp( pName, getVertexOrderName( sOrders[lIdx] ) ) )
+        {
+            rOrder = sOrders[lIdx];
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* getVertexOrderName( VertexOrder_t pOrder )
+{
+    switch( pOrder )
+    {
+    case VERTEX_ORDER_RCM:
+        return "rcm";
+    case VERTEX_ORDER_DEGREE:
+        return "degree";
+    case VERTEX_ORDER_BFS:
+        return "bfs";
+    default:
+        return "none";
+    }
+}
+
+bool computeVertexOrder( const Graph& rGraph, VertexOrder_t pOrder, Graph::idVec_t& rNewToOld )
+{
+    size_t lNumVertices = rGraph.size();
+
+    rNewToOld.clear();
+    rNewToOld.reserve( lNumVertices );
+    for( size_t lId = 0; lId < lNumVertices; ++lId )
+    {
+        rNewToOld.push_back( ( Graph::vertexId_t )lId );
+    }
+
+    if( VERTEX_ORDER_NONE == pOrder )
+    {
+        return true;
+    }
+
+    if( VERTEX_ORDER_DEGREE == pOrder )
+    {
+        std::stable_sort( rNewToOld.begin(), rNewToOld.end(), GreaterDegree( rGraph ) );
+        return true;
+    }
+
+    // RCM starts every component from its lowest degree vertex, BFS from
+    // its lowest id
+    bool lIsRcm = ( VERTEX_ORDER_RCM == pOrder );
+    Graph::idVec_t lStarts;
+    lStarts.swap( rNewToOld );
+    if( lIsRcm )
+    {
+        std::sort( lStarts.begin(), lStarts.end(), LesserDegreeId( rGraph ) );
+    }
+
+    // mark 1 is the final walk, the root searches take 2, 3, ...
+    const size_t PLACED_MARK = 1;
+    std::vector<size_t> lPlaced( lNumVertices, 0 );
+    std::vector<size_t> lSearchMarks( lIsRcm ? lNumVertices : 0, 0 );
+    size_t lNextMark = 2;
+    size_t lLastLevel = 0;
+
+    for( size_t lIdx = 0; lIdx < lNumVertices; ++lIdx )
+    {
+        Graph::vertexId_t lStart = lStarts[lIdx];
+        if( PLACED_MARK == lPlaced[lStart] )
+        {
+            continue;
+        }
+
+        if( lIsRcm )
+        {
+            lStart = findPseudoPeripheral( rGraph, lStart, lSearchMarks, lNextMark );
+        }
+        levelWalk( rGraph, lStart, lPlaced, PLACED_MARK, lIsRcm, rNewToOld, lLastLevel );
+    }
+
+    if( lIsRcm )
+    {
+        std::reverse( rNewToOld.begin(), rNewToOld.end() );
+    }
+
+    return true;
+}
+
+bool permuteGraph( const Graph& rGraph, const Graph::idVec_t& rNewToOld, Graph& rOrdered )
+{
+    size_t lNumVertices = rGraph.size();
+    if( !rOrdered.empty() || rNewToOld.size() != lNumVertices )
+    {
+        return false;
+    }
+
+    // rNewToOld must be a permutation
+    Graph::idVec_t lOldToNew;
+    invertVertexOrder( rNewToOld, lOldToNew );
+    for( size_t lNew = 0; lNew < lNumVertices; ++lNew )
+    {
+        if( rNewToOld[lNew] >= lNumVertices || lOldToNew[rNewToOld[lNew]] != lNew )
+        {
+            return false;
+        }
+    }
+
+    std::string lName;
+    for( size_t lNew = 0; lNew < lNumVertices; ++lNew )
+    {
+        Graph::vertexId_t lId = 0;
+        rGraph.getName( rNewToOld[lNew], lName );
+        rOrdered.addVertex( lName, lId );
+    }
+
+    Graph::idPairStore_t lEdges;
+    for( size_t lOld = 0; lOld < lNumVertices; ++lOld )
+    {
+        Graph::NeighborRange lNeighbors = rGraph.getNeighbors( ( Graph::vertexId_t )lOld );
+        for( Graph::NeighborRange::const_iterator lIter = lNeighbors.begin();
+             lIter != lNeighbors.end();
+             ++lIter )
+        {
+            if( *lIter > lOld )
+            {
+                lEdges.push_back( Graph::idPair_t( lOldToNew[lOld], lOldToNew[*lIter] ) );
+            }
+        }
+    }
+
+    return lEdges.empty() || rOrdered.addEdges( &lEdges[0], lEdges.size() );
+}
+
+void invertVertexOrder( const Graph::idVec_t& rNewToOld, Graph::idVec_t& rOldToNew )
+{
+    rOldToNew.assign( rNewToOld.size(), 0 );
+    for( size_t lNew = 0; lNew < rNewToOld.size(); ++lNew )
+    {
+        if( rNewToOld[lNew] < rOldToNew.size() )
+        {
+            rOldToNew[rNewToOld[lNew]] = ( Graph::vertexId_t )lNew;
+        }
+    }
+}
+
+void mapColorsToOriginal( const std::vector<int>& rColors,
+                          const Graph::idVec_t& rNewToOld,
+                          std::vector<int>& rOriginalColors )
+{
+    rOriginalColors.assign( rColors.size(), -1 );
+    for( size_t lNew = 0; lNew < rColors.size() && lNew < rNewToOld.size(); ++lNew )
+    {
+        rOriginalColors[rNewToOld[lNew]] = rColors[lNew];
+    }
+}
+
+void measureBandwidth( const Graph& rGraph, BandwidthStats& rStats )
+{
+    rStats.mBandwidth = 0;
+    rStats.mProfile = 0;
+
+    for( size_t lId = 0; lId < rGraph.size(); ++lId )
+    {
+        Graph::NeighborRange lNeighbors = rGraph.getNeighbors( ( Graph::vertexId_t )lId );
+        if( lNeighbors.empty() )
+        {
+            continue;
+        }
+
+        // the neighbors are in ascending order, the extremes are the ends
+        size_t lLowest = *lNeighbors.begin();
+        size_t lHighest = *( --lNeighbors.end() );
+
+        if( lLowest < lId )
+        {
+            rStats.mProfile += lId - lLowest;
+            rStats.mBandwidth = std::max( rStats.mBandwidth, lId - lLowest );
+        }
+        if( lHighest > lId )
+        {
+            rStats.mBandwidth = std::max( rStats.mBandwidth, lHighest - lId );
+        }
+    }
+}
+
+// end of file
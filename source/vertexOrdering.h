@@ -0,0 +1,48 @@
+#ifndef _VERTEX_ORDERING_H_
+#define _VERTEX_ORDERING_H_
+
+#include <vector>
+#include <stdint.h>
+
+#include "graph.h"
+
+// Renumbering passes that bring neighbor ids close together, so the rows of
+// the adjacency bit matrix and the CSR arrays are walked with better
+// locality on the host and on the device. Orders are given as new to old
+// maps: rNewToOld[n] is the input id of the vertex that gets id n.
+enum VertexOrder_t
+{
+    VERTEX_ORDER_NONE,
+    VERTEX_ORDER_RCM,       // reverse Cuthill-McKee
+    VERTEX_ORDER_DEGREE,    // descending degree
+    VERTEX_ORDER_BFS        // breadth first from the lowest id of each component
+};
+
+// Bandwidth: largest | u - v | over the edges. Profile: sum over the
+// vertices of the distance to their lowest numbered neighbor below them.
+struct BandwidthStats
+{
+    size_t mBandwidth;
+    uint64_t mProfile;
+};
+
+bool parseVertexOrder( const char* pName, VertexOrder_t& rOrder );
+
+const char* getVertexOrderName( VertexOrder_t pOrder );
+
+bool computeVertexOrder( const Graph& rGraph, VertexOrder_t pOrder, Graph::idVec_t& rNewToOld );
+
+// Builds rOrdered, which must be empty, as rGraph renumbered by rNewToOld.
+// Vertices keep their names, so anything printed by name needs no mapping.
+bool permuteGraph( const Graph& rGraph, const Graph::idVec_t& rNewToOld, Graph& rOrdered );
+
+void invertVertexOrder( const Graph::idVec_t& rNewToOld, Graph::idVec_t& rOldToNew );
+
+// rColors is indexed by the new ids, rOriginalColors by the input ids
+void mapColorsToOriginal( const std::vector<int>& rColors,
+                          const Graph::idVec_t& rNewToOld,
+                          std::vector<int>& rOriginalColors );
+
+void measureBandwidth( const Graph& rGraph, BandwidthStats& rStats );
+
+#endif